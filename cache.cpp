@@ -2,67 +2,150 @@
 #include <algorithm>
 #include <iomanip>
 #include <sstream>
+#include <cctype>
 
-std::optional<uint32_t> Cache2Way::findHit(uint32_t set_idx, uint64_t tg) const {
-  const auto& S = sets_[set_idx];
-  for (uint32_t w = 0; w < WAYS; ++w) {
-    const auto& L = S.ways[w];
-    if (L.valid && L.tag == tg) return w;
-  }
-  return std::nullopt;
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+std::optional<uint32_t> Cache<Sets, Ways, LineBytes, Repl>::findHit(uint32_t set_idx, uint64_t tg) const {
+  const uint32_t m = matchWays(set_idx, tg);
+  if (!m) return std::nullopt;
+  return static_cast<uint32_t>(__builtin_ctz(m));
 }
 
-uint32_t Cache2Way::chooseVictim(uint32_t set_idx) const {
-  const auto& S = sets_[set_idx];
-  for (uint32_t w = 0; w < WAYS; ++w) if (!S.ways[w].valid) return w;
-  uint32_t victim = 0;
-  uint64_t best   = S.ways[0].last_use;
-  for (uint32_t w = 1; w < WAYS; ++w) {
-    if (S.ways[w].last_use < best) { best = S.ways[w].last_use; victim = w; }
-  }
-  return victim;
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+uint32_t Cache<Sets, Ways, LineBytes, Repl>::chooseVictim(uint32_t set_idx) {
+  constexpr uint32_t ALL = WAYS == 32 ? ~0u : (1u << WAYS) - 1;
+  const uint32_t free_ways = ~valid_[set_idx] & ALL;
+  if (free_ways) return static_cast<uint32_t>(__builtin_ctz(free_ways));
+  return repl_.victim(set_idx);
 }
 
-void Cache2Way::writeBackIfDirty(uint32_t set_idx, uint32_t way_idx, uint64_t base_addr) {
-  auto& L = sets_[set_idx].ways[way_idx];
-  if (L.valid && L.dirty) {
-    for (uint32_t i = 0; i < WORDS_PER_LINE; ++i) {
-      uint64_t w = readWordInLine(L, i);
-      mem_.write64(base_addr + i * WORD_SIZE, w);
-      stats_.mem_writes++;
-    }
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+void Cache<Sets, Ways, LineBytes, Repl>::writeBackIfDirty(uint32_t set_idx, uint32_t way_idx, uint64_t base_addr) {
+  const uint32_t ln = slot(set_idx, way_idx);
+  if (isValid(ln) && isDirty(ln)) {
+    writeLineToMemory(base_addr, lineData(ln));
     stats_.writebacks++;
-    L.dirty = false;
+    now_ += timing_.mem_write_cycles;
+    setDirty(ln, false);
   }
 }
 
-void Cache2Way::fetchLine(uint32_t set_idx, uint32_t way_idx, uint64_t base_addr, uint64_t tg) {
-  auto& L = sets_[set_idx].ways[way_idx];
-  if (L.valid && L.dirty) {
-    uint64_t old_base = ( (L.tag << (INDEX_BITS + OFFSET_BITS)) | (static_cast<uint64_t>(set_idx) << OFFSET_BITS) );
-    writeBackIfDirty(set_idx, way_idx, old_base);
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+void Cache<Sets, Ways, LineBytes, Repl>::evictSlot(uint32_t set_idx, uint32_t way_idx) {
+  const uint32_t ln = slot(set_idx, way_idx);
+  if (!isValid(ln)) return;
+  stats_.evictions++;
+  dropPrefetchedBit(ln);
+  if (victim_.empty()) {
+    if (isDirty(ln)) writeBackIfDirty(set_idx, way_idx, baseOf(tags_[ln], set_idx));
+    else mem_.evictClean(baseOf(tags_[ln], set_idx), lineData(ln), LINE_SIZE_BYTES);
+    return;
   }
-  for (uint32_t i = 0; i < WORDS_PER_LINE; ++i) {
-    uint64_t v = 0;
-    mem_.read64(base_addr + i * WORD_SIZE, v);
-    stats_.mem_reads++;
-    writeWordInLine(L, i, v);
+
+  // Con victim buffer la línea desalojada pasa al buffer con su estado;
+  // solo la que sale del buffer se escribe en memoria.
+  const int v = victim_.victim();
+  auto& e = victim_.entry(v);
+  if (e.valid) {
+    if (e.dirty) {
+      writeLineToMemory(e.base, victim_.data(v));
+      stats_.writebacks++;
+      now_ += timing_.mem_write_cycles;
+    } else {
+      mem_.evictClean(e.base, victim_.data(v), LINE_SIZE_BYTES);
+    }
+    stats_.victim_evictions++;
   }
-  L.tag     = tg;
-  L.valid   = true;
-  L.dirty   = false;
-  L.last_use = ++use_tick_;
+  victim_.fill(v, baseOf(tags_[ln], set_idx), mesi_[ln], isDirty(ln), lineData(ln));
+  setValid(ln, false);
+  setDirty(ln, false);
+  mesi_[ln] = MESI::I;
+}
+
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+void Cache<Sets, Ways, LineBytes, Repl>::installLine(uint32_t set_idx, uint32_t way_idx, uint64_t tg) {
+  const uint32_t ln = slot(set_idx, way_idx);
+  tags_[ln] = tg;
+  setValid(ln, true);
+  setDirty(ln, false);
+  updated_[set_idx] &= ~bit(way_idx);
+  migrated_[set_idx] &= ~bit(way_idx);
+  repl_.insert(set_idx, way_idx);
+}
+
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+void Cache<Sets, Ways, LineBytes, Repl>::readLineFromMemory(uint64_t base_addr, uint8_t* dst) {
+  mem_.readLine(base_addr, dst, LINE_SIZE_BYTES);
+  stats_.mem_reads += WORDS_PER_LINE;
+}
+
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+void Cache<Sets, Ways, LineBytes, Repl>::writeLineToMemory(uint64_t base_addr, const uint8_t* src) {
+  mem_.writeLine(base_addr, src, LINE_SIZE_BYTES);
+  stats_.mem_writes += WORDS_PER_LINE;
+}
+
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+bool Cache<Sets, Ways, LineBytes, Repl>::swapFromVictimBuffer(uint32_t set_idx, uint64_t tg, uint64_t base) {
+  const int b = victim_.find(base);
+  if (b < 0) return false;
+
+  // Se copia antes de desalojar: la víctima del set puede ocupar la misma entrada
+  std::array<uint8_t, LINE_SIZE_BYTES> line;
+  std::memcpy(line.data(), victim_.data(b), LINE_SIZE_BYTES);
+  const MESI st = victim_.entry(b).state;
+  const bool dirty = victim_.entry(b).dirty;
+  victim_.remove(b);
+
+  const uint32_t way = chooseVictim(set_idx);
+  evictSlot(set_idx, way);
+  const uint32_t ln = slot(set_idx, way);
+  std::memcpy(lineData(ln), line.data(), LINE_SIZE_BYTES);
+  installLine(set_idx, way, tg);
+  setDirty(ln, dirty);
+  mesi_[ln] = st;
+  stats_.victim_hits++;
+  now_ += timing_.fill_cycles;
+
+  report(Event{ Event::Kind::VictimHit, id_, base, BusMsg::BusRd, MESI::I, st });
+  return true;
+}
+
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+void Cache<Sets, Ways, LineBytes, Repl>::fetchLine(uint32_t set_idx, uint32_t way_idx, uint64_t base_addr, uint64_t tg) {
+  evictSlot(set_idx, way_idx);
+  readLineFromMemory(base_addr, lineData(slot(set_idx, way_idx)));
+  installLine(set_idx, way_idx, tg);
+  stats_.line_fills++;
+  stats_.mem_fills++;
+}
+
+// Llenado tras una transacción con la línea en r.data: la entregó otra
+// caché o la leyó readUnsupplied() del nivel inferior.
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+void Cache<Sets, Ways, LineBytes, Repl>::fillLine(uint32_t set_idx, uint32_t way_idx, uint64_t tg,
+                                                 const SnoopReply& r) {
+  evictSlot(set_idx, way_idx);
+  std::memcpy(lineData(slot(set_idx, way_idx)), r.data, LINE_SIZE_BYTES);
+  installLine(set_idx, way_idx, tg);
   stats_.line_fills++;
+  if (!r.supplied) {
+    stats_.mem_reads += WORDS_PER_LINE;
+    stats_.mem_fills++;
+    return;
+  }
+  stats_.c2c_fills++;
+  if (protocol_ == CoherenceProtocol::MESIF) stats_.forwarded_fills++;
 }
 
-std::pair<uint32_t,bool> Cache2Way::ensureLine(uint64_t addr) {
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+std::pair<uint32_t,bool> Cache<Sets, Ways, LineBytes, Repl>::ensureLine(uint64_t addr) {
   const uint32_t set_idx  = index(addr);
   const uint64_t tg       = tag(addr);
   const uint64_t base     = lineBase(addr);
 
   if (auto h = findHit(set_idx, tg)) {
-    auto& L = sets_[set_idx].ways[*h];
-    L.last_use = ++use_tick_;
+    repl_.touch(set_idx, *h);
     return { *h, true };
   }
   uint32_t victim = chooseVictim(set_idx);
@@ -70,116 +153,146 @@ std::pair<uint32_t,bool> Cache2Way::ensureLine(uint64_t addr) {
   return { victim, false };
 }
 
-int Cache2Way::findLineByBase(uint64_t base_addr) const {
-  const uint32_t set_idx = index(base_addr);
-  const uint64_t tg      = tag(base_addr);
-  const auto& S = sets_[set_idx];
-  for (uint32_t w = 0; w < WAYS; ++w) {
-    const auto& L = S.ways[w];
-    if (L.valid && L.tag == tg) return (int)w;
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+int Cache<Sets, Ways, LineBytes, Repl>::findLineByBase(uint64_t base_addr) const {
+  const uint32_t m = matchWays(index(base_addr), tag(base_addr));
+  return m ? __builtin_ctz(m) : -1;
+}
+
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+std::pair<DataAction, bool> Cache<Sets, Ways, LineBytes, Repl>::snoopLine(MESI& st, bool& dirty, uint8_t* line,
+                                                                         BusMsg msg, uint64_t base_addr,
+                                                                         SnoopReply& reply) {
+  const Transition& t = transition(st, snoopEvent(msg));
+  const MESI from = st;
+  MESI next = t.next;
+
+  // Respuesta agregada: con BusRd y BusUpd la copia sigue válida aquí
+  if (msg != BusMsg::Flush && (from == MESI::M || from == MESI::O)) reply.dirty = true;
+  if (msg == BusMsg::BusRd || msg == BusMsg::BusUpd) reply.shared = true;
+
+  bool supplied = false;
+  bool flush = false;
+  switch (t.data) {
+    case DataAction::Supply:
+      supplied = supplyLine(line, reply);
+      break;
+    case DataAction::SupplyKeep:
+      // Sin dueña que conserve el dato sucio, memoria debe quedar al día
+      supplied = supplyLine(line, reply);
+      if (!supplied || c2c_updates_memory_) { flush = true; next = MESI::S; }
+      break;
+    case DataAction::SupplyFlush:
+      supplied = supplyLine(line, reply);
+      flush = true;
+      break;
+    case DataAction::HandOver: {
+      // La propiedad (y el dato sucio) pasa al solicitante solo si recibe
+      // la línea. Un BusUpgr no lleva buffer y la copia del solicitante pudo
+      // invalidarse en una carrera (aun frente a una O, si otra caché
+      // escribió y una tercera leyó), así que la dueña hace flush.
+      const bool handed_over = reply.data && (supplied = supplyLine(line, reply));
+      flush = !handed_over || c2c_updates_memory_;
+      break;
+    }
+    case DataAction::Update:
+      if (reply.data && reply.bytes == WORD_SIZE && reply.offset + WORD_SIZE <= LINE_SIZE_BYTES) {
+        std::memcpy(line + reply.offset, reply.data, WORD_SIZE);
+        stats_.upd_received++;
+      }
+      break;
+    default:
+      break;
   }
-  return -1;
+
+  if (flush) {
+    writeLineToMemory(base_addr, line);
+    stats_.writebacks++;
+    stats_.snoop_flush++;
+  }
+  // Solo una dueña (M/O) que no hizo flush conserva el dato sucio
+  dirty = dirty && !flush && (next == MESI::M || next == MESI::O);
+  if (from == MESI::M && next == MESI::O) stats_.snoop_to_O++;
+  if (from == MESI::E && next == MESI::S) stats_.snoop_to_S++;
+  if (supplied && protocol_ == CoherenceProtocol::MESIF) stats_.snoop_forward++;
+  st = next;
+  return { t.data, flush };
 }
 
-void Cache2Way::snoop(BusMsg msg, uint64_t base_addr) {
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+void Cache<Sets, Ways, LineBytes, Repl>::snoop(BusMsg msg, uint64_t base_addr, SnoopReply& reply) {
   std::scoped_lock lk(mtx_);
+  if (!pf_buffer_.empty() && snoopBuffered(pf_buffer_, msg, base_addr, reply)) stats_.prefetch_unused++;
+  if (!victim_.empty() && snoopBuffered(victim_, msg, base_addr, reply)) stats_.snoop_to_I++;
   const uint32_t set_idx = index(base_addr);
   int w = findLineByBase(base_addr);
   if (w < 0) return;
+  reply.hit = true;
+
+  const uint32_t ln = slot(set_idx, w);
+  const MESI from = mesi_[ln];
+  bool dirty = isDirty(ln);
+  if (migrated_[set_idx] & bit(w)) reply.grant_unused = true;
+  const auto [action, flushed] = snoopLine(mesi_[ln], dirty, lineData(ln), msg, base_addr, reply);
+  setDirty(ln, dirty);
+  if (action == DataAction::Update) updated_[set_idx] |= bit(w);
+  if (mesi_[ln] != from) migrated_[set_idx] &= ~bit(w);
+  if (mesi_[ln] != from || action != DataAction::None) {
+    report(Event{ Event::Kind::Snoop, id_, base_addr, msg, from, mesi_[ln], flushed });
+  }
+  if (mesi_[ln] == MESI::I && from != MESI::I) {
+    setValid(ln, false);
+    dropPrefetchedBit(ln);
+    stats_.snoop_to_I++;
+  }
+}
 
-  auto& L = sets_[set_idx].ways[w];
-
-  auto do_flush = [&](){
-    for (uint32_t i=0;i<WORDS_PER_LINE;++i) {
-      uint64_t v = readWordInLine(L, i);
-      mem_.write64(base_addr + i*WORD_SIZE, v);
-      stats_.mem_writes++;
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+void Cache<Sets, Ways, LineBytes, Repl>::invalidateFromBelow(uint64_t base) {
+  const uint32_t set_idx = index(base);
+  if (const int w = findLineByBase(base); w >= 0) {
+    const uint32_t ln = slot(set_idx, w);
+    if (isDirty(ln)) writeBackIfDirty(set_idx, w, base);
+    dropPrefetchedBit(ln);
+    setValid(ln, false);
+    mesi_[ln] = MESI::I;
+    stats_.back_invalidations++;
+
+    report(Event{ Event::Kind::BackInvalidation, id_, base });
+  }
+  if (const int b = victim_.empty() ? -1 : victim_.find(base); b >= 0) {
+    if (victim_.entry(b).dirty) {
+      writeLineToMemory(base, victim_.data(b));
+      stats_.writebacks++;
     }
-    stats_.writebacks++;
-    stats_.snoop_flush++;
-  };
-
-  switch (msg) {
-    case BusMsg::BusRd:
-      if (L.mesi == MESI::M) { 
-        do_flush(); 
-        L.dirty=false; 
-        L.mesi = MESI::S;  // De M a S
-        std::ostringstream oss;
-        oss << "[C" << id_ << "] Snoop BusRd: M->S (flush) addr=0x" << std::hex << base_addr << std::dec;
-        logMESI(oss.str());
-      }
-      else if (L.mesi == MESI::E) { 
-        L.mesi = MESI::S; // De E a S
-        stats_.snoop_to_S++;
-        std::ostringstream oss;
-        oss << "[C" << id_ << "] Snoop BusRd: E->S addr=0x" << std::hex << base_addr << std::dec;
-        logMESI(oss.str());
-      }
-      break;
-
-    case BusMsg::BusRdX:
-      if (L.mesi == MESI::M) { 
-        do_flush(); 
-        L.dirty=false;
-        std::ostringstream oss;
-        oss << "[C" << id_ << "] Snoop BusRdX: M->I (flush) addr=0x" << std::hex << base_addr << std::dec;
-        logMESI(oss.str());
-      }
-      else if (L.mesi == MESI::E) {
-        std::ostringstream oss;
-        oss << "[C" << id_ << "] Snoop BusRdX: E->I addr=0x" << std::hex << base_addr << std::dec;
-        logMESI(oss.str());
-      }
-      else if (L.mesi == MESI::S) {
-        std::ostringstream oss;
-        oss << "[C" << id_ << "] Snoop BusRdX: S->I addr=0x" << std::hex << base_addr << std::dec;
-        logMESI(oss.str());
-      }
-      if (L.mesi != MESI::I) {
-        L.mesi = MESI::I; 
-        L.valid = false; 
-        stats_.snoop_to_I++;
-      }
-      break;
-
-    case BusMsg::Invalidate:
-      if (L.mesi == MESI::M) { 
-        do_flush(); 
-        L.dirty=false;
-        std::ostringstream oss;
-        oss << "[C" << id_ << "] Snoop Invalidate: M->I (flush) addr=0x" << std::hex << base_addr << std::dec;
-        logMESI(oss.str());
-      }
-      else if (L.mesi == MESI::E) {
-        std::ostringstream oss;
-        oss << "[C" << id_ << "] Snoop Invalidate: E->I addr=0x" << std::hex << base_addr << std::dec;
-        logMESI(oss.str());
-      }
-      else if (L.mesi == MESI::S) {
-        std::ostringstream oss;
-        oss << "[C" << id_ << "] Snoop Invalidate: S->I addr=0x" << std::hex << base_addr << std::dec;
-        logMESI(oss.str());
-      }
-      if (L.mesi != MESI::I) {
-        L.mesi = MESI::I; 
-        L.valid = false; 
-        stats_.snoop_to_I++;
-      }
-      break;
+    victim_.remove(b);
+    stats_.back_invalidations++;
+  }
+  if (const int b = pf_buffer_.empty() ? -1 : pf_buffer_.find(base); b >= 0) {
+    pf_buffer_.remove(b);
+    stats_.prefetch_unused++;
+  }
+}
 
-    case BusMsg::Flush:
-      break;
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+void Cache<Sets, Ways, LineBytes, Repl>::backInvalidate(uint64_t base_addr, uint32_t bytes) {
+  std::scoped_lock lk(mtx_);
+  const uint64_t last = lineBase(base_addr + (bytes ? bytes - 1 : 0));
+  for (uint64_t base = lineBase(base_addr); base <= last; base += LINE_SIZE_BYTES) {
+    if (base == filling_) fill_revoked_ = true;
+    invalidateFromBelow(base);
   }
 }
 
-bool Cache2Way::load64(uint64_t addr, uint64_t& out) {
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+bool Cache<Sets, Ways, LineBytes, Repl>::loadDemand(uint64_t addr, uint64_t& out) {
   if (addr % WORD_SIZE != 0)
     throw std::invalid_argument("Cache64 load: dirección no alineada a 8 bytes");
 
   uint32_t set_idx, woff, victim;
   uint64_t base, tg;
   bool is_miss = false;
+  Transition t;
   
   {
     std::scoped_lock lk(mtx_);
@@ -187,53 +300,90 @@ bool Cache2Way::load64(uint64_t addr, uint64_t& out) {
     woff = wordOffset(addr);
     base = lineBase(addr);
     tg = tag(addr);
+    beginAccess();
+    if (!victim_.empty() && !matchWays(set_idx, tg)) swapFromVictimBuffer(set_idx, tg, base);
 
     if (auto h = findHit(set_idx, tg)) {
-      auto& L = sets_[set_idx].ways[*h];
-      L.last_use = ++use_tick_;
-      out = readWordInLine(L, woff);
+      const uint32_t ln = slot(set_idx, *h);
+      repl_.touch(set_idx, *h);
+      noteUpdateUse(set_idx, *h);
+      mesi_[ln] = transition(mesi_[ln], CoherenceEvent::Load).next;
+      out = readWordInLine(ln, woff);
+      const bool merged = mergePending(base);
+      trainPrefetcher(addr, base, merged, notePrefetchUse(set_idx, *h, merged));
+      if (merged) {
+        report(Event{ Event::Kind::LoadMissMerged, id_, addr });
+        return false;
+      }
       stats_.hits++;
       
-      std::ostringstream oss;
-      oss << "[C" << id_ << "] LOAD HIT addr=0x" << std::hex << addr 
-          << " estado=" << mesiName(L.mesi) << std::dec;
-      logMESI(oss.str());
+      report(Event{ Event::Kind::LoadHit, id_, addr, BusMsg::BusRd, mesi_[ln], mesi_[ln] });
       return true;
     }
     
-    is_miss = true;
     victim = chooseVictim(set_idx);
+
+    // Hit en los stream buffers: la línea entra a la caché sin ir al bus
+    if (const int b = pf_buffer_.empty() ? -1 : pf_buffer_.find(base); b >= 0) {
+      const auto e = pf_buffer_.entry(b);
+      evictSlot(set_idx, victim);
+      const uint32_t ln = slot(set_idx, victim);
+      std::memcpy(lineData(ln), pf_buffer_.data(b), LINE_SIZE_BYTES);
+      installLine(set_idx, victim, tg);
+      stats_.line_fills++;
+      now_ += timing_.fill_cycles;
+      pf_buffer_.remove(b);
+      mesi_[ln] = e.state;
+      out = readWordInLine(ln, woff);
+      stats_.hits++;
+      stats_.prefetch_useful++;
+      trainPrefetcher(addr, base, false, true);
+
+      report(Event{ Event::Kind::StreamBufferHit, id_, addr, BusMsg::BusRd, e.state, e.state });
+      return true;
+    }
+
+    is_miss = true;
+    beginFill(base);
+    t = transition(MESI::I, CoherenceEvent::Load);
+    allocateMSHR(base);
+    trainPrefetcher(addr, base, true, false);
   }
 
+  SnoopReply reply;
   if (is_miss) {
-    emit(BusMsg::BusRd, base);
+    reply = emit(t.bus, base, true, true);
+    readUnsupplied(base, reply);
   }
 
   {
     std::scoped_lock lk(mtx_);
-    fetchLine(set_idx, victim, base, tg);
-    auto& L = sets_[set_idx].ways[victim];
-    L.mesi = MESI::E;
-    out = readWordInLine(L, woff);
+    fillLine(set_idx, victim, tg, reply);
+    chargeFill(reply.supplied);
+    const uint32_t ln = slot(set_idx, victim);
+    mesi_[ln] = fillState(ln, t, reply);
+    out = readWordInLine(ln, woff);
     stats_.misses++;
+    endTransaction(base);
     
-    std::ostringstream oss;
-    oss << "[C" << id_ << "] LOAD MISS -> E addr=0x" << std::hex << base << std::dec;
-    logMESI(oss.str());
+    report(Event{ Event::Kind::LoadMiss, id_, base, t.bus, MESI::I, mesi_[ln] });
+    endFill();
   }
 
   return false;
 }
 
-bool Cache2Way::store64(uint64_t addr, uint64_t value) {
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+bool Cache<Sets, Ways, LineBytes, Repl>::storeDemand(uint64_t addr, uint64_t value) {
   if (addr % WORD_SIZE != 0)
     throw std::invalid_argument("Cache64 store: dirección no alineada a 8 bytes");
 
-  uint32_t set_idx, woff, victim;
+  uint32_t set_idx, woff, victim = 0;
   uint64_t base, tg;
   bool is_hit = false;
-  bool need_upgrade = false;
-  bool need_fetch = false;
+  bool counted_miss = true;   // el miss ya se contó (o el acceso empezó como hit)
+  MESI st = MESI::I;
+  Transition t;
 
   {
     std::scoped_lock lk(mtx_);
@@ -241,110 +391,262 @@ bool Cache2Way::store64(uint64_t addr, uint64_t value) {
     woff = wordOffset(addr);
     base = lineBase(addr);
     tg = tag(addr);
+    beginAccess();
+    if (!victim_.empty() && !matchWays(set_idx, tg)) swapFromVictimBuffer(set_idx, tg, base);
 
     if (auto h = findHit(set_idx, tg)) {
-      auto& L = sets_[set_idx].ways[*h];
-      
-      if (L.mesi == MESI::S) {
-        std::ostringstream oss;
-        oss << "[C" << id_ << "] STORE en S -> need upgrade to M addr=0x" << std::hex << addr << std::dec;
-        logMESI(oss.str());
-        need_upgrade = true;
-      } else if (L.mesi == MESI::E) {
-        L.mesi = MESI::M;
-        std::ostringstream oss;
-        oss << "[C" << id_ << "] STORE E->M addr=0x" << std::hex << addr << std::dec;
-        logMESI(oss.str());
-      } else if (L.mesi == MESI::M) {
-        std::ostringstream oss;
-        oss << "[C" << id_ << "] STORE en M (ya modificado) addr=0x" << std::hex << addr << std::dec;
-        logMESI(oss.str());
+      const uint32_t ln = slot(set_idx, *h);
+      const bool merged = mergePending(base);
+      trainPrefetcher(addr, base, merged, notePrefetchUse(set_idx, *h, merged));
+      noteUpdateUse(set_idx, *h);
+      st = mesi_[ln];
+      t = transition(st, CoherenceEvent::Store);
+
+      // Con transacción pendiente el dato se escribe cuando termina
+      if (t.issues) {
+        report(Event{ Event::Kind::StoreHit, id_, addr, t.bus, st, st });
+      } else {
+        report(Event{ Event::Kind::StoreHit, id_, addr, BusMsg::BusRd, st, t.next });
+        noteMigratoryUse(ln);
+        mesi_[ln] = t.next;
+        writeWordInLine(ln, woff, value);
+        setDirty(ln, true);
       }
-      
-      writeWordInLine(L, woff, value);
-      L.dirty = true;
-      L.last_use = ++use_tick_;
-      stats_.hits++;
-      is_hit = true;
+      repl_.touch(set_idx, *h);
+      if (!merged) stats_.hits++;
+      is_hit = !merged;
+      if (!t.issues) return is_hit;
     } else {
-      need_fetch = true;
       victim = chooseVictim(set_idx);
+
+      // Solo una copia del stream buffer que la tabla deja escribir sin
+      // transacción (E) se usa; si no, se descarta y el store sigue como miss.
+      if (const int b = pf_buffer_.empty() ? -1 : pf_buffer_.find(base); b >= 0) {
+        const MESI from = pf_buffer_.entry(b).state;
+        const Transition& pt = transition(from, CoherenceEvent::Store);
+        if (!pt.issues) {
+          evictSlot(set_idx, victim);
+          const uint32_t ln = slot(set_idx, victim);
+          std::memcpy(lineData(ln), pf_buffer_.data(b), LINE_SIZE_BYTES);
+          installLine(set_idx, victim, tg);
+          stats_.line_fills++;
+          now_ += timing_.fill_cycles;
+          pf_buffer_.remove(b);
+          writeWordInLine(ln, woff, value);
+          setDirty(ln, true);
+          mesi_[ln] = pt.next;
+          stats_.hits++;
+          stats_.prefetch_useful++;
+          trainPrefetcher(addr, base, false, true);
+
+          report(Event{ Event::Kind::StreamBufferHit, id_, addr, BusMsg::BusRdX, from, pt.next, true });
+          return true;
+        }
+        pf_buffer_.remove(b);
+        stats_.prefetch_unused++;
+      }
+
+      counted_miss = false;
+      beginFill(base);
+      t = transition(MESI::I, CoherenceEvent::Store);
+      allocateMSHR(base);
+      trainPrefetcher(addr, base, true, false);
     }
   }
 
-  if (need_upgrade) {
-    emit(BusMsg::BusRdX, base);
-    
+  // Una transacción por vuelta hasta llegar a una entrada que escribe: un
+  // upgrade o update, el BusRdX de un miss, o en Dragon/Firefly el BusRd
+  // del miss seguido del hit (o BusUpd) sobre el estado obtenido.
+  for (;;) {
+    const SnoopReply reply = issue(t.bus, addr, value);
+    if (st == MESI::I) readUnsupplied(base, reply);
+
     std::scoped_lock lk(mtx_);
-    if (auto h = findHit(set_idx, tg)) {
-      sets_[set_idx].ways[*h].mesi = MESI::M;
-      std::ostringstream oss;
-      oss << "[C" << id_ << "] STORE upgrade: S->M addr=0x" << std::hex << base << std::dec;
-      logMESI(oss.str());
+    uint32_t ln;
+    if (st == MESI::I) {
+      fillLine(set_idx, victim, tg, reply);
+      chargeFill(reply.supplied);
+      ln = slot(set_idx, victim);
+      if (!counted_miss) { stats_.misses++; counted_miss = true; }
+    } else if (auto h = findHit(set_idx, tg)) {
+      ln = slot(set_idx, *h);
+    } else {
+      // Otra caché invalidó la línea mientras la transacción esperaba el
+      // bus: ya no hay copia que promover y el store se repite como miss.
+      stats_.upgrade_races++;
+      beginFill(base);
+      st = MESI::I;
+      t = transition(st, CoherenceEvent::Store);
+      victim = chooseVictim(set_idx);
+      endTransaction(base);
+      continue;
     }
-    return true;
+
+    const MESI from = st;
+    st = from == MESI::I ? fillState(ln, t, reply) : resolve(t, reply);
+    mesi_[ln] = st;
+    if (!t.writes()) {
+      // Solo se trajo la línea: el store sigue según el nuevo estado
+      report(Event{ Event::Kind::StoreMiss, id_, base, t.bus, from, st });
+      t = transition(st, CoherenceEvent::Store);
+      if (t.issues) { endTransaction(base); continue; }
+    }
+    writeWordInLine(ln, woff, value);
+    if (t.data == DataAction::WriteThrough) {
+      // La copia sigue limpia: memoria queda al día
+      mem_.write64(addr, value);
+      stats_.mem_writes++;
+      now_ += timing_.mem_write_cycles;
+    } else {
+      setDirty(ln, true);
+    }
+    if (!t.issues) {
+      report(Event{ Event::Kind::StoreHit, id_, addr, BusMsg::BusRd, st, t.next });
+      noteMigratoryUse(ln);
+      mesi_[ln] = t.next;
+    } else if (from == MESI::I) {
+      report(Event{ Event::Kind::StoreMiss, id_, base, t.bus, MESI::I, st });
+    } else {
+      const Event::Kind k = t.bus == BusMsg::BusUpd ? Event::Kind::StoreUpdate : Event::Kind::StoreUpgrade;
+      report(Event{ k, id_, base, t.bus, from, st });
+    }
+    endTransaction(base);
+    endFill();
+    return is_hit;
   }
-  
-  if (need_fetch) {
-    emit(BusMsg::BusRdX, base);
-    
+}
+
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+void Cache<Sets, Ways, LineBytes, Repl>::setPrefetcher(std::unique_ptr<IPrefetcher> pf) {
+  std::scoped_lock lk(mtx_);
+  prefetcher_ = std::move(pf);
+  pf_pending_ = 0;
+  prefetched_.fill(0);
+  if (prefetcher_) {
+    prefetcher_->attach(LINE_SIZE_BYTES);
+    pf_buffer_.configure(prefetcher_->bufferLines(), LINE_SIZE_BYTES);
+  } else {
+    pf_buffer_.configure(0, LINE_SIZE_BYTES);
+  }
+}
+
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+void Cache<Sets, Ways, LineBytes, Repl>::issuePrefetches() {
+  std::array<uint64_t, IPrefetcher::MAX_CANDIDATES> cand;
+  uint32_t n = 0;
+  {
     std::scoped_lock lk(mtx_);
-    fetchLine(set_idx, victim, base, tg);
-    auto& L = sets_[set_idx].ways[victim];
-    writeWordInLine(L, woff, value);
-    L.dirty = true;
-    L.mesi = MESI::M;
-    L.last_use = ++use_tick_;
-    stats_.misses++;
-    
-    std::ostringstream oss;
-    oss << "[C" << id_ << "] STORE MISS -> M addr=0x" << std::hex << base << std::dec;
-    logMESI(oss.str());
-    return false;
+    n = pf_pending_;
+    pf_pending_ = 0;
+    std::copy_n(pf_queue_.begin(), n, cand.begin());
   }
 
-  return is_hit;
-}
+  const bool to_buffer = !pf_buffer_.empty();
+  for (uint32_t i = 0; i < n; ++i) {
+    const uint64_t base = cand[i];
+    const uint32_t set_idx = index(base);
+    const uint64_t tg = tag(base);
+    uint32_t victim = 0;
+    Transition t;
+    {
+      std::scoped_lock lk(mtx_);
+      t = transition(MESI::I, CoherenceEvent::Load);
+      if (!mem_.contains(base, LINE_SIZE_BYTES) || findHit(set_idx, tg) || (to_buffer && pf_buffer_.find(base) >= 0) ||
+          (!victim_.empty() && victim_.find(base) >= 0) || mshr_.find(base)) {
+        stats_.prefetch_dropped++;
+        continue;
+      }
+      // Un prefetch nunca detiene la caché: sin MSHR libre se descarta
+      if (mshr_.enabled()) {
+        if (mshr_.full()) { stats_.prefetch_dropped++; continue; }
+        mshr_.allocate(base, access_tick_);
+        if (mshr_.outstanding() > stats_.mshr_peak) stats_.mshr_peak = mshr_.outstanding();
+      }
+      if (!to_buffer) victim = chooseVictim(set_idx);
+      beginFill(base);
+    }
+
+    const SnoopReply reply = emit(t.bus, base);
+    const MESI st = resolve(t, reply);
+    readUnsupplied(base, reply);
+
+    std::scoped_lock lk(mtx_);
+    stats_.prefetch_issued++;
+    if (to_buffer) {
+      const int b = pf_buffer_.victim();
+      if (pf_buffer_.entry(b).valid) stats_.prefetch_unused++;
+      std::memcpy(pf_buffer_.data(b), reply.data, LINE_SIZE_BYTES);
+      if (reply.supplied) {
+        stats_.c2c_fills++;
+        if (protocol_ == CoherenceProtocol::MESIF) stats_.forwarded_fills++;
+      } else {
+        stats_.mem_reads += WORDS_PER_LINE;
+        stats_.mem_fills++;
+      }
+      pf_buffer_.fill(b, base, st, false, nullptr);
+    } else {
+      fillLine(set_idx, victim, tg, reply);
+      mesi_[slot(set_idx, victim)] = st;
+      prefetched_[set_idx] |= bit(victim);
+    }
+    endTransaction(base);
 
-bool Cache2Way::loadDouble(uint64_t addr, double& out) {
-  uint64_t bits = 0;
-  bool hit = load64(addr, bits);
-  std::memcpy(&out, &bits, sizeof(bits));
-  return hit;
+    report(Event{ Event::Kind::Prefetch, id_, base, BusMsg::BusRd, MESI::I, st, to_buffer });
+    endFill();
+  }
 }
 
-bool Cache2Way::storeDouble(uint64_t addr, double value) {
-  uint64_t bits = 0;
-  std::memcpy(&bits, &value, sizeof(bits));
-  return store64(addr, bits);
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+bool Cache<Sets, Ways, LineBytes, Repl>::snoopBuffered(LineBuffer<MESI>& buf, BusMsg msg, uint64_t base_addr,
+                                                      SnoopReply& reply) {
+  const int b = buf.find(base_addr);
+  if (b < 0) return false;
+  reply.hit = true;
+  auto& e = buf.entry(b);
+  snoopLine(e.state, e.dirty, buf.data(b), msg, base_addr, reply);
+  if (e.state != MESI::I) return false;
+  buf.remove(b);
+  return true;
 }
 
-void Cache2Way::flushAll() {
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+void Cache<Sets, Ways, LineBytes, Repl>::flushAll() {
   std::scoped_lock lk(mtx_);
   for (uint32_t s = 0; s < SETS; ++s) {
     for (uint32_t w = 0; w < WAYS; ++w) {
-      auto& L = sets_[s].ways[w];
-      if (L.valid && L.dirty) {
-        uint64_t base = ( (L.tag << (INDEX_BITS + OFFSET_BITS)) | (static_cast<uint64_t>(s) << OFFSET_BITS) );
-        writeBackIfDirty(s, w, base);
+      const uint32_t ln = slot(s, w);
+      if (isValid(ln) && isDirty(ln)) {
+        writeBackIfDirty(s, w, baseOf(tags_[ln], s));
+        if (mesi_[ln] == MESI::O) mesi_[ln] = MESI::S;
       }
     }
   }
+  for (uint32_t i = 0; i < victim_.capacity(); ++i) {
+    auto& e = victim_.entry(i);
+    if (e.valid && e.dirty) {
+      writeLineToMemory(e.base, victim_.data(i));
+      stats_.writebacks++;
+      e.dirty = false;
+      if (e.state == MESI::O) e.state = MESI::S;
+    }
+  }
 }
 
-void Cache2Way::dump(std::ostream& os) const {
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+void Cache<Sets, Ways, LineBytes, Repl>::dump(std::ostream& os) const {
   std::scoped_lock lk(mtx_);
-  os << "Cache2Way dump (SETS=" << SETS << ", WAYS=" << WAYS << ")\n";
+  os << "Cache dump (SETS=" << SETS << ", WAYS=" << WAYS << ", LINE=" << LINE_SIZE_BYTES
+     << "B, " << replacementName(replacement()) << ", " << protocolName(protocol_) << ")\n";
   for (uint32_t s = 0; s < SETS; ++s) {
     os << "Set " << s << ":\n";
     for (uint32_t w = 0; w < WAYS; ++w) {
-      const auto& L = sets_[s].ways[w];
+      const uint32_t ln = slot(s, w);
       os << "  Way " << w
-         << " | V=" << L.valid
-         << " D=" << L.dirty
-         << " MESI=" << static_cast<int>(L.mesi)
-         << " Tag=0x" << std::hex << L.tag << std::dec
-         << " LRU=" << L.last_use
+         << " | V=" << isValid(ln)
+         << " D=" << isDirty(ln)
+         << " MESI=" << static_cast<int>(mesi_[ln])
+         << " Tag=0x" << std::hex << tags_[ln] << std::dec
+         << " R=" << repl_.state(s, w)
          << "\n";
     }
   }
@@ -358,52 +660,235 @@ void Cache2Way::dump(std::ostream& os) const {
      << " | busRd=" << st.bus_rd
      << " busRdX=" << st.bus_rdx
      << " busInv=" << st.bus_inv
+     << " busUpgr=" << st.bus_upgr
      << " | snoopI=" << st.snoop_to_I
      << " snoopS=" << st.snoop_to_S
+     << " snoopO=" << st.snoop_to_O
+     << " snoopF=" << st.snoop_forward
+     << " fwdFills=" << st.forwarded_fills
      << " snoopFlush=" << st.snoop_flush
+     << " evict=" << st.evictions
+     << " backInv=" << st.back_invalidations
      << "\n";
+  os << "C2C: fills=" << st.c2c_fills
+     << " memFills=" << st.mem_fills
+     << " supplied=" << st.c2c_supplied
+     << "\n";
+  if (st.migratory_fills) {
+    os << "Migratory: fills=" << st.migratory_fills
+       << " upgradesAvoided=" << st.upgrades_avoided
+       << "\n";
+  }
+  if (isUpdateProtocol(protocol_)) {
+    os << "Update: busUpd=" << st.bus_upd
+       << " recv=" << st.upd_received
+       << " useful=" << st.upd_useful
+       << "\n";
+  }
+  if (mshr_.enabled()) {
+    os << "MSHR(" << mshr_.capacity() << " x " << mshr_.fillLatency() << " ticks): allocs=" << st.mshr_allocs
+       << " merges=" << st.mshr_merges
+       << " fullStalls=" << st.mshr_full_stalls
+       << " stallTicks=" << st.mshr_stall_ticks
+       << " hitUnderMiss=" << st.hits_under_miss
+       << " peak=" << st.mshr_peak
+       << " MLP=" << st.mlp()
+       << "\n";
+  }
+  if (!victim_.empty()) {
+    os << "Victim buffer (" << victim_.capacity() << " líneas): hits=" << st.victim_hits
+       << " evict=" << st.victim_evictions << "\n";
+    for (uint32_t i = 0; i < victim_.capacity(); ++i) {
+      const auto& e = victim_.entry(i);
+      if (!e.valid) continue;
+      os << "  VB " << i << " | base=0x" << std::hex << e.base << std::dec
+         << " D=" << e.dirty << " MESI=" << static_cast<int>(e.state) << "\n";
+    }
+  }
+  if (prefetcher_) {
+    os << "Prefetch(" << prefetcherName(prefetcher_->kind()) << "): issued=" << st.prefetch_issued
+       << " useful=" << st.prefetch_useful
+       << " late=" << st.prefetch_late
+       << " unused=" << st.prefetch_unused
+       << " dropped=" << st.prefetch_dropped
+       << " acc=" << st.prefetchAccuracy()
+       << " cov=" << st.prefetchCoverage()
+       << " timely=" << st.prefetchTimeliness()
+       << "\n";
+  }
 }
 
-void Cache2Way::invalidateAll() {
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+void Cache<Sets, Ways, LineBytes, Repl>::invalidateAll() {
   std::scoped_lock lk(mtx_);
-  for (uint32_t s = 0; s < SETS; ++s) {
-    for (uint32_t w = 0; w < WAYS; ++w) {
-      auto& L = sets_[s].ways[w];
-      L.valid = false;
-      L.dirty = false;
-      L.mesi  = MESI::I;
-      L.tag   = 0;
-      L.last_use = 0;
-    }
-  }
+  valid_.fill(0);
+  dirty_.fill(0);
+  mesi_.fill(MESI::I);
+  tags_.fill(0);
+  repl_.reset();
+  mshr_.clear();
+  prefetched_.fill(0);
+  updated_.fill(0);
+  migrated_.fill(0);
+  pf_buffer_.clear();
+  victim_.clear();
+  pf_pending_ = 0;
+  if (prefetcher_) prefetcher_->reset();
 }
 
-std::optional<Cache2Way::MESI> Cache2Way::getLineMESI(uint64_t addr) const {
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+std::optional<ICache::MESI> Cache<Sets, Ways, LineBytes, Repl>::getLineMESI(uint64_t addr) const {
   std::scoped_lock lk(mtx_);
   const uint64_t base = lineBase(addr);
   int w = findLineByBase(base);
-  if (w < 0) return std::nullopt;
+  if (w < 0) {
+    const int b = victim_.empty() ? -1 : victim_.find(base);
+    if (b < 0) return std::nullopt;
+    return victim_.entry(b).state;
+  }
   const uint32_t set_idx = index(base);
-  const auto& L = sets_[set_idx].ways[w];
-  if (!L.valid) return std::nullopt;
-  return L.mesi;
+  const uint32_t ln = slot(set_idx, w);
+  if (!isValid(ln)) return std::nullopt;
+  return mesi_[ln];
 }
 
-Cache2Way::LineInfo Cache2Way::getLineInfo(uint32_t set_idx, uint32_t way_idx) const {
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes, template <uint32_t, uint32_t> class Repl>
+ICache::LineInfo Cache<Sets, Ways, LineBytes, Repl>::getLineInfo(uint32_t set_idx, uint32_t way_idx) const {
   std::scoped_lock lk(mtx_);
   
   if (set_idx >= SETS || way_idx >= WAYS) {
     throw std::out_of_range("getLineInfo: índices fuera de rango");
   }
   
-  const auto& L = sets_[set_idx].ways[way_idx];
+  const uint32_t ln = slot(set_idx, way_idx);
   
   LineInfo info;
-  info.tag = L.tag;
-  info.valid = L.valid;
-  info.dirty = L.dirty;
-  info.mesi = L.mesi;
-  info.last_use = L.last_use;
+  info.tag = tags_[ln];
+  info.valid = isValid(ln);
+  info.dirty = isDirty(ln);
+  info.mesi = mesi_[ln];
+  info.last_use = repl_.state(set_idx, way_idx);
   
   return info;
 }
+
+// ============================================================================
+// Formato de eventos (solo se llama si hay un LogCallback instalado)
+// ============================================================================
+
+static const char* busMsgName(BusMsg m) {
+  switch (m) {
+    case BusMsg::BusRd:      return "BusRd";
+    case BusMsg::BusRdX:     return "BusRdX";
+    case BusMsg::Invalidate: return "Invalidate";
+    case BusMsg::BusUpgr:    return "BusUpgr";
+    case BusMsg::BusUpd:     return "BusUpd";
+    default:                 return "Flush";
+  }
+}
+
+std::string ICache::Event::format() const {
+  std::ostringstream oss;
+  if (kind == Kind::BusIssue) {
+    oss << "[BUS] " << busMsgName(msg) << " emitido por C" << cache_id
+        << " (addr=0x" << std::hex << addr << std::dec << ")";
+    return oss.str();
+  }
+  oss << "[C" << cache_id << "] ";
+  switch (kind) {
+    case Kind::Snoop:
+      oss << "Snoop " << busMsgName(msg) << ": " << mesiName(from) << "->" << mesiName(to)
+          << (flag ? " (flush)" : "");
+      break;
+    case Kind::LoadHit:
+      oss << "LOAD HIT addr=0x" << std::hex << addr << " estado=" << mesiName(to) << std::dec;
+      return oss.str();
+    case Kind::LoadMiss:        oss << "LOAD MISS -> " << mesiName(to); break;
+    case Kind::LoadMissMerged:  oss << "LOAD MISS secundario (MSHR)"; break;
+    case Kind::StoreHit:
+      if (msg == BusMsg::BusUpd)
+        oss << "STORE en " << mesiName(from) << " -> BusUpd";
+      else if (msg == BusMsg::BusUpgr)
+        oss << "STORE en " << mesiName(from) << " -> need upgrade to M";
+      else if (from == MESI::E) oss << "STORE E->M";
+      else                      oss << "STORE en M (ya modificado)";
+      break;
+    case Kind::StoreUpgrade:    oss << "STORE upgrade: " << mesiName(from) << "->" << mesiName(to); break;
+    case Kind::StoreUpdate:     oss << "STORE update: " << mesiName(from) << "->" << mesiName(to); break;
+    case Kind::StoreMiss:       oss << "STORE MISS -> " << mesiName(to); break;
+    case Kind::StreamBufferHit:
+      if (flag) oss << "STORE HIT stream buffer " << mesiName(from) << "->" << mesiName(to);
+      else      oss << "LOAD HIT stream buffer -> " << mesiName(to);
+      break;
+    case Kind::VictimHit:       oss << "VICTIM HIT -> " << mesiName(to); break;
+    case Kind::Prefetch:        oss << "PREFETCH -> " << mesiName(to) << (flag ? " (stream buffer)" : ""); break;
+    case Kind::BackInvalidation: oss << "Back-invalidation L2 -> I"; break;
+    case Kind::BusIssue:        break;
+  }
+  oss << " addr=0x" << std::hex << addr << std::dec;
+  return oss.str();
+}
+
+// ============================================================================
+// Especializaciones precompiladas y fábrica en tiempo de ejecución
+// ============================================================================
+
+#define CACHE_INSTANTIATE_POLICY(SETS_, WAYS_, LINE_, REPL_, KIND_) \
+  template class Cache<SETS_, WAYS_, LINE_, REPL_>;
+#define CACHE_INSTANTIATE(SETS_, WAYS_, LINE_) \
+  CACHE_REPLACEMENT_POLICIES(CACHE_INSTANTIATE_POLICY, SETS_, WAYS_, LINE_)
+CACHE_GEOMETRIES(CACHE_INSTANTIATE)
+#undef CACHE_INSTANTIATE
+#undef CACHE_INSTANTIATE_POLICY
+
+CacheConfig CacheConfig::parse(const std::string& text) {
+  CacheConfig cfg;
+  char x1 = 0, x2 = 0;
+  std::istringstream iss(text);
+  if (!(iss >> cfg.sets >> x1 >> cfg.ways >> x2 >> cfg.line_bytes) || x1 != 'x' || x2 != 'x') {
+    throw std::invalid_argument("CacheConfig: formato esperado SETSxWAYSxLINE[:POLÍTICA], recibido '" + text + "'");
+  }
+  std::string policy;
+  if (iss.peek() == ':') {
+    iss.get();
+    iss >> policy;
+    for (auto& ch : policy) ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+    bool found = false;
+    for (auto k : {ReplacementKind::LRU, ReplacementKind::TreePLRU, ReplacementKind::SRRIP,
+                   ReplacementKind::BRRIP, ReplacementKind::Random}) {
+      std::string name = replacementName(k);
+      for (auto& ch : name) ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+      if (name == policy) { cfg.replacement = k; found = true; }
+    }
+    if (!found) throw std::invalid_argument("CacheConfig: política desconocida '" + policy + "'");
+  }
+  return cfg;
+}
+
+std::string CacheConfig::toString() const {
+  std::ostringstream oss;
+  oss << sets << "x" << ways << "x" << line_bytes << ":" << replacementName(replacement);
+  return oss.str();
+}
+
+std::unique_ptr<ICache> makeCache(const CacheConfig& cfg, IMainMemory& mem) {
+#define CACHE_MAKE_POLICY(SETS_, WAYS_, LINE_, REPL_, KIND_)                    \
+  if (cfg.replacement == ReplacementKind::KIND_)                                 \
+    return std::make_unique<Cache<SETS_, WAYS_, LINE_, REPL_>>(mem);
+#define CACHE_MAKE(SETS_, WAYS_, LINE_)                                          \
+  if (cfg.sets == SETS_ && cfg.ways == WAYS_ && cfg.line_bytes == LINE_) {       \
+    CACHE_REPLACEMENT_POLICIES(CACHE_MAKE_POLICY, SETS_, WAYS_, LINE_)           \
+  }
+  CACHE_GEOMETRIES(CACHE_MAKE)
+#undef CACHE_MAKE
+#undef CACHE_MAKE_POLICY
+  throw std::invalid_argument("makeCache: geometría no soportada " + cfg.toString());
+}
+
+std::vector<CacheConfig> supportedCacheConfigs() {
+  std::vector<CacheConfig> out;
+#define CACHE_LIST(SETS_, WAYS_, LINE_) out.push_back({SETS_, WAYS_, LINE_});
+  CACHE_GEOMETRIES(CACHE_LIST)
+#undef CACHE_LIST
+  return out;
+}
@@ -1,37 +1,68 @@
 #pragma once
 #include <cstdint>
+#include <algorithm>
 #include <array>
 #include <mutex>
 #include <cstring>
+#include <memory>
 #include <optional>
 #include <ostream>
 #include <sstream>  // ← AGREGADO: necesario para std::ostringstream
 #include <stdexcept>
 #include <functional>
+#include <string>
+#include <vector>
 #include "interconnect.hpp"
+#include "replacement.hpp"
+#include "tag_match.hpp"
+#include "mshr.hpp"
+#include "prefetcher.hpp"
+#include "line_buffer.hpp"
+#include "log_level.hpp"
+#include "coherence.hpp"
 
-/// Interfaz mínima para memoria principal.
+/// Interfaz mínima para memoria principal (o el nivel siguiente de caché).
 struct IMainMemory {
   virtual ~IMainMemory() = default;
   virtual void read64(uint64_t addr, uint64_t& out) = 0;
   virtual void write64(uint64_t addr, uint64_t value) = 0;
+
+  /// Transferencia de una línea completa (`bytes` múltiplo de 8, alineada).
+  /// Por defecto se descompone en palabras.
+  virtual void readLine(uint64_t addr, uint8_t* dst, uint32_t bytes) {
+    for (uint32_t i = 0; i < bytes; i += 8) {
+      uint64_t v = 0;
+      read64(addr + i, v);
+      std::memcpy(dst + i, &v, 8);
+    }
+  }
+  virtual void writeLine(uint64_t addr, const uint8_t* src, uint32_t bytes) {
+    for (uint32_t i = 0; i < bytes; i += 8) {
+      uint64_t v = 0;
+      std::memcpy(&v, src + i, 8);
+      write64(addr + i, v);
+    }
+  }
+
+  /// ¿Cae [addr, addr + bytes) dentro de la memoria? La caché lo consulta
+  /// antes de emitir un prefetch, que puede salirse por arriba (o dar la
+  /// vuelta con un stride negativo). Por defecto la memoria no tiene límite.
+  virtual bool contains(uint64_t /*addr*/, uint32_t /*bytes*/) const { return true; }
+
+  /// Aviso de que el nivel superior descartó una línea limpia
+  /// (lo usa una L2 exclusiva para quedarse con la víctima).
+  virtual void evictClean(uint64_t /*addr*/, const uint8_t* /*src*/, uint32_t /*bytes*/) {}
 };
 
-/// Caché 2-way, 16 líneas, 32B por línea, write-allocate + write-back.
-class Cache2Way : public IBusClient {
-public:
-  static constexpr uint32_t LINE_SIZE_BYTES = 32;
-  static constexpr uint32_t NUM_LINES       = 16;
-  static constexpr uint32_t WAYS            = 2;
-  static constexpr uint32_t SETS            = NUM_LINES / WAYS;
-  static constexpr uint32_t OFFSET_BITS     = 5;
-  static constexpr uint32_t INDEX_BITS      = 3;
-  static constexpr uint64_t OFFSET_MASK     = (1ull << OFFSET_BITS) - 1;
-  static constexpr uint64_t INDEX_MASK      = (1ull << INDEX_BITS) - 1;
-  static constexpr uint32_t WORD_SIZE       = 8;
-  static constexpr uint32_t WORDS_PER_LINE  = LINE_SIZE_BYTES / WORD_SIZE;
+constexpr bool isPowerOfTwo(uint32_t v) { return v != 0 && (v & (v - 1)) == 0; }
+constexpr uint32_t log2Exact(uint32_t v) { return v <= 1 ? 0 : 1 + log2Exact(v >> 1); }
 
-  enum class MESI : uint8_t { I=0, S, E, M };
+/// Interfaz común a todas las geometrías de caché.
+/// PE, GUI y la fábrica trabajan contra esta clase; la geometría concreta
+/// vive en Cache<Sets, Ways, LineBytes>.
+class ICache : public IBusClient {
+public:
+  using MESI = LineState;  // ver coherence.hpp
 
   struct Stats {
     uint64_t hits        = 0;
@@ -43,9 +74,72 @@ public:
     uint64_t bus_rd      = 0;
     uint64_t bus_rdx     = 0;
     uint64_t bus_inv     = 0;
+    uint64_t bus_upgr    = 0;  // upgrades S/O/F -> M sin datos
+    uint64_t bus_cycles  = 0;  // ocupación del bus por los mensajes emitidos (BusCost o TimingConfig)
+    uint64_t bus_bytes   = 0;  // bytes de dirección + datos de esos mensajes
+    uint64_t upgrade_races = 0;  // upgrades que perdieron la línea y se repitieron como BusRdX
     uint64_t snoop_to_I  = 0;
     uint64_t snoop_to_S  = 0;
+    uint64_t snoop_to_O  = 0;  // MOESI: M->O al entregar la línea a otra caché
+    uint64_t snoop_forward = 0;  // MESIF: BusRd/BusRdX respondidos con el dato desde F (o E/M)
+    uint64_t forwarded_fills = 0;  // MESIF: misses llenados por otra caché en lugar de memoria
+
+    // Transferencias caché a caché
+    uint64_t c2c_fills    = 0;  // líneas llenadas con el dato de otra caché
+    uint64_t mem_fills    = 0;  // líneas llenadas desde memoria
+    uint64_t c2c_supplied = 0;  // líneas que esta caché entregó a otra
+
+    // Protocolos de actualización (Dragon/Firefly)
+    uint64_t bus_upd      = 0;  // BusUpd emitidos (una palabra cada uno)
+    uint64_t upd_received = 0;  // palabras escritas aquí por BusUpd de otras cachés
+    uint64_t upd_useful   = 0;  // líneas actualizadas que se accedieron antes de la siguiente actualización
+
+    // Líneas migratorias (ver migratory.hpp)
+    uint64_t migratory_fills  = 0;  // lecturas que el bus sirvió en exclusiva
+    uint64_t upgrades_avoided = 0;  // stores sin BusUpgr/BusUpd gracias a una de esas lecturas
     uint64_t snoop_flush = 0;
+    uint64_t evictions   = 0;  // víctimas válidas desalojadas por la política
+
+    // MSHR / paralelismo a nivel de memoria (ver mshr.hpp)
+    uint64_t mshr_allocs      = 0;  // misses primarios que ocuparon un MSHR
+    uint64_t mshr_merges      = 0;  // misses secundarios fusionados (también cuentan en misses)
+    uint64_t mshr_full_stalls = 0;  // misses que encontraron el archivo lleno
+    uint64_t mshr_stall_ticks = 0;  // accesos perdidos esperando un MSHR libre
+    uint64_t hits_under_miss  = 0;  // hits servidos con misses en vuelo
+    uint64_t mshr_occupancy   = 0;  // suma de MSHRs ocupados, muestreada en cada acceso
+    uint64_t mshr_busy_ticks  = 0;  // accesos con al menos un miss en vuelo
+    uint64_t mshr_peak        = 0;  // máximo de misses simultáneos
+
+    // Prefetch (ver prefetcher.hpp)
+    uint64_t prefetch_issued  = 0;  // BusRd de prefetch emitidos
+    uint64_t prefetch_useful  = 0;  // líneas prefetcheadas usadas por un acceso de demanda
+    uint64_t prefetch_late    = 0;  // útiles que llegaron tarde (llenado aún en vuelo)
+    uint64_t prefetch_unused  = 0;  // desalojadas o invalidadas sin usarse
+    uint64_t prefetch_dropped = 0;  // candidatos descartados (ya presentes, fuera de memoria o sin MSHR)
+
+    // Victim buffer
+    uint64_t victim_hits      = 0;  // misses del arreglo principal resueltos en el victim buffer
+    uint64_t victim_evictions = 0;  // líneas que salieron del victim buffer hacia memoria
+
+    uint64_t back_invalidations = 0;  // líneas invalidadas por una L2 inclusiva
+
+    // Tiempo simulado (ver timing.hpp)
+    uint64_t bus_wait_cycles = 0;  // ciclos esperando el bus ocupado por otras transacciones
+
+    /// Misses en vuelo promedio mientras hay al menos uno (MLP).
+    double mlp() const { return mshr_busy_ticks ? double(mshr_occupancy) / mshr_busy_ticks : 0.0; }
+
+    /// Fracción de prefetches emitidos que se usaron.
+    double prefetchAccuracy() const { return prefetch_issued ? double(prefetch_useful) / prefetch_issued : 0.0; }
+    /// Fracción de los misses originales que el prefetch eliminó.
+    double prefetchCoverage() const {
+      const uint64_t base_misses = prefetch_useful + misses - prefetch_late;
+      return base_misses ? double(prefetch_useful - prefetch_late) / base_misses : 0.0;
+    }
+    /// Fracción de prefetches útiles que llegaron a tiempo.
+    double prefetchTimeliness() const {
+      return prefetch_useful ? double(prefetch_useful - prefetch_late) / prefetch_useful : 0.0;
+    }
   };
 
   struct LineInfo {
@@ -53,110 +147,542 @@ public:
     bool valid;
     bool dirty;
     MESI mesi;
-    uint64_t last_use;
+    uint64_t last_use;  // metadato de reemplazo: stamp LRU, RRPV, bit PLRU...
+  };
+
+  static const char* mesiName(MESI m) {
+    switch (m) {
+      case MESI::M: return "M";
+      case MESI::E: return "E";
+      case MESI::S: return "S";
+      case MESI::O: return "O";
+      case MESI::F: return "F";
+      default: return "I";
+    }
+  }
+
+  /// Evento de coherencia. Se arma en la pila sin reservar memoria; el
+  /// texto para la GUI solo se construye si alguien lo pide (format()).
+  struct Event {
+    enum class Kind : uint8_t {
+      BusIssue,          // msg emitido al bus
+      Snoop,             // from -> to; flag = hubo flush
+      LoadHit,           // to = estado de la línea
+      LoadMiss,          // addr = base de la línea
+      LoadMissMerged,    // miss secundario fusionado en un MSHR
+      StoreHit,          // from -> to
+      StoreUpgrade,      // S -> M tras el BusUpgr
+      StoreUpdate,       // S/O -> O/M (S/E en Firefly) tras el BusUpd
+      StoreMiss,
+      StreamBufferHit,   // flag = store
+      VictimHit,
+      Prefetch,          // flag = va al stream buffer
+      BackInvalidation,
+    };
+    Kind kind;
+    int cache_id;
+    uint64_t addr;
+    BusMsg msg = BusMsg::BusRd;
+    MESI from = MESI::I;
+    MESI to = MESI::I;
+    bool flag = false;
+
+    std::string format() const;
   };
 
-  // Callback para notificar eventos MESI a la GUI
+  // Callbacks para notificar eventos a la GUI: estructurado o ya formateado
+  using EventCallback = std::function<void(const Event&)>;
   using LogCallback = std::function<void(const std::string&)>;
 
-  explicit Cache2Way(IMainMemory& mem) : mem_(mem) {}
+  virtual void setId(int id) = 0;
+  virtual void setBus(Interconnect* b) = 0;
+  virtual void setLogCallback(LogCallback cb) = 0;
+  virtual void setEventCallback(EventCallback cb) = 0;
+  /// entries MSHRs (> 0); fill_latency = accesos que tarda un llenado (0 = bloqueante)
+  virtual void setMSHRConfig(uint32_t entries, uint32_t fill_latency) = 0;
+  /// Victim buffer totalmente asociativo de `lines` líneas (0 = sin buffer).
+  virtual void setVictimBuffer(uint32_t lines) = 0;
+  /// Protocolo de coherencia (MESI por defecto). Todas las cachés de un bus
+  /// deben usar el mismo.
+  virtual void setProtocol(CoherenceProtocol p) = 0;
+  virtual CoherenceProtocol protocol() const = 0;
+  /// Con `on`, una línea sucia entregada a otra caché también se escribe a
+  /// memoria (queda limpia en ambas). Por defecto solo viaja por el bus.
+  virtual void setC2CUpdatesMemory(bool on) = 0;
+  /// Conecta un prefetcher (nullptr lo desactiva).
+  virtual void setPrefetcher(std::unique_ptr<IPrefetcher> pf) = 0;
+
+  /// Invalidación desde el nivel inferior (L2 inclusiva): al volver, la
+  /// caché ya no tiene la línea (las copias sucias se escriben abajo). Toma
+  /// el mutex de la caché, así que se llama sin locks de la L2 tomados; la
+  /// caché, a su vez, nunca lee del nivel inferior con su mutex tomado.
+  virtual void backInvalidate(uint64_t base_addr, uint32_t bytes) = 0;
+
+  /// PC de la instrucción que hace el próximo acceso (lo usa el prefetcher por stride).
+  void setAccessPC(uint64_t pc) { access_pc_ = pc; }
+
+  /// Reloj del PE en ciclos simulados: el PE lo fija antes de cada acceso y
+  /// lo lee después; el acceso lo adelanta según TimingConfig.
+  void setClock(uint64_t cycle) { now_ = cycle; }
+  uint64_t clock() const { return now_; }
+  virtual void setTiming(const TimingConfig& t) = 0;
+  virtual TimingConfig timing() const = 0;
+
+  virtual bool load64(uint64_t addr, uint64_t& out) = 0;
+  virtual bool store64(uint64_t addr, uint64_t value) = 0;
+
+  bool loadDouble(uint64_t addr, double& out) {
+    uint64_t bits = 0;
+    bool hit = load64(addr, bits);
+    std::memcpy(&out, &bits, sizeof(bits));
+    return hit;
+  }
+  bool storeDouble(uint64_t addr, double value) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return store64(addr, bits);
+  }
+
+  virtual void flushAll() = 0;
+  virtual void invalidateAll() = 0;
+  virtual void resetStats() = 0;
+  virtual Stats getStats() const = 0;
+  virtual void dump(std::ostream& os) const = 0;
+
+  virtual std::optional<MESI> getLineMESI(uint64_t addr) const = 0;
+  virtual LineInfo getLineInfo(uint32_t set_idx, uint32_t way_idx) const = 0;
+
+  // Geometría en tiempo de ejecución (para GUI, barridos y reportes)
+  virtual uint32_t numSets() const = 0;
+  virtual uint32_t numWays() const = 0;
+  virtual uint32_t lineBytes() const = 0;
+  virtual ReplacementKind replacement() const = 0;
+
+protected:
+  uint64_t access_pc_ = 0;
+  uint64_t now_ = 0;  // solo lo toca el hilo del PE dueño, nunca un snoop
+};
+
+/// Caché asociativa por conjuntos, write-allocate + write-back.
+/// La geometría es parámetro de plantilla: index()/tag()/lineBase() se
+/// reducen a desplazamientos y máscaras constantes en cada especialización.
+/// La política de reemplazo también (ver replacement.hpp).
+template <uint32_t Sets, uint32_t Ways, uint32_t LineBytes,
+          template <uint32_t, uint32_t> class Replacement = LRUReplacement>
+class Cache : public ICache {
+  static_assert(isPowerOfTwo(Sets),      "Sets debe ser potencia de 2");
+  static_assert(isPowerOfTwo(LineBytes), "LineBytes debe ser potencia de 2");
+  static_assert(Ways >= 1,               "Ways debe ser >= 1");
+  static_assert(LineBytes >= 8,          "La línea debe contener al menos una palabra de 64 bits");
+  static_assert(Ways <= 32,              "Las máscaras de válido/sucio por set son de 32 bits");
+
+public:
+  static constexpr uint32_t LINE_SIZE_BYTES = LineBytes;
+  static constexpr uint32_t NUM_LINES       = Sets * Ways;
+  static constexpr uint32_t WAYS            = Ways;
+  static constexpr uint32_t SETS            = Sets;
+  static constexpr uint32_t OFFSET_BITS     = log2Exact(LineBytes);
+  static constexpr uint32_t INDEX_BITS      = log2Exact(Sets);
+  static constexpr uint64_t OFFSET_MASK     = (1ull << OFFSET_BITS) - 1;
+  static constexpr uint64_t INDEX_MASK      = (1ull << INDEX_BITS) - 1;
+  static constexpr uint32_t WORD_SIZE       = 8;
+  static constexpr uint32_t WORDS_PER_LINE  = LINE_SIZE_BYTES / WORD_SIZE;
 
-  void setId(int id) { std::scoped_lock lk(mtx_); id_ = id; }
-  void setBus(Interconnect* b) { std::scoped_lock lk(mtx_); bus_ = b; }
-  void setLogCallback(LogCallback cb) { log_callback_ = cb; }
+  explicit Cache(IMainMemory& mem) : mem_(mem), data_(NUM_LINES * LINE_SIZE_BYTES, 0) {}
 
-  bool load64(uint64_t addr, uint64_t& out);
-  bool store64(uint64_t addr, uint64_t value);
-  bool loadDouble(uint64_t addr, double& out);
-  bool storeDouble(uint64_t addr, double value);
+  void setId(int id) override { std::scoped_lock lk(mtx_); id_ = id; }
+  void setBus(Interconnect* b) override { std::scoped_lock lk(mtx_); bus_ = b; }
+  void setLogCallback(LogCallback cb) override { log_callback_ = cb; }
+  void setEventCallback(EventCallback cb) override { event_callback_ = cb; }
+  void setMSHRConfig(uint32_t entries, uint32_t fill_latency) override {
+    std::scoped_lock lk(mtx_);
+    mshr_.configure(entries, fill_latency);
+  }
+  void setProtocol(CoherenceProtocol p) override {
+    std::scoped_lock lk(mtx_);
+    protocol_ = p;
+    table_ = &coherenceTable(p);
+  }
+  CoherenceProtocol protocol() const override { return protocol_; }
+  void setC2CUpdatesMemory(bool on) override { std::scoped_lock lk(mtx_); c2c_updates_memory_ = on; }
+  void setTiming(const TimingConfig& t) override { std::scoped_lock lk(mtx_); timing_ = t; }
+  TimingConfig timing() const override { std::scoped_lock lk(mtx_); return timing_; }
+  void setVictimBuffer(uint32_t lines) override {
+    std::scoped_lock lk(mtx_);
+    victim_.configure(lines, LINE_SIZE_BYTES);
+  }
+  void setPrefetcher(std::unique_ptr<IPrefetcher> pf) override;
+  void backInvalidate(uint64_t base_addr, uint32_t bytes) override;
+
+  bool load64(uint64_t addr, uint64_t& out) override {
+    const bool hit = loadDemand(addr, out);
+    if (pf_pending_) issuePrefetches();
+    return hit;
+  }
+  bool store64(uint64_t addr, uint64_t value) override {
+    const bool hit = storeDemand(addr, value);
+    if (pf_pending_) issuePrefetches();
+    return hit;
+  }
 
-  void flushAll();
-  void invalidateAll();
-  void resetStats() { std::scoped_lock lk(mtx_); stats_ = {}; }
-  Stats getStats() const { std::scoped_lock lk(mtx_); return stats_; }
-  void dump(std::ostream& os) const;
+  void flushAll() override;
+  void invalidateAll() override;
+  void resetStats() override { std::scoped_lock lk(mtx_); stats_ = {}; }
+  Stats getStats() const override { std::scoped_lock lk(mtx_); return stats_; }
+  void dump(std::ostream& os) const override;
 
-  std::optional<MESI> getLineMESI(uint64_t addr) const;
-  LineInfo getLineInfo(uint32_t set_idx, uint32_t way_idx) const;
+  std::optional<MESI> getLineMESI(uint64_t addr) const override;
+  LineInfo getLineInfo(uint32_t set_idx, uint32_t way_idx) const override;
 
-  void snoop(BusMsg msg, uint64_t base_addr) override;
+  uint32_t numSets() const override { return SETS; }
+  uint32_t numWays() const override { return WAYS; }
+  uint32_t lineBytes() const override { return LINE_SIZE_BYTES; }
+  ReplacementKind replacement() const override { return Replacement<Sets, Ways>::KIND; }
+
+  void snoop(BusMsg msg, uint64_t base_addr, SnoopReply& reply) override;
 
 private:
-  struct Line {
-    uint64_t tag    = 0;
-    bool     valid  = false;
-    bool     dirty  = false;
-    MESI     mesi   = MESI::I;
-    uint64_t last_use = 0;
-    std::array<uint8_t, LINE_SIZE_BYTES> data{};  // Datos de la línea de caché
-  };
-  struct Set { std::array<Line, WAYS> ways; };
+  // Almacenamiento SoA: tags, válidos, sucios y MESI de cada set en arreglos
+  // densos; los datos viven aparte en data_. Una búsqueda de tag solo toca
+  // una línea de caché del host por set (WAYS*8 bytes de tags + máscara).
+  static inline uint32_t slot(uint32_t set_idx, uint32_t way_idx) { return set_idx * WAYS + way_idx; }
+  static constexpr uint32_t bit(uint32_t way_idx) { return 1u << way_idx; }
+
+  bool isValid(uint32_t ln) const { return valid_[ln / WAYS] & bit(ln % WAYS); }
+  bool isDirty(uint32_t ln) const { return dirty_[ln / WAYS] & bit(ln % WAYS); }
+  void setValid(uint32_t ln, bool v) {
+    if (v) valid_[ln / WAYS] |= bit(ln % WAYS); else valid_[ln / WAYS] &= ~bit(ln % WAYS);
+  }
+  void setDirty(uint32_t ln, bool d) {
+    if (d) dirty_[ln / WAYS] |= bit(ln % WAYS); else dirty_[ln / WAYS] &= ~bit(ln % WAYS);
+  }
+  uint8_t* lineData(uint32_t ln) { return &data_[static_cast<size_t>(ln) * LINE_SIZE_BYTES]; }
+  const uint8_t* lineData(uint32_t ln) const { return &data_[static_cast<size_t>(ln) * LINE_SIZE_BYTES]; }
 
   static inline uint64_t lineBase(uint64_t addr)   { return addr & ~OFFSET_MASK; }
   static inline uint32_t offset(uint64_t addr)     { return static_cast<uint32_t>(addr & OFFSET_MASK); }
   static inline uint32_t index(uint64_t addr)      { return static_cast<uint32_t>((addr >> OFFSET_BITS) & INDEX_MASK); }
   static inline uint64_t tag(uint64_t addr)        { return addr >> (OFFSET_BITS + INDEX_BITS); }
   static inline uint32_t wordOffset(uint64_t addr) { return static_cast<uint32_t>((offset(addr)) / WORD_SIZE); }
+  static inline uint64_t baseOf(uint64_t tg, uint32_t set_idx) {
+    return (tg << (INDEX_BITS + OFFSET_BITS)) | (static_cast<uint64_t>(set_idx) << OFFSET_BITS);
+  }
 
+  uint32_t matchWays(uint32_t set_idx, uint64_t tg) const {
+    return matchTags<WAYS>(&tags_[slot(set_idx, 0)], tg) & valid_[set_idx];
+  }
   std::optional<uint32_t> findHit(uint32_t set_idx, uint64_t tag) const;
-  uint32_t chooseVictim(uint32_t set_idx) const;
+  uint32_t chooseVictim(uint32_t set_idx);
+  void evictSlot(uint32_t set_idx, uint32_t way_idx);
+  void installLine(uint32_t set_idx, uint32_t way_idx, uint64_t tg);
+  void readLineFromMemory(uint64_t base_addr, uint8_t* dst);
+  void writeLineToMemory(uint64_t base_addr, const uint8_t* src);
+  bool swapFromVictimBuffer(uint32_t set_idx, uint64_t tg, uint64_t base);
+  bool snoopBuffered(LineBuffer<MESI>& buf, BusMsg msg, uint64_t base_addr, SnoopReply& reply);
   void fetchLine(uint32_t set_idx, uint32_t way_idx, uint64_t base_addr, uint64_t tg);
+  void fillLine(uint32_t set_idx, uint32_t way_idx, uint64_t tg, const SnoopReply& r);
+
+  const Transition& transition(MESI st, CoherenceEvent ev) const { return table_->at(st, ev); }
+  static MESI resolve(const Transition& t, const SnoopReply& r) { return t.resolve(r.shared || r.supplied); }
+
+  // Estado tras llenar la línea `ln`. En una lectura migratoria el bus
+  // invalidó las demás copias: la línea queda en E, o en M si llegó sucia.
+  MESI fillState(uint32_t ln, const Transition& t, const SnoopReply& r) {
+    if (!r.migratory) return resolve(t, r);
+    migrated_[ln / WAYS] |= bit(ln % WAYS);
+    stats_.migratory_fills++;
+    setDirty(ln, r.dirty);
+    return r.dirty ? MESI::M : t.next;
+  }
+  // Store local sin transacción: si la línea vino de una lectura migratoria,
+  // es el upgrade que se evitó.
+  void noteMigratoryUse(uint32_t ln) {
+    if (!(migrated_[ln / WAYS] & bit(ln % WAYS))) return;
+    migrated_[ln / WAYS] &= ~bit(ln % WAYS);
+    stats_.upgrades_avoided++;
+  }
+
+  // Aplica la entrada (st, msg) de la tabla a una copia de la línea, del
+  // arreglo principal o de un buffer: respuesta al bus, entrega, flush o
+  // actualización del dato, y nuevo estado/sucio. Devuelve la acción y si
+  // hubo flush.
+  std::pair<DataAction, bool> snoopLine(MESI& st, bool& dirty, uint8_t* line, BusMsg msg,
+                                        uint64_t base_addr, SnoopReply& reply);
+
+  // Copia la línea al buffer del solicitante (transferencia caché a caché).
+  bool supplyLine(const uint8_t* src, SnoopReply& reply) {
+    if (!reply.data || reply.bytes != LINE_SIZE_BYTES) return false;
+    std::memcpy(reply.data, src, LINE_SIZE_BYTES);
+    reply.supplied = true;
+    stats_.c2c_supplied++;
+    return true;
+  }
   void writeBackIfDirty(uint32_t set_idx, uint32_t way_idx, uint64_t base_addr);
   std::pair<uint32_t,bool> ensureLine(uint64_t addr);
 
-  static inline uint64_t readWordInLine(const Line& L, uint32_t word_off) {
+  inline uint64_t readWordInLine(uint32_t ln, uint32_t word_off) const {
     uint64_t v = 0;
-    std::memcpy(&v, &L.data[word_off * WORD_SIZE], WORD_SIZE);
+    std::memcpy(&v, lineData(ln) + word_off * WORD_SIZE, WORD_SIZE);
     return v;
   }
-  static inline void writeWordInLine(Line& L, uint32_t word_off, uint64_t v) {
-    std::memcpy(&L.data[word_off * WORD_SIZE], &v, WORD_SIZE);
+  inline void writeWordInLine(uint32_t ln, uint32_t word_off, uint64_t v) {
+    std::memcpy(lineData(ln) + word_off * WORD_SIZE, &v, WORD_SIZE);
   }
 
   int findLineByBase(uint64_t base_addr) const;
-  static const char* mesiName(MESI m) {
-    switch (m) {
-      case MESI::M: return "M";
-      case MESI::E: return "E";
-      case MESI::S: return "S";
-      default: return "I";
+  void invalidateFromBelow(uint64_t base_addr);  // una línea, con mtx_ tomado
+
+  bool loadDemand(uint64_t addr, uint64_t& out);
+  bool storeDemand(uint64_t addr, uint64_t value);
+
+  // Prefetch: los candidatos se calculan con el lock tomado y se emiten
+  // después del acceso de demanda, igual que cualquier otro BusRd.
+  void issuePrefetches();
+
+  void trainPrefetcher(uint64_t addr, uint64_t base, bool miss, bool prefetch_hit) {
+    if (!prefetcher_) return;
+    pf_pending_ = prefetcher_->onAccess(PrefetchAccess{ access_pc_, addr, base, miss, prefetch_hit }, pf_queue_.data());
+  }
+
+  // Primer uso de una línea traída por prefetch; `merged` indica que su
+  // llenado seguía en vuelo (prefetch tardío).
+  bool notePrefetchUse(uint32_t set_idx, uint32_t way_idx, bool merged) {
+    if (!(prefetched_[set_idx] & bit(way_idx))) return false;
+    prefetched_[set_idx] &= ~bit(way_idx);
+    stats_.prefetch_useful++;
+    if (merged) stats_.prefetch_late++;
+    return true;
+  }
+
+  // Primer acceso local a una línea que otra caché actualizó.
+  void noteUpdateUse(uint32_t set_idx, uint32_t way_idx) {
+    if (!(updated_[set_idx] & bit(way_idx))) return;
+    updated_[set_idx] &= ~bit(way_idx);
+    stats_.upd_useful++;
+  }
+
+  void dropPrefetchedBit(uint32_t ln) {
+    if (prefetched_[ln / WAYS] & bit(ln % WAYS)) {
+      prefetched_[ln / WAYS] &= ~bit(ln % WAYS);
+      stats_.prefetch_unused++;
+    }
+  }
+
+  // Reloj lógico de accesos: retira MSHRs completados y muestrea ocupación.
+  // El reloj simulado avanza la búsqueda de tag.
+  void beginAccess() {
+    ++access_tick_;
+    now_ += timing_.hit_cycles;
+    if (!mshr_.enabled()) return;
+    mshr_.retire(access_tick_);
+    if (const uint32_t n = mshr_.outstanding()) {
+      stats_.mshr_occupancy += n;
+      stats_.mshr_busy_ticks++;
     }
   }
 
-  void logMESI(const std::string& msg) {
-    if (log_callback_) {
-      log_callback_(msg);
+  // Acceso con la línea presente: si su llenado sigue en vuelo es un miss
+  // secundario que se fusiona con el MSHR existente.
+  bool mergePending(uint64_t base) {
+    if (auto* e = mshr_.find(base)) {
+      e->merged++;
+      stats_.mshr_merges++;
+      stats_.misses++;
+      return true;
     }
+    if (mshr_.outstanding()) stats_.hits_under_miss++;
+    return false;
   }
 
-  inline void emit(BusMsg m, uint64_t base_addr) {
+  // Entre la lectura del nivel inferior y la instalación (sin mtx_) una
+  // back-invalidation no encuentra la línea en la caché: se anota y se
+  // aplica en endFill(), después de usarla.
+  void beginFill(uint64_t base_addr) {
+    filling_ = base_addr;
+    fill_revoked_ = false;
+  }
+  void endFill() {
+    if (fill_revoked_) invalidateFromBelow(filling_);
+    filling_ = NO_FILL;
+    fill_revoked_ = false;
+  }
+
+  // Miss primario: reserva un MSHR, esperando al más antiguo si no hay libres.
+  void allocateMSHR(uint64_t base) {
+    if (!mshr_.enabled()) return;
+    if (!mshr_.find(base) && mshr_.full()) {
+      const uint64_t ready = mshr_.earliestReady();
+      stats_.mshr_full_stalls++;
+      stats_.mshr_stall_ticks += ready - access_tick_;
+      access_tick_ = ready;
+      mshr_.retire(access_tick_);
+    }
+    mshr_.allocate(base, access_tick_);
+    stats_.mshr_allocs++;
+    if (mshr_.outstanding() > stats_.mshr_peak) stats_.mshr_peak = mshr_.outstanding();
+  }
+
+  // Línea instalada por un acceso de demanda, leída de memoria salvo que
+  // otra caché la haya entregado.
+  void chargeFill(bool supplied) {
+    now_ += timing_.fill_cycles + (supplied ? 0 : timing_.mem_read_cycles);
+  }
+
+  // Sin callbacks instalados esto son dos comparaciones: ni reserva ni formato.
+  // Con MESI_LOG_LEVEL=0 desaparece junto con la construcción del evento.
+  void report(const Event& e) {
+    if constexpr (logEnabled(LogLevel::Events)) {
+      if (event_callback_) event_callback_(e);
+    }
+    if constexpr (logEnabled(LogLevel::Trace)) {
+      if (log_callback_) log_callback_(e.format());
+    }
+    (void)e;
+  }
+
+  // El buffer de llenado solo lo usa el hilo dueño de la caché (los misses
+  // y prefetches son secuenciales); los snoopers escriben en él durante el
+  // broadcast, mientras el dueño espera.
+  // want_data = false en BusUpgr: la línea ya está aquí y nadie la copia.
+  // demand = BusRd de un acceso de demanda (no prefetch): puede recibir la
+  // línea en exclusiva si es migratoria.
+  inline SnoopReply emit(BusMsg m, uint64_t base_addr, bool want_data = true, bool demand = false) {
+    SnoopReply reply{ want_data ? fill_buf_.data() : nullptr, want_data ? LINE_SIZE_BYTES : 0, false };
+    reply.exclusive_ok = demand && m == BusMsg::BusRd;
+    transmit(m, base_addr, reply, demand);
+    return reply;
+  }
+
+  // BusUpd con la palabra de `addr`; la respuesta indica si alguien más
+  // conserva la línea.
+  inline SnoopReply emitUpdate(uint64_t addr, uint64_t value) {
+    SnoopReply reply{ reinterpret_cast<uint8_t*>(&value), WORD_SIZE };
+    reply.offset = offset(addr);
+    transmit(BusMsg::BusUpd, lineBase(addr), reply, true);
+    reply.data = nullptr;
+    return reply;
+  }
+
+  // Sin una caché que la entregue, la línea se lee del nivel inferior al
+  // buffer de llenado. Va sin mtx_: una L2 inclusiva puede back-invalidar
+  // cualquier L1, esta incluida, mientras la trae.
+  void readUnsupplied(uint64_t base_addr, const SnoopReply& r) {
+    if (!r.supplied) mem_.readLine(base_addr, fill_buf_.data(), LINE_SIZE_BYTES);
+  }
+
+  // Transacción que pide una entrada de la tabla para un Store en `addr`.
+  inline SnoopReply issue(BusMsg m, uint64_t addr, uint64_t value) {
+    if (m == BusMsg::BusUpd) return emitUpdate(addr, value);
+    return emit(m, lineBase(addr), m != BusMsg::BusUpgr, true);
+  }
+
+  // Un mensaje de demanda detiene al PE hasta que el bus lo atiende y los
+  // snoopers responden; uno de prefetch solo ocupa el bus.
+  void transmit(BusMsg m, uint64_t base_addr, SnoopReply& reply, bool stall) {
     if (!bus_) return;
     switch (m) {
       case BusMsg::BusRd:       stats_.bus_rd++;  break;
       case BusMsg::BusRdX:      stats_.bus_rdx++; break;
       case BusMsg::Invalidate:  stats_.bus_inv++; break;
+      case BusMsg::BusUpgr:     stats_.bus_upgr++; break;
+      case BusMsg::BusUpd:      stats_.bus_upd++; break;
       default: break;
     }
-    
-    std::ostringstream oss;
-    oss << "[BUS] ";
-    if (m == BusMsg::BusRd) oss << "BusRd";
-    else if (m == BusMsg::BusRdX) oss << "BusRdX";
-    else if (m == BusMsg::Invalidate) oss << "Invalidate";
-    else oss << "Flush";
-    oss << " emitido por C" << id_ << " (addr=0x" << std::hex << base_addr << std::dec << ")";
-    logMESI(oss.str());
+    const BusCost cost = bus_->cost();
+    const uint32_t occupancy = timing_.msgCycles(m) ? timing_.msgCycles(m) : cost.cycles(m, LINE_SIZE_BYTES);
+    const uint32_t addr_cycles = std::min(cost.addr_cycles, occupancy);
+    stats_.bus_cycles += occupancy;
+    stats_.bus_bytes += cost.bytes(m, LINE_SIZE_BYTES);
+    const BusGrant g = bus_->reserveBus(BusTransfer{ this, m, base_addr, now_, addr_cycles, occupancy - addr_cycles,
+                                                     cost.addr_bytes, BusCost::payload(m, LINE_SIZE_BYTES),
+                                                     timing_.snoop_cycles });
+    if (stall) {
+      stats_.bus_wait_cycles += g.start - now_;
+      now_ = g.done;
+    }
+
+    report(Event{ Event::Kind::BusIssue, id_, base_addr, m });
 
-    bus_->broadcast(this, m, base_addr);
+    // Toda transacción de la caché termina con endTransaction()
+    reply.hold = true;
+    bus_->broadcast(this, m, base_addr, reply);
+  }
+
+  // La línea ya quedó instalada o en su nuevo estado (con mtx_ tomado):
+  // un bus de transacciones partidas puede atender otra petición sobre ella.
+  void endTransaction(uint64_t base_addr) {
+    if (bus_) bus_->complete(this, base_addr);
   }
 
 private:
   IMainMemory& mem_;
   mutable std::mutex mtx_;
-  std::array<Set, SETS> sets_{};  // Almacenamiento de las líneas de caché
-  mutable uint64_t use_tick_ = 0;
+  alignas(32) std::array<uint64_t, NUM_LINES> tags_{};  // Tags, WAYS contiguos por set
+  std::array<uint32_t, SETS> valid_{};   // Bit w = vía w válida
+  std::array<uint32_t, SETS> dirty_{};   // Bit w = vía w sucia
+  std::array<MESI, NUM_LINES> mesi_{};   // Estado MESI por línea
+  std::vector<uint8_t> data_;            // Pool de datos: NUM_LINES * LINE_SIZE_BYTES
+  Replacement<Sets, Ways> repl_;  // Estado de la política de reemplazo
+  MSHRFile mshr_;                 // Misses en vuelo
+  uint64_t access_tick_ = 0;      // Reloj lógico (un tick por acceso)
+  std::unique_ptr<IPrefetcher> prefetcher_;
+  std::array<uint32_t, SETS> prefetched_{};  // Bit w = vía w traída por prefetch y aún sin usar
+  std::array<uint32_t, SETS> updated_{};     // Bit w = vía w actualizada por un BusUpd y aún sin acceder
+  std::array<uint32_t, SETS> migrated_{};    // Bit w = vía w recibida en exclusiva por ser migratoria, aún sin escribir
+  LineBuffer<MESI> pf_buffer_;               // Stream buffers (solo si el prefetcher los pide)
+  LineBuffer<MESI> victim_;                  // Victim buffer (vacío = desactivado)
+  std::array<uint64_t, IPrefetcher::MAX_CANDIDATES> pf_queue_{};
+  uint32_t pf_pending_ = 0;                  // Candidatos en pf_queue_ por emitir
   Stats stats_{};  // Estadísticas de la caché
   Interconnect* bus_ = nullptr;  // Bus de comunicación
+  CoherenceProtocol protocol_ = CoherenceProtocol::MESI;
+  const CoherenceTable* table_ = &coherenceTable(CoherenceProtocol::MESI);
+  bool c2c_updates_memory_ = false;
+  TimingConfig timing_;
+  std::array<uint8_t, LINE_SIZE_BYTES> fill_buf_{};  // Línea entregada por otra caché o leída abajo
+  static constexpr uint64_t NO_FILL = ~0ull;
+  uint64_t filling_ = NO_FILL;   // Línea en llenado (ver beginFill)
+  bool fill_revoked_ = false;    // La L2 la back-invalidó durante el llenado
   int id_ = -1;  // ID de la caché
   LogCallback log_callback_;  // Callback para logs
+  EventCallback event_callback_;  // Callback para eventos estructurados
 };
+
+/// Caché 2-way, 16 líneas, 32B por línea (configuración del enunciado).
+class Cache2Way : public Cache<8, 2, 32> {
+public:
+  using Cache::Cache;
+};
+
+// Especializaciones precompiladas en cache.cpp: X(sets, ways, line_bytes).
+// Para agregar una geometría basta con añadirla a esta lista.
+#define CACHE_GEOMETRIES(X) \
+  X(8,    2,  32)           \
+  X(16,   4,  32)           \
+  X(32,   4,  64)           \
+  X(64,   8,  64)           \
+  X(128,  8,  64)           \
+  X(256,  8,  64)           \
+  X(512,  8,  64)           \
+  X(1024, 16, 64)
+
+/// Geometría y política elegidas en tiempo de ejecución.
+struct CacheConfig {
+  uint32_t sets       = 8;
+  uint32_t ways       = 2;
+  uint32_t line_bytes = 32;
+  ReplacementKind replacement = ReplacementKind::LRU;
+
+  /// Formato "SETSxWAYSxLINE[:POLÍTICA]", p.ej. "64x8x64" o "64x8x64:srrip".
+  static CacheConfig parse(const std::string& text);
+  std::string toString() const;
+  uint32_t sizeBytes() const { return sets * ways * line_bytes; }
+};
+
+/// Crea la especialización precompilada que corresponde a `cfg`
+/// (cada geometría está instanciada con todas las políticas).
+/// Lanza std::invalid_argument si la geometría no está en CACHE_GEOMETRIES.
+std::unique_ptr<ICache> makeCache(const CacheConfig& cfg, IMainMemory& mem);
+
+/// Lista de geometrías disponibles para makeCache (útil para barridos).
+std::vector<CacheConfig> supportedCacheConfigs();
@@ -0,0 +1,213 @@
+// coherence.hpp
+// Protocolos de coherencia que soporta Cache (ver setProtocol()).
+//
+//   MESI  -> protocolo base: un BusRd sobre una línea M la escribe a
+//            memoria (flush) y la deja en S.
+//   MOESI -> agrega el estado O (Owned): la dueña entrega la línea
+//            directamente a la caché que la pide, pasa de M a O y conserva
+//            el dato sucio; la escritura a memoria se difiere hasta que la
+//            línea O se desaloja.
+//   MESIF -> agrega el estado F (Forward): entre las copias limpias
+//            compartidas, exactamente una está en F y responde los BusRd
+//            con el dato, así que los misses sobre líneas compartidas no
+//            leen memoria. F pasa al último solicitante; quien lo entrega
+//            queda en S.
+//
+// Protocolos de actualización: un store sobre una línea compartida no
+// invalida a las demás copias sino que les envía la palabra (BusUpd) y
+// todas siguen válidas. Un miss de escritura trae la línea con BusRd.
+//
+//   Dragon  -> E, Sc (S), Sm (O) y M. Quien escribe queda como dueña Sm
+//              con el dato sucio y la dueña anterior pasa a Sc; si ya
+//              nadie comparte la línea, queda en M. Memoria se actualiza
+//              solo al desalojar la dueña.
+//   Firefly -> E, S y M. La escritura compartida también va a memoria
+//              (write-through), así que ninguna copia compartida está
+//              sucia; sin otras copias la línea queda en E.
+//
+// Cada protocolo es una CoherenceTable constexpr indexada por (estado,
+// evento): Load/Store del procesador o el mensaje que llega por snoop. La
+// entrada da el estado siguiente, la transacción que emite el solicitante y
+// qué se hace con el dato. Cache solo consulta la tabla, así que un
+// protocolo nuevo es otra tabla (ver mesiTable() y las que derivan de ella).
+
+#pragma once
+#include <cstdint>
+#include "interconnect.hpp"
+
+enum class CoherenceProtocol : uint8_t { MESI = 0, MOESI, MESIF, Dragon, Firefly };
+
+inline const char* protocolName(CoherenceProtocol p) {
+  switch (p) {
+    case CoherenceProtocol::MESI:    return "MESI";
+    case CoherenceProtocol::MOESI:   return "MOESI";
+    case CoherenceProtocol::MESIF:   return "MESIF";
+    case CoherenceProtocol::Dragon:  return "Dragon";
+    case CoherenceProtocol::Firefly: return "Firefly";
+  }
+  return "?";
+}
+
+/// Stores compartidos con BusUpd en lugar de BusUpgr/BusRdX.
+inline bool isUpdateProtocol(CoherenceProtocol p) {
+  return p == CoherenceProtocol::Dragon || p == CoherenceProtocol::Firefly;
+}
+
+/// Estado de una línea. O solo en MOESI/Dragon (Sm), F solo en MESIF.
+enum class LineState : uint8_t { I = 0, S, E, M, O, F };
+constexpr uint32_t LINE_STATES = 6;
+
+/// Load/Store del procesador local; el resto son snoops del mensaje homónimo.
+enum class CoherenceEvent : uint8_t { Load = 0, Store, BusRd, BusRdX, BusUpgr, Invalidate, BusUpd, Flush };
+constexpr uint32_t COHERENCE_EVENTS = 8;
+
+constexpr CoherenceEvent snoopEvent(BusMsg m) {
+  switch (m) {
+    case BusMsg::BusRd:      return CoherenceEvent::BusRd;
+    case BusMsg::BusRdX:     return CoherenceEvent::BusRdX;
+    case BusMsg::BusUpgr:    return CoherenceEvent::BusUpgr;
+    case BusMsg::Invalidate: return CoherenceEvent::Invalidate;
+    case BusMsg::BusUpd:     return CoherenceEvent::BusUpd;
+    case BusMsg::Flush:      return CoherenceEvent::Flush;
+  }
+  return CoherenceEvent::Flush;
+}
+
+enum class DataAction : uint8_t {
+  None,
+  Write,         // Store: escribir la palabra y marcar la línea sucia
+  WriteThrough,  // Store: escribir la palabra también en memoria (queda limpia)
+  Supply,        // snoop: entregar la línea limpia al solicitante
+  SupplyKeep,    // snoop: entregar la línea y conservar el dato sucio (O); sin
+                 //        buffer donde entregarla, flush y S
+  SupplyFlush,   // snoop: entregar la línea y escribirla a memoria
+  HandOver,      // snoop: la propiedad pasa al solicitante; flush si no la recibió
+  Update,        // snoop: copiar la palabra del BusUpd
+};
+
+/// Entrada de la tabla. Para Load/Store, `issues` indica que el solicitante
+/// emite `bus` y el estado final depende de la respuesta: `next` si nadie
+/// más tiene la línea, `next_shared` si alguien la conserva o la entregó.
+/// Un Store cuya entrada no escribe (p. ej. el BusRd de un miss en Dragon)
+/// se vuelve a buscar con el estado obtenido.
+struct Transition {
+  LineState  next        = LineState::I;
+  LineState  next_shared = LineState::I;
+  bool       issues      = false;
+  BusMsg     bus         = BusMsg::BusRd;
+  DataAction data        = DataAction::None;
+
+  constexpr bool writes() const { return data == DataAction::Write || data == DataAction::WriteThrough; }
+  constexpr LineState resolve(bool shared) const { return shared ? next_shared : next; }
+};
+
+class CoherenceTable {
+public:
+  constexpr const Transition& at(LineState s, CoherenceEvent e) const {
+    return t_[static_cast<uint32_t>(s)][static_cast<uint32_t>(e)];
+  }
+  constexpr void set(LineState s, CoherenceEvent e, const Transition& t) {
+    t_[static_cast<uint32_t>(s)][static_cast<uint32_t>(e)] = t;
+  }
+
+private:
+  Transition t_[LINE_STATES][COHERENCE_EVENTS]{};
+};
+
+/// Transición sin transacción en el bus (hits locales y snoops).
+constexpr Transition stay(LineState next, DataAction d = DataAction::None) {
+  return Transition{ next, next, false, BusMsg::BusRd, d };
+}
+/// Transición del solicitante que emite `m`.
+constexpr Transition request(BusMsg m, LineState alone, LineState shared, DataAction d = DataAction::None) {
+  return Transition{ alone, shared, true, m, d };
+}
+
+// Protocolo base. Las entradas de O y F no se alcanzan en MESI pero quedan
+// definidas para que las tablas derivadas solo cambien lo que difiere.
+constexpr CoherenceTable mesiTable() {
+  using L = LineState;
+  using E = CoherenceEvent;
+  using D = DataAction;
+  CoherenceTable t;
+  constexpr L valid[] = { L::S, L::E, L::M, L::O, L::F };
+
+  t.set(L::I, E::Load,  request(BusMsg::BusRd, L::E, L::S));
+  t.set(L::I, E::Store, request(BusMsg::BusRdX, L::M, L::M, D::Write));
+  for (L s : valid) {
+    t.set(s, E::Load,       stay(s));
+    t.set(s, E::Store,      request(BusMsg::BusUpgr, L::M, L::M, D::Write));
+    t.set(s, E::BusRd,      stay(L::S));
+    t.set(s, E::BusRdX,     stay(L::I));
+    t.set(s, E::BusUpgr,    stay(L::I));
+    t.set(s, E::Invalidate, stay(L::I));
+    t.set(s, E::BusUpd,     stay(L::S, D::Update));
+    t.set(s, E::Flush,      stay(s));
+  }
+  t.set(L::E, E::Store, stay(L::M, D::Write));
+  t.set(L::M, E::Store, stay(L::M, D::Write));
+  for (L s : { L::M, L::O }) {
+    t.set(s, E::BusRd,      stay(L::S, D::SupplyFlush));
+    t.set(s, E::BusRdX,     stay(L::I, D::HandOver));
+    t.set(s, E::BusUpgr,    stay(L::I, D::HandOver));
+    t.set(s, E::Invalidate, stay(L::I, D::HandOver));
+  }
+  t.set(L::I, E::Flush, stay(L::I));
+  return t;
+}
+
+// MOESI: la dueña sucia entrega la línea y sigue como O.
+constexpr CoherenceTable moesiTable() {
+  CoherenceTable t = mesiTable();
+  t.set(LineState::M, CoherenceEvent::BusRd, stay(LineState::O, DataAction::SupplyKeep));
+  t.set(LineState::O, CoherenceEvent::BusRd, stay(LineState::O, DataAction::SupplyKeep));
+  return t;
+}
+
+// MESIF: los llenados compartidos quedan en F y la copia responsable (E/F)
+// entrega el dato en los BusRd y BusRdX.
+constexpr CoherenceTable mesifTable() {
+  CoherenceTable t = mesiTable();
+  t.set(LineState::I, CoherenceEvent::Load, request(BusMsg::BusRd, LineState::E, LineState::F));
+  for (LineState s : { LineState::E, LineState::F }) {
+    t.set(s, CoherenceEvent::BusRd,  stay(LineState::S, DataAction::Supply));
+    t.set(s, CoherenceEvent::BusRdX, stay(LineState::I, DataAction::Supply));
+  }
+  return t;
+}
+
+// Dragon: MOESI sin invalidaciones. Un miss de escritura es un miss de
+// lectura (y luego, según el estado obtenido, un hit); escribir una línea
+// compartida emite BusUpd y deja al escritor como dueña Sm (O).
+constexpr CoherenceTable dragonTable() {
+  CoherenceTable t = moesiTable();
+  t.set(LineState::I, CoherenceEvent::Store, request(BusMsg::BusRd, LineState::E, LineState::S));
+  for (LineState s : { LineState::S, LineState::O }) {
+    t.set(s, CoherenceEvent::Store, request(BusMsg::BusUpd, LineState::M, LineState::O, DataAction::Write));
+  }
+  return t;
+}
+
+// Firefly: como Dragon pero sin dueña compartida; la escritura compartida
+// va también a memoria.
+constexpr CoherenceTable fireflyTable() {
+  CoherenceTable t = mesiTable();
+  t.set(LineState::I, CoherenceEvent::Store, request(BusMsg::BusRd, LineState::E, LineState::S));
+  t.set(LineState::S, CoherenceEvent::Store,
+        request(BusMsg::BusUpd, LineState::E, LineState::S, DataAction::WriteThrough));
+  return t;
+}
+
+// Indexado por CoherenceProtocol
+inline constexpr CoherenceTable COHERENCE_TABLES[] = {
+  mesiTable(), moesiTable(), mesifTable(), dragonTable(), fireflyTable(),
+};
+
+constexpr const CoherenceTable& coherenceTable(CoherenceProtocol p) {
+  return COHERENCE_TABLES[static_cast<uint32_t>(p)];
+}
+
+static_assert(coherenceTable(CoherenceProtocol::MESI).at(LineState::M, CoherenceEvent::BusRd).next == LineState::S);
+static_assert(coherenceTable(CoherenceProtocol::MOESI).at(LineState::M, CoherenceEvent::BusRd).next == LineState::O);
+static_assert(coherenceTable(CoherenceProtocol::MESIF).at(LineState::I, CoherenceEvent::Load).next_shared == LineState::F);
+static_assert(!coherenceTable(CoherenceProtocol::Dragon).at(LineState::E, CoherenceEvent::Store).issues);
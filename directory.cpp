@@ -0,0 +1,219 @@
+#include "directory.hpp"
+#include <stdexcept>
+
+DirectoryInterconnect::DirectoryInterconnect(const DirectoryConfig& cfg) : cfg_(cfg) {
+  if (cfg.homes == 0 || cfg.line_bytes == 0) {
+    throw std::invalid_argument("DirectoryInterconnect: homes y line_bytes deben ser > 0");
+  }
+  if (cfg.format != DirectoryFormat::FullMap && (cfg.pointers == 0 || cfg.pointers > MAX_POINTERS)) {
+    throw std::invalid_argument("DirectoryInterconnect: pointers debe estar entre 1 y 16");
+  }
+  if (cfg.format == DirectoryFormat::CoarseVector && cfg.group == 0) {
+    throw std::invalid_argument("DirectoryInterconnect: group debe ser > 0");
+  }
+  for (uint32_t i = 0; i < cfg.homes; ++i) homes_.push_back(std::make_unique<Home>());
+}
+
+void DirectoryInterconnect::attach(IBusClient* c) {
+  {
+    std::scoped_lock lk(mx_);
+    if (clientCount() >= MAX_NODES) {
+      throw std::out_of_range("DirectoryInterconnect: máximo 256 cachés");
+    }
+  }
+  Interconnect::attach(c);
+}
+
+void DirectoryInterconnect::addSharer(Entry& e, uint32_t node, Stats& st) const {
+  switch (cfg_.format) {
+    case DirectoryFormat::FullMap:
+      e.bits.set(node);
+      return;
+
+    case DirectoryFormat::LimitedPointer:
+    case DirectoryFormat::CoarseVector:
+      if (e.overflow) {
+        if (cfg_.format == DirectoryFormat::CoarseVector) e.bits.set(node / cfg_.group);
+        return;
+      }
+      for (uint32_t i = 0; i < e.count; ++i) if (e.ptr[i] == node) return;
+      if (e.count < cfg_.pointers) { e.ptr[e.count++] = static_cast<uint16_t>(node); return; }
+      // Desborde: los punteros pasan a broadcast o a bits de grupo
+      e.overflow = true;
+      st.overflows++;
+      if (cfg_.format == DirectoryFormat::CoarseVector) {
+        for (uint32_t i = 0; i < e.count; ++i) e.bits.set(e.ptr[i] / cfg_.group);
+        e.bits.set(node / cfg_.group);
+      }
+      e.count = 0;
+      return;
+  }
+}
+
+void DirectoryInterconnect::collectTargets(const Entry& e, uint32_t nodes, NodeList& out) const {
+  out.clear();
+  if (cfg_.format == DirectoryFormat::FullMap) {
+    for (uint32_t n = 0; n < nodes; ++n) if (e.bits.test(n)) out.push_back(n);
+    return;
+  }
+  if (!e.overflow) {
+    for (uint32_t i = 0; i < e.count; ++i) if (e.ptr[i] < nodes) out.push_back(e.ptr[i]);
+    return;
+  }
+  if (cfg_.format == DirectoryFormat::LimitedPointer) {
+    for (uint32_t n = 0; n < nodes; ++n) out.push_back(n);
+    return;
+  }
+  for (uint32_t n = 0; n < nodes; ++n) if (e.bits.test(n / cfg_.group)) out.push_back(n);
+}
+
+// Un BusRd va solo a las posibles responsables; un Flush no hace snoop.
+void DirectoryInterconnect::selectTargets(const Entry& e, BusMsg msg, uint32_t nodes, NodeList& out) const {
+  out.clear();
+  if (msg == BusMsg::BusRd) {
+    for (uint32_t i = 0; i < e.owners; ++i) out.push_back(e.owner[i]);
+  } else if (msg != BusMsg::Flush) {
+    collectTargets(e, nodes, out);
+  }
+}
+
+bool DirectoryInterconnect::othersPresent(const Entry& e, uint32_t src_id, uint32_t nodes) const {
+  switch (cfg_.format) {
+    case DirectoryFormat::FullMap:
+      return e.bits.count() > (src_id < nodes && e.bits.test(src_id) ? 1u : 0u);
+    case DirectoryFormat::LimitedPointer:
+    case DirectoryFormat::CoarseVector:
+      if (e.overflow) return true;
+      for (uint32_t i = 0; i < e.count; ++i) if (e.ptr[i] != src_id) return true;
+      return false;
+  }
+  return true;
+}
+
+SnoopResponse DirectoryInterconnect::broadcast(IBusClient* src, BusMsg msg, uint64_t base_addr, SnoopReply& reply) {
+  const uint64_t line = lineOf(base_addr);
+  Home& h = homeOf(line);
+
+  // El home serializa las transacciones de la línea mientras dura el snoop
+  std::scoped_lock hk(h.mx);
+  const ClientList& cl = clientList();
+  const uint32_t nodes = static_cast<uint32_t>(cl.clients.size());
+  uint32_t src_id = MAX_NODES;
+  if (auto it = cl.ids.find(src); it != cl.ids.end()) src_id = it->second;
+
+  Entry& e = h.lines[line];
+  h.stats.requests++;
+  if (e.overflow) h.stats.overflow_requests++;
+
+  // Solo se traducen a punteros los destinos, no la lista completa
+  NodeList ids;
+  selectTargets(e, msg, nodes, ids);
+  if (msg == BusMsg::BusRd && othersPresent(e, src_id, nodes)) { reply.shared = true; h.stats.shared_replies++; }
+
+  // Cada destino responde por separado para saber quién tenía la línea sucia
+  uint32_t dirty_node = MAX_NODES;
+  uint64_t sent = 0;
+  for (uint32_t n : ids) {
+    if (n == src_id) continue;
+    SnoopReply r = reply.request();
+    cl.clients[n]->snoop(msg, base_addr, r);
+    sent++;
+    reply.supplied |= r.supplied;
+    reply.shared |= r.shared;
+    reply.hit |= r.hit;
+    if (r.dirty) { reply.dirty = true; dirty_node = n; }
+  }
+  h.stats.messages += sent;
+  const uint64_t others = nodes - (src_id < nodes ? 1 : 0);
+  h.stats.avoided += others > sent ? others - sent : 0;
+
+  switch (msg) {
+    case BusMsg::BusRd: {
+      // El solicitante puede quedar en E o F; una dueña sucia puede seguir
+      // en O (MOESI). Las demás copias ya son S.
+      e.owners = 0;
+      if (src_id < nodes) { addSharer(e, src_id, h.stats); e.owner[e.owners++] = static_cast<uint16_t>(src_id); }
+      if (dirty_node < nodes) e.owner[e.owners++] = static_cast<uint16_t>(dirty_node);
+      break;
+    }
+    case BusMsg::BusUpd:
+      // Las copias siguen siendo válidas; el escritor pasa a ser el dueño
+      h.stats.updates += sent;
+      e.owners = 0;
+      if (src_id < nodes) { addSharer(e, src_id, h.stats); e.owner[e.owners++] = static_cast<uint16_t>(src_id); }
+      break;
+    case BusMsg::BusRdX:
+    case BusMsg::BusUpgr:
+    case BusMsg::Invalidate:
+      // Todas las demás copias quedaron invalidadas: solo el solicitante
+      h.stats.invalidations += sent;
+      e = Entry{};
+      if (src_id < nodes) { addSharer(e, src_id, h.stats); e.owner[e.owners++] = static_cast<uint16_t>(src_id); }
+      break;
+    case BusMsg::Flush:
+      break;
+  }
+  return reply.response();
+}
+
+std::vector<uint32_t> DirectoryInterconnect::sharers(uint64_t base_addr) const {
+  const uint64_t line = lineOf(base_addr);
+  const Home& h = homeOf(line);
+  const uint32_t nodes = static_cast<uint32_t>(clientCount());
+  NodeList out;
+  std::scoped_lock hk(h.mx);
+  if (auto it = h.lines.find(line); it != h.lines.end()) collectTargets(it->second, nodes, out);
+  return std::vector<uint32_t>(out.begin(), out.end());
+}
+
+DirectoryInterconnect::NodeList DirectoryInterconnect::snoopTargets(BusMsg msg, uint64_t base_addr) const {
+  const uint64_t line = lineOf(base_addr);
+  const Home& h = homeOf(line);
+  const uint32_t nodes = static_cast<uint32_t>(clientCount());
+  NodeList out;
+  std::scoped_lock hk(h.mx);
+  if (auto it = h.lines.find(line); it != h.lines.end()) selectTargets(it->second, msg, nodes, out);
+  return out;
+}
+
+DirectoryInterconnect::Stats DirectoryInterconnect::getStats() const {
+  Stats t;
+  for (const auto& h : homes_) {
+    std::scoped_lock hk(h->mx);
+    t.requests          += h->stats.requests;
+    t.messages          += h->stats.messages;
+    t.avoided           += h->stats.avoided;
+    t.invalidations     += h->stats.invalidations;
+    t.shared_replies    += h->stats.shared_replies;
+    t.updates           += h->stats.updates;
+    t.overflows         += h->stats.overflows;
+    t.overflow_requests += h->stats.overflow_requests;
+    t.entries           += h->lines.size();
+  }
+  return t;
+}
+
+void DirectoryInterconnect::resetStats() {
+  for (auto& h : homes_) {
+    std::scoped_lock hk(h->mx);
+    h->stats = Stats{};
+  }
+}
+
+void DirectoryInterconnect::dump(std::ostream& os) const {
+  const Stats st = getStats();
+  os << "Directory (" << directoryFormatName(cfg_.format);
+  if (cfg_.format != DirectoryFormat::FullMap) os << ", " << cfg_.pointers << " ptrs";
+  if (cfg_.format == DirectoryFormat::CoarseVector) os << ", grupo " << cfg_.group;
+  os << ", " << cfg_.homes << " homes)\n"
+     << "  requests=" << st.requests
+     << " messages=" << st.messages
+     << " avoided=" << st.avoided
+     << " inv=" << st.invalidations
+     << " sharedResp=" << st.shared_replies
+     << " upd=" << st.updates
+     << " overflows=" << st.overflows
+     << " ovfReq=" << st.overflow_requests
+     << " entries=" << st.entries
+     << "\n";
+}
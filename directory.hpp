@@ -0,0 +1,145 @@
+// directory.hpp
+// Coherencia por directorio como alternativa al broadcast de Interconnect.
+//
+// DirectoryInterconnect es un Interconnect: las cachés emiten las mismas
+// transacciones (BusRd, BusRdX, BusUpgr...) y el directorio las envía punto
+// a punto solo a las cachés que pueden tener la línea, en vez de hacer
+// snoop a todas:
+//
+//   DirectoryInterconnect dir(DirectoryConfig{DirectoryFormat::FullMap});
+//   c0.setBus(&dir);  dir.attach(&c0);
+//
+// Cada línea tiene un home node (línea % homes) que guarda su entrada; cada
+// home tiene su propio mutex y serializa las transacciones de sus líneas.
+//
+// Un BusRd no necesita a las copias S: solo se envía a las (a lo sumo dos)
+// posibles responsables de la línea (E/M/O/F) y el directorio mismo levanta
+// la señal shared si hay otros poseedores. BusRdX/BusUpgr/Invalidate y los
+// BusUpd de los protocolos de actualización se envían a todos los
+// poseedores registrados.
+//
+// Formatos de la entrada:
+//   FullMap        -> un bit por caché (hasta MAX_NODES). Exacto.
+//   LimitedPointer -> `pointers` ids exactos; al desbordar la entrada pasa a
+//                     broadcast hasta la siguiente invalidación (Dir_i B).
+//   CoarseVector   -> `pointers` ids exactos; al desbordar cada bit cubre un
+//                     grupo de `group` cachés consecutivas (Dir_i CV_r).
+//
+// El directorio solo registra presencia: los desalojos de las L1 son
+// silenciosos, así que una entrada puede incluir cachés que ya no tienen la
+// línea. Eso solo cuesta snoops de más (o un llenado en S en lugar de E);
+// nunca se omite a un poseedor real.
+//
+// Una transacción no reserva memoria dinámica: los destinos se arman en un
+// NodeList de capacidad fija. Solo la primera transacción sobre una línea
+// crea su entrada en el home.
+
+#pragma once
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+#include "interconnect.hpp"
+
+enum class DirectoryFormat : uint8_t { FullMap = 0, LimitedPointer, CoarseVector };
+
+inline const char* directoryFormatName(DirectoryFormat f) {
+  switch (f) {
+    case DirectoryFormat::FullMap:        return "FullMap";
+    case DirectoryFormat::LimitedPointer: return "LimitedPtr";
+    case DirectoryFormat::CoarseVector:   return "CoarseVec";
+  }
+  return "?";
+}
+
+struct DirectoryConfig {
+  DirectoryFormat format = DirectoryFormat::FullMap;
+  uint32_t pointers   = 4;   // LimitedPointer/CoarseVector: ids exactos por línea
+  uint32_t group      = 4;   // CoarseVector: cachés por bit tras desbordar
+  uint32_t homes      = 16;  // home nodes (rebanadas con lock propio)
+  uint32_t line_bytes = 32;
+};
+
+class DirectoryInterconnect : public Interconnect {
+public:
+  static constexpr uint32_t MAX_NODES    = 256;
+  static constexpr uint32_t MAX_POINTERS = 16;
+
+  /// Lista de ids de capacidad fija (MAX_NODES), sin memoria dinámica.
+  class NodeList {
+  public:
+    void clear() { n_ = 0; }
+    void push_back(uint32_t id) { id_[n_++] = static_cast<uint16_t>(id); }
+    uint32_t size() const { return n_; }
+    bool empty() const { return n_ == 0; }
+    const uint16_t* begin() const { return id_.data(); }
+    const uint16_t* end() const { return id_.data() + n_; }
+
+  private:
+    std::array<uint16_t, MAX_NODES> id_;  // solo [0, n_) es válido
+    uint32_t n_ = 0;
+  };
+
+  struct Stats {
+    uint64_t requests          = 0;  // transacciones recibidas
+    uint64_t messages          = 0;  // snoops punto a punto enviados
+    uint64_t avoided           = 0;  // snoops que un broadcast habría hecho de más
+    uint64_t invalidations     = 0;  // mensajes de BusRdX/BusUpgr/Invalidate
+    uint64_t shared_replies    = 0;  // BusRd respondidos "shared" por el directorio
+    uint64_t updates           = 0;  // mensajes de BusUpd (una palabra cada uno)
+    uint64_t overflows         = 0;  // entradas que desbordaron sus punteros
+    uint64_t overflow_requests = 0;  // transacciones sobre entradas desbordadas
+    uint64_t entries           = 0;  // líneas con entrada (se arma en getStats())
+  };
+
+  explicit DirectoryInterconnect(const DirectoryConfig& cfg = {});
+
+  void attach(IBusClient* c) override;
+  using Interconnect::broadcast;
+  SnoopResponse broadcast(IBusClient* src, BusMsg msg, uint64_t base_addr, SnoopReply& reply) override;
+
+  Stats getStats() const;
+  void resetStats();
+  void dump(std::ostream& os) const;
+  const DirectoryConfig& config() const { return cfg_; }
+
+  /// Ids de las cachés a las que se enviaría un snoop de esta línea.
+  std::vector<uint32_t> sharers(uint64_t base_addr) const;
+  /// Ids a los que iría el snoop de `msg` sobre esta línea si se emitiera
+  /// ahora (puede incluir al emisor, que broadcast() descarta).
+  NodeList snoopTargets(BusMsg msg, uint64_t base_addr) const;
+
+private:
+  struct Entry {
+    std::bitset<MAX_NODES> bits;              // FullMap, o grupos en CoarseVector desbordado
+    std::array<uint16_t, MAX_POINTERS> ptr{};
+    uint8_t count    = 0;
+    bool    overflow = false;
+    // Posibles responsables de la línea (E/M/O/F). Tras un BusRd pueden ser
+    // dos: el solicitante (E o F) y una dueña sucia que siga en O.
+    std::array<uint16_t, 2> owner{};
+    uint8_t owners = 0;
+  };
+
+  struct Home {
+    mutable std::mutex mx;
+    std::unordered_map<uint64_t, Entry> lines;  // clave: número de línea
+    Stats stats;
+  };
+
+  uint64_t lineOf(uint64_t addr) const { return addr / cfg_.line_bytes; }
+  Home& homeOf(uint64_t line) { return *homes_[line % cfg_.homes]; }
+  const Home& homeOf(uint64_t line) const { return *homes_[line % cfg_.homes]; }
+
+  void addSharer(Entry& e, uint32_t node, Stats& st) const;
+  void collectTargets(const Entry& e, uint32_t nodes, NodeList& out) const;
+  void selectTargets(const Entry& e, BusMsg msg, uint32_t nodes, NodeList& out) const;
+  bool othersPresent(const Entry& e, uint32_t src_id, uint32_t nodes) const;
+
+  DirectoryConfig cfg_;
+  std::vector<std::unique_ptr<Home>> homes_;
+};
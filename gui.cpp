@@ -8,6 +8,7 @@
 #include "cache.hpp"
 #include "processing_element.hpp"
 #include "interconnect.hpp"
+#include "split_bus.hpp"
 
 #include <FL/fl_draw.H>
 #include <FL/fl_ask.H>
@@ -49,6 +50,8 @@ void CacheLineWidget::draw() {
         case 3: bg_color = BG_MODIFIED; break;
         case 2: bg_color = BG_EXCLUSIVE; break;
         case 1: bg_color = BG_SHARED; break;
+        case 4: bg_color = BG_OWNED; break;
+        case 5: bg_color = BG_FORWARD; break;
         default: bg_color = BG_INVALID; break;
     }
     
@@ -67,7 +70,7 @@ void CacheLineWidget::draw() {
     if (valid_) {
         oss << "T:0x" << std::hex << std::setfill('0') << std::setw(4) << tag_ << " ";
         
-        const char* mesi_names[] = {"I", "S", "E", "M"};
+        const char* mesi_names[] = {"I", "S", "E", "M", "O", "F"};
         oss << mesi_names[mesi_state_] << " ";
         
         oss << (dirty_ ? "D" : "-") << " ";
@@ -236,7 +239,7 @@ void CacheStatsWidget::draw() {
     oss.str(""); oss << "BusRdX: " << bus_rdx_;
     draw_line(oss.str());
     
-    oss.str(""); oss << "BusInv: " << bus_inv_;
+    oss.str(""); oss << "BusUpgr/Inv: " << bus_inv_;
     draw_line(oss.str());
     
     ypos += 5;
@@ -583,7 +586,7 @@ void MESISimulatorGUI::updateStatsDisplay() {
                 stats.writebacks,
                 stats.bus_rd,
                 stats.bus_rdx,
-                stats.bus_inv,
+                stats.bus_inv + stats.bus_upgr,
                 stats.snoop_to_I,
                 stats.snoop_to_S,
                 stats.snoop_flush
@@ -646,10 +649,12 @@ void MESISimulatorGUI::stepAllPEs() {
             try {
                 pes_[pe_id]->executeNextInstruction();
                 
-                std::ostringstream oss;
-                oss << "[Step " << (global_step_count_ + 1) << "] PE" << pe_id 
-                    << " ejecutó instrucción (PC=" << pes_[pe_id]->getPC() << ")";
-                logBusMessage(oss.str());
+                if constexpr (logEnabled(LogLevel::Trace)) {
+                    std::ostringstream oss;
+                    oss << "[Step " << (global_step_count_ + 1) << "] PE" << pe_id 
+                        << " ejecutó instrucción (PC=" << pes_[pe_id]->getPC() << ")";
+                    logBusMessage(oss.str());
+                }
                 
                 global_step_count_++;
                 executed_something = true;
@@ -781,6 +786,9 @@ void MESISimulatorGUI::resetSystem() {
     if (memoria_) {
         memoria_->resetStats();
     }
+    if (bus_) {
+        bus_->resetTiming();
+    }
     
     system_loaded_ = false;
     global_step_count_ = 0;
@@ -867,7 +875,8 @@ void MESISimulatorGUI::loadSystem() {
         adapter_ = std::make_unique<MainMemoryAdapter>(*memoria_);
         logBusMessage("Memory adapter created");
         
-        bus_ = std::make_unique<Interconnect>();
+        // Bus partido: en Run All los 4 hilos compiten por él con un orden global
+        bus_ = std::make_unique<SplitTransactionBus>();
         logBusMessage("Interconnect (bus) created");
         Fl::check();
         
@@ -1198,6 +1207,20 @@ void MESISimulatorGUI::runAll() {
     
     logBusMessage("=== Execution completed ===");
     logBusMessage("All caches flushed.");
+
+    {
+        std::vector<const ProcessingElement*> pes;
+        for (int i = 0; i < 4; i++) {
+            if (pes_[i]) pes.push_back(pes_[i].get());
+        }
+        std::ostringstream report;
+        makeRunReport(pes, bus_.get()).print(report);
+        if (auto* split = dynamic_cast<SplitTransactionBus*>(bus_.get())) split->dump(report);
+        std::istringstream lines(report.str());
+        for (std::string line; std::getline(lines, line);) {
+            logBusMessage(line);
+        }
+    }
     
     try {
         double partial_sums[4];
@@ -40,6 +40,8 @@ public:
     static constexpr Fl_Color BG_MODIFIED = FL_RED;
     static constexpr Fl_Color BG_EXCLUSIVE = FL_BLUE;
     static constexpr Fl_Color BG_SHARED = FL_GREEN;
+    static constexpr Fl_Color BG_OWNED = FL_MAGENTA;
+    static constexpr Fl_Color BG_FORWARD = FL_CYAN;
     static constexpr Fl_Color BG_INVALID = FL_GRAY;
 
     CacheLineWidget(int x, int y, int w, int h, const char* label = nullptr);
@@ -1,41 +1,268 @@
 #pragma once
+#include <atomic>
 #include <vector>
 #include <mutex>
+#include <memory>
 #include <cstdint>
+#include <unordered_map>
+#include "snoop_filter.hpp"
+#include "migratory.hpp"
+#include "timing.hpp"
 
-enum class BusMsg { BusRd, BusRdX, Invalidate, Flush };
+// BusUpgr: upgrade S/O/F -> M de quien ya tiene la línea; solo dirección.
+// BusUpd: actualización de una palabra en las demás copias (Dragon/Firefly).
+enum class BusMsg { BusRd, BusRdX, Invalidate, Flush, BusUpgr, BusUpd };
+
+/// Costo de un mensaje en el bus. Todos ocupan la fase de dirección; los
+/// que mueven una línea (BusRd, BusRdX, Flush) agregan la fase de datos,
+/// de line_bytes / data_bytes_per_cycle ciclos, y BusUpd la de una palabra.
+struct BusCost {
+  static constexpr uint32_t WORD_BYTES = 8;
+
+  uint32_t addr_cycles = 1;
+  uint32_t addr_bytes = 8;
+  uint32_t data_bytes_per_cycle = 8;
+
+  static bool carriesData(BusMsg m) {
+    return m == BusMsg::BusRd || m == BusMsg::BusRdX || m == BusMsg::Flush;
+  }
+  static uint32_t payload(BusMsg m, uint32_t line_bytes) {
+    return carriesData(m) ? line_bytes : m == BusMsg::BusUpd ? WORD_BYTES : 0;
+  }
+  uint32_t cycles(BusMsg m, uint32_t line_bytes) const {
+    const uint32_t p = payload(m, line_bytes);
+    return addr_cycles + (p + data_bytes_per_cycle - 1) / data_bytes_per_cycle;
+  }
+  uint32_t bytes(BusMsg m, uint32_t line_bytes) const {
+    return addr_bytes + payload(m, line_bytes);
+  }
+};
+
+/// Respuesta agregada del bus, como las líneas shared/dirty de un bus real.
+enum class SnoopResponse : uint8_t { None = 0, Shared, Dirty };
+
+/// Respuesta de los snoopers a una transacción. El solicitante presta un
+/// buffer de `bytes` bytes; la caché con la copia sucia (o la responsable
+/// F en MESIF) copia ahí la línea y el solicitante no lee memoria.
+/// En un BusUpd el buffer es la palabra escrita y `offset` su posición en
+/// la línea; los snoopers la copian en su propia copia.
+/// `shared` y `dirty` son OR cableados: cada snooper solo los enciende.
+struct SnoopReply {
+  uint8_t* data = nullptr;
+  uint32_t bytes = 0;
+  bool supplied = false;  // alguna caché entregó la línea
+  bool shared = false;    // alguna caché conserva una copia válida
+  bool dirty = false;     // alguna caché tenía la línea sucia (M/O)
+  bool hit = false;       // alguna caché tenía la línea (cualquier mensaje)
+  uint32_t offset = 0;    // BusUpd: byte de la línea donde va la palabra
+  bool exclusive_ok = false;  // solicitante: BusRd de demanda que acepta la línea en exclusiva
+  bool migratory = false;     // el bus sirvió el BusRd en exclusiva (ver MigratoryDetector)
+  bool grant_unused = false;  // un snooper recibió la línea en exclusiva y aún no la escribió
+  bool hold = false;          // solicitante: llamará a Interconnect::complete() tras usar la respuesta
+
+  SnoopResponse response() const {
+    return dirty ? SnoopResponse::Dirty : shared ? SnoopResponse::Shared : SnoopResponse::None;
+  }
+  /// Misma petición (buffer y palabra) con las señales en cero, para
+  /// consultar a un solo snooper.
+  SnoopReply request() const {
+    SnoopReply r{ data, bytes };
+    r.offset = offset;
+    return r;
+  }
+};
 
 class IBusClient {
 public:
   virtual ~IBusClient() = default;
-  virtual void snoop(BusMsg msg, uint64_t base_addr) = 0;
+  virtual void snoop(BusMsg msg, uint64_t base_addr, SnoopReply& reply) = 0;
+};
+
+/// Ventana del bus que obtiene un mensaje en el tiempo simulado: `start` es
+/// el inicio de su fase de dirección y `done` el ciclo en que el
+/// solicitante tiene la respuesta (y los datos, si los hay).
+struct BusGrant {
+  uint64_t start;
+  uint64_t done;
 };
 
+/// Mensaje que pide tiempo en la interconexión (ver reserveBus()). Un bus
+/// usa los ciclos de cada fase; una red con enlaces propios (RingInterconnect)
+/// usa los bytes y las posiciones del solicitante y de la línea.
+struct BusTransfer {
+  IBusClient* src;
+  BusMsg msg;
+  uint64_t base_addr;
+  uint64_t ready;         // ciclo en que el solicitante emite el mensaje
+  uint32_t addr_cycles;   // BusCost o TimingConfig::msg_cycles
+  uint32_t data_cycles;
+  uint32_t addr_bytes;
+  uint32_t data_bytes;
+  uint32_t snoop_cycles;
+};
+
+/// Bus de snooping: cada transacción se difunde a todas las cachés, o solo
+/// a las posibles poseedoras si hay un SnoopFilter (setSnoopFilter()). Con
+/// setMigratoryDetection() las lecturas de líneas migratorias se sirven en
+/// exclusiva. La ocupación en el tiempo simulado se lleva en un BusTimeline
+/// (ver timing.hpp).
+/// attach() y broadcast() son virtuales para que otros motores de
+/// coherencia (p. ej. DirectoryInterconnect) u otros buses (SplitTransactionBus)
+/// se conecten detrás de la misma ruta de las cachés.
+///
+/// La lista de clientes se publica como una instantánea inmutable
+/// (ClientList): attach() arma una nueva bajo mx_ y la publica con un
+/// puntero atómico; broadcast() la lee sin lock y sin copiarla. Las
+/// instantáneas viejas se liberan con el bus, porque un snoop en curso
+/// puede seguir recorriéndolas (attach() es de configuración: son pocas).
+/// El BusCost se publica igual: cost() lo lee en cada mensaje sin mx_.
 class Interconnect {
 public:
-  void attach(IBusClient* c) {
+  /// Clientes conectados e id de cada uno (orden de attach).
+  struct ClientList {
+    std::vector<IBusClient*> clients;
+    std::unordered_map<IBusClient*, uint32_t> ids;
+  };
+
+  Interconnect() : lists_(1) {
+    lists_[0] = std::make_unique<ClientList>();
+    current_.store(lists_[0].get(), std::memory_order_release);
+    setCost(BusCost{});
+  }
+  virtual ~Interconnect() = default;
+
+  virtual void attach(IBusClient* c) {
+    std::scoped_lock lk(mx_);
+    auto next = std::make_unique<ClientList>(clientList());
+    const uint32_t id = static_cast<uint32_t>(next->clients.size());
+    if (filter_) filter_->addClient(id);
+    next->ids[c] = id;
+    next->clients.push_back(c);
+    current_.store(next.get(), std::memory_order_release);
+    lists_.push_back(std::move(next));
+  }
+
+  /// Instantánea vigente; válida mientras viva el bus.
+  const ClientList& clientList() const { return *current_.load(std::memory_order_acquire); }
+  size_t clientCount() const { return clientList().clients.size(); }
+
+  /// Activa el filtro de snoops. Debe llamarse antes de la primera
+  /// transacción: el filtro no conoce las líneas que ya están en las cachés.
+  void setSnoopFilter(const SnoopFilterConfig& cfg) {
     std::scoped_lock lk(mx_);
-    clients_.push_back(c);
+    filter_ = std::make_unique<SnoopFilter>(cfg);
+    for (uint32_t i = 0; i < clientCount(); ++i) filter_->addClient(i);
   }
+  const SnoopFilter* snoopFilter() const { return filter_.get(); }
+
+  /// Activa la detección de líneas migratorias (ver migratory.hpp). Solo la
+  /// usa este bus; DirectoryInterconnect la ignora.
+  void setMigratoryDetection(const MigratoryConfig& cfg) {
+    std::scoped_lock lk(mx_);
+    migratory_ = std::make_unique<MigratoryDetector>(cfg);
+  }
+  const MigratoryDetector* migratoryDetector() const { return migratory_.get(); }
   
-  void broadcast(IBusClient* src, BusMsg msg, uint64_t base_addr) {
-    // Copiar lista de clientes bajo lock
-    std::vector<IBusClient*> targets;
-    {
-      std::scoped_lock lk(mx_);
-      targets = clients_;
-    }
-    
-    // Hacer broadcast SIN el mutex del bus
-    // Cada caché manejará su propio mutex internamente
-    for (auto* c : targets) {
+  void setCost(const BusCost& c) {
+    std::scoped_lock lk(mx_);
+    costs_.push_back(std::make_unique<const BusCost>(c));
+    cost_.store(costs_.back().get(), std::memory_order_release);
+  }
+  BusCost cost() const { return *cost_.load(std::memory_order_acquire); }
+
+  /// Reserva el bus para un mensaje. En este bus atómico las fases de
+  /// dirección y datos van seguidas y lo ocupan juntas; la respuesta de los
+  /// snoopers llega `snoop_cycles` después.
+  virtual BusGrant reserveBus(const BusTransfer& x) {
+    const uint32_t occupancy = x.addr_cycles + x.data_cycles;
+    const uint64_t start = timeline_.reserve(x.ready, occupancy);
+    return { start, start + occupancy + x.snoop_cycles };
+  }
+  virtual uint64_t busyCycles() const { return timeline_.busyCycles(); }
+  virtual void resetTiming() { timeline_.reset(); }
+
+  SnoopResponse broadcast(IBusClient* src, BusMsg msg, uint64_t base_addr) {
+    SnoopReply reply;
+    return broadcast(src, msg, base_addr, reply);
+  }
+
+  virtual SnoopResponse broadcast(IBusClient* src, BusMsg msg, uint64_t base_addr, SnoopReply& reply) {
+    if (migratory_) return migratoryBroadcast(src, msg, base_addr, reply);
+    return deliver(src, msg, base_addr, reply);
+  }
+
+  /// Fin de una transacción emitida con `reply.hold`: el solicitante ya
+  /// instaló la línea o su nuevo estado. Solo lo usa SplitTransactionBus.
+  virtual void complete(IBusClient* /*src*/, uint64_t /*base_addr*/) {}
+  
+protected:
+  mutable std::mutex mx_;  // configuración: attach(), filtro, costo
+  std::unique_ptr<SnoopFilter> filter_;
+  std::unique_ptr<MigratoryDetector> migratory_;
+  BusTimeline timeline_;
+
+private:
+  std::vector<std::unique_ptr<const ClientList>> lists_;  // todas las publicadas
+  std::atomic<const ClientList*> current_{ nullptr };
+  std::vector<std::unique_ptr<const BusCost>> costs_;  // todos los publicados
+  std::atomic<const BusCost*> cost_{ nullptr };
+
+  SnoopResponse deliver(IBusClient* src, BusMsg msg, uint64_t base_addr, SnoopReply& reply) {
+    if (filter_) return filteredBroadcast(src, msg, base_addr, reply);
+
+    // Sin el mutex del bus y sin copiar la lista: cada caché maneja su
+    // propio mutex internamente
+    for (auto* c : clientList().clients) {
       if (c != src) {
-        c->snoop(msg, base_addr);
+        c->snoop(msg, base_addr, reply);
       }
     }
+    return reply.response();
+  }
+
+  // Una lectura de demanda sobre una línea migratoria llega a los snoopers
+  // como BusRdX: entregan la línea y se invalidan.
+  SnoopResponse migratoryBroadcast(IBusClient* src, BusMsg msg, uint64_t base_addr, SnoopReply& reply) {
+    const uint64_t line = migratory_->lineOf(base_addr);
+    std::scoped_lock mk(migratory_->shardLock(line));
+    uint32_t src_id = MigratoryDetector::NONE;
+    const ClientList& cl = clientList();
+    if (auto it = cl.ids.find(src); it != cl.ids.end()) src_id = it->second;
+    const bool is_read = msg == BusMsg::BusRd && reply.exclusive_ok;
+    const bool is_write = msg == BusMsg::BusRdX || msg == BusMsg::BusUpgr || msg == BusMsg::BusUpd;
+    const bool grant = is_read && migratory_->shouldGrant(line);
+    deliver(src, grant ? BusMsg::BusRdX : msg, base_addr, reply);
+    reply.migratory = grant;
+    migratory_->observe(line, src_id, is_read, is_write, grant, reply.dirty && !reply.grant_unused);
+    return reply.response();
+  }
+
+  SnoopResponse filteredBroadcast(IBusClient* src, BusMsg msg, uint64_t base_addr, SnoopReply& reply) {
+    const uint64_t line = filter_->lineOf(base_addr);
+    std::scoped_lock sk(filter_->shardLock(line));
+    const ClientList& cl = clientList();
+    const std::vector<IBusClient*>& targets = cl.clients;
+    uint32_t src_id = SnoopFilter::MAX_CLIENTS;
+    if (auto it = cl.ids.find(src); it != cl.ids.end()) src_id = it->second;
+
+    SnoopFilter::Stats& st = filter_->shardStats(line);
+    st.transactions++;
+    const bool invalidating = msg == BusMsg::BusRdX || msg == BusMsg::BusUpgr || msg == BusMsg::Invalidate;
+    for (uint32_t i = 0; i < targets.size(); ++i) {
+      if (i == src_id) continue;
+      if (!filter_->mayHold(i, line)) { st.filtered++; continue; }
+      st.forwarded++;
+      SnoopReply r = reply.request();
+      targets[i]->snoop(msg, base_addr, r);
+      reply.supplied |= r.supplied;
+      reply.shared |= r.shared;
+      reply.dirty |= r.dirty;
+      reply.hit |= r.hit;
+      reply.grant_unused |= r.grant_unused;
+      if (invalidating && r.hit) filter_->remove(i, line);
+    }
+    // Quien ya tenía la línea (BusUpgr) fue registrado al obtenerla
+    if (src_id < targets.size() && (msg == BusMsg::BusRd || msg == BusMsg::BusRdX)) filter_->insert(src_id, line);
+    return reply.response();
   }
-  
-private:
-  std::mutex mx_;
-  std::vector<IBusClient*> clients_;
 };
\ No newline at end of file
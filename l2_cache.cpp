@@ -0,0 +1,277 @@
+#include "l2_cache.hpp"
+#include <cstring>
+#include <stdexcept>
+
+static bool isPow2(uint32_t v) { return v != 0 && (v & (v - 1)) == 0; }
+
+SharedL2::SharedL2(IMainMemory& next, const L2Config& cfg) : next_(next), cfg_(cfg) {
+  if (!isPow2(cfg.banks) || !isPow2(cfg.sets_per_bank) || !isPow2(cfg.line_bytes) ||
+      cfg.ways == 0 || cfg.line_bytes < 8) {
+    throw std::invalid_argument("SharedL2: bancos, sets y línea deben ser potencias de 2 (línea >= 8 B)");
+  }
+  line_shift_ = log2Exact(cfg.line_bytes);
+  bank_shift_ = log2Exact(cfg.banks);
+  for (uint32_t i = 0; i < cfg.banks; ++i) {
+    auto b = std::make_unique<Bank>();
+    b->lines.assign(static_cast<size_t>(cfg.sets_per_bank) * cfg.ways, Line{});
+    b->data.assign(static_cast<size_t>(cfg.sets_per_bank) * cfg.ways * cfg.line_bytes, 0);
+    banks_.push_back(std::move(b));
+  }
+}
+
+void SharedL2::attachL1(ICache* l1) {
+  if (l1->lineBytes() > cfg_.line_bytes) {
+    throw std::invalid_argument("SharedL2: la línea de la L1 no puede ser mayor que la de la L2");
+  }
+  if (cfg_.policy == InclusionPolicy::Exclusive && l1->lineBytes() != cfg_.line_bytes) {
+    throw std::invalid_argument("SharedL2: Exclusive requiere la misma línea en la L1 y en la L2");
+  }
+  std::scoped_lock lk(l1_mx_);
+  l1s_.push_back(l1);
+}
+
+void SharedL2::checkRange(uint64_t addr, uint32_t bytes) const {
+  if (bytes == 0 || lineOf(addr) != lineOf(addr + bytes - 1)) {
+    throw std::invalid_argument("SharedL2: la transferencia debe caer dentro de una línea de L2");
+  }
+}
+
+int SharedL2::find(const Bank& b, uint64_t line) const {
+  const uint32_t first = setOf(line) * cfg_.ways;
+  for (uint32_t w = 0; w < cfg_.ways; ++w) {
+    const Line& l = b.lines[first + w];
+    if (l.valid && l.line == line) return static_cast<int>(first + w);
+  }
+  return -1;
+}
+
+uint32_t SharedL2::victim(const Bank& b, uint32_t set) const {
+  const uint32_t first = set * cfg_.ways;
+  uint32_t v = first;
+  for (uint32_t w = 0; w < cfg_.ways; ++w) {
+    const Line& l = b.lines[first + w];
+    if (!l.valid) return first + w;
+    if (l.stamp < b.lines[v].stamp) v = first + w;
+  }
+  return v;
+}
+
+bool SharedL2::evict(Bank& b, uint32_t i) {
+  Line& l = b.lines[i];
+  if (!l.valid) return false;
+  const uint64_t base = l.line << line_shift_;
+  b.stats.evictions++;
+  if (l.dirty) {
+    next_.writeLine(base, dataOf(b, i), cfg_.line_bytes);
+    b.stats.writebacks++;
+    b.stats.mem_writes += cfg_.line_bytes / 8;
+  }
+  l.valid = false;
+  l.dirty = false;
+  if (cfg_.policy != InclusionPolicy::Inclusive) return false;
+  b.stats.back_invalidations++;
+  return true;
+}
+
+uint32_t SharedL2::allocate(Bank& b, uint64_t line, uint64_t* back_inv) {
+  const uint32_t i = victim(b, setOf(line));
+  const uint64_t base = b.lines[i].line << line_shift_;
+  if (evict(b, i) && back_inv) *back_inv = base;
+  Line& l = b.lines[i];
+  l.line  = line;
+  l.valid = true;
+  l.dirty = false;
+  l.stamp = ++b.tick;
+  return i;
+}
+
+void SharedL2::fetch(Bank& b, uint32_t i, uint64_t line) {
+  next_.readLine(line << line_shift_, dataOf(b, i), cfg_.line_bytes);
+  b.stats.fills++;
+  b.stats.mem_reads += cfg_.line_bytes / 8;
+}
+
+void SharedL2::backInvalidateL1s(uint64_t base) {
+  std::scoped_lock lk(l1_mx_);
+  for (ICache* c : l1s_) c->backInvalidate(base, cfg_.line_bytes);
+}
+
+void SharedL2::readLine(uint64_t addr, uint8_t* dst, uint32_t bytes) {
+  checkRange(addr, bytes);
+  const uint64_t line = lineOf(addr);
+  const uint32_t off = static_cast<uint32_t>(addr & (cfg_.line_bytes - 1));
+  Bank& b = bankOf(line);
+  std::unique_lock lk(b.mx);
+  b.stats.reads++;
+  b.accesses++;
+
+  int i = find(b, line);
+  if (i >= 0) {
+    b.stats.hits++;
+    std::memcpy(dst, dataOf(b, i) + off, bytes);
+    Line& l = b.lines[i];
+    l.stamp = ++b.tick;
+    // Exclusive: la línea completa sube a la L1 y sale de la L2
+    if (cfg_.policy == InclusionPolicy::Exclusive && bytes == cfg_.line_bytes) {
+      if (l.dirty) {
+        next_.writeLine(line << line_shift_, dataOf(b, i), cfg_.line_bytes);
+        b.stats.writebacks++;
+        b.stats.mem_writes += cfg_.line_bytes / 8;
+      }
+      l.valid = false;
+      l.dirty = false;
+    }
+    return;
+  }
+
+  b.stats.misses++;
+  if (cfg_.policy == InclusionPolicy::Exclusive) {
+    next_.readLine(addr, dst, bytes);
+    b.stats.mem_reads += bytes / 8;
+    return;
+  }
+  uint64_t back_inv = NO_LINE;
+  i = static_cast<int>(allocate(b, line, &back_inv));
+  fetch(b, i, line);
+  std::memcpy(dst, dataOf(b, i) + off, bytes);
+  lk.unlock();
+
+  // Inclusión: al devolver la línea pedida ninguna L1 conserva la víctima.
+  // Se invalida sin el mutex del banco, que una L1 puede estar esperando
+  // con el suyo tomado para escribir un writeback.
+  if (back_inv != NO_LINE) backInvalidateL1s(back_inv);
+}
+
+void SharedL2::writeLine(uint64_t addr, const uint8_t* src, uint32_t bytes) {
+  checkRange(addr, bytes);
+  const uint64_t line = lineOf(addr);
+  const uint32_t off = static_cast<uint32_t>(addr & (cfg_.line_bytes - 1));
+  Bank& b = bankOf(line);
+  std::scoped_lock lk(b.mx);
+  b.stats.writes++;
+  b.accesses++;
+
+  int i = find(b, line);
+  if (i >= 0) {
+    b.stats.hits++;
+  } else {
+    b.stats.misses++;
+    if (cfg_.policy == InclusionPolicy::Inclusive) {
+      // Solo ocurre durante una back-invalidation: la L1 escribe su copia
+      // sucia después de que la L2 desalojó la línea
+      next_.writeLine(addr, src, bytes);
+      b.stats.write_through++;
+      b.stats.mem_writes += bytes / 8;
+      return;
+    }
+    i = static_cast<int>(allocate(b, line));
+    if (bytes < cfg_.line_bytes) fetch(b, i, line);
+    b.stats.victim_fills++;
+  }
+  Line& l = b.lines[i];
+  std::memcpy(dataOf(b, i) + off, src, bytes);
+  l.dirty = true;
+  l.stamp = ++b.tick;
+}
+
+void SharedL2::evictClean(uint64_t addr, const uint8_t* src, uint32_t bytes) {
+  if (cfg_.policy != InclusionPolicy::Exclusive || bytes != cfg_.line_bytes) return;
+  const uint64_t line = lineOf(addr);
+  Bank& b = bankOf(line);
+  std::scoped_lock lk(b.mx);
+  b.accesses++;
+  int i = find(b, line);
+  if (i < 0) {
+    i = static_cast<int>(allocate(b, line));
+    std::memcpy(dataOf(b, i), src, bytes);
+    b.stats.victim_fills++;
+  }
+  b.lines[i].stamp = ++b.tick;
+}
+
+void SharedL2::read64(uint64_t addr, uint64_t& out) {
+  uint8_t buf[8];
+  readLine(addr, buf, 8);
+  std::memcpy(&out, buf, 8);
+}
+
+void SharedL2::write64(uint64_t addr, uint64_t value) {
+  uint8_t buf[8];
+  std::memcpy(buf, &value, 8);
+  writeLine(addr, buf, 8);
+}
+
+void SharedL2::flushAll() {
+  for (auto& bp : banks_) {
+    Bank& b = *bp;
+    std::scoped_lock lk(b.mx);
+    for (uint32_t i = 0; i < b.lines.size(); ++i) {
+      Line& l = b.lines[i];
+      if (l.valid && l.dirty) {
+        next_.writeLine(l.line << line_shift_, dataOf(b, i), cfg_.line_bytes);
+        b.stats.writebacks++;
+        b.stats.mem_writes += cfg_.line_bytes / 8;
+        l.dirty = false;
+      }
+    }
+  }
+}
+
+bool SharedL2::contains(uint64_t addr) const {
+  const uint64_t line = lineOf(addr);
+  const Bank& b = bankOf(line);
+  std::scoped_lock lk(b.mx);
+  return find(b, line) >= 0;
+}
+
+void SharedL2::resetStats() {
+  for (auto& b : banks_) {
+    std::scoped_lock lk(b->mx);
+    b->stats = Stats{};
+    b->accesses = 0;
+  }
+}
+
+SharedL2::Stats SharedL2::getStats() const {
+  Stats t;
+  for (const auto& b : banks_) {
+    std::scoped_lock lk(b->mx);
+    const Stats& s = b->stats;
+    t.reads += s.reads;
+    t.writes += s.writes;
+    t.hits += s.hits;
+    t.misses += s.misses;
+    t.fills += s.fills;
+    t.victim_fills += s.victim_fills;
+    t.evictions += s.evictions;
+    t.writebacks += s.writebacks;
+    t.write_through += s.write_through;
+    t.back_invalidations += s.back_invalidations;
+    t.mem_reads += s.mem_reads;
+    t.mem_writes += s.mem_writes;
+    t.bank_accesses.push_back(b->accesses);
+  }
+  return t;
+}
+
+void SharedL2::dump(std::ostream& os) const {
+  const Stats st = getStats();
+  os << "L2 " << inclusionName(cfg_.policy) << " (" << cfg_.banks << " bancos x " << cfg_.sets_per_bank
+     << " sets x " << cfg_.ways << " vías x " << cfg_.line_bytes << "B = " << cfg_.sizeBytes() << "B)\n";
+  os << "Stats: reads=" << st.reads
+     << " writes=" << st.writes
+     << " hits=" << st.hits
+     << " misses=" << st.misses
+     << " fills=" << st.fills
+     << " victimFills=" << st.victim_fills
+     << " evict=" << st.evictions
+     << " wbs=" << st.writebacks
+     << " wThrough=" << st.write_through
+     << " backInv=" << st.back_invalidations
+     << " memR=" << st.mem_reads
+     << " memW=" << st.mem_writes
+     << "\n";
+  os << "Accesos por banco:";
+  for (auto a : st.bank_accesses) os << " " << a;
+  os << "\n";
+}
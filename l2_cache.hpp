@@ -0,0 +1,140 @@
+// l2_cache.hpp
+// L2 / último nivel compartido entre las L1 y MainMemory.
+//
+// SharedL2 implementa IMainMemory, así que se conecta entre las L1 y el
+// MainMemoryAdapter sin cambiar nada más:
+//
+//   MainMemoryAdapter adapter(memoria);
+//   SharedL2 l2(adapter, L2Config{4, 16, 8, 32, InclusionPolicy::Inclusive});
+//   auto c0 = makeCache(cfg, l2);  l2.attachL1(c0.get());
+//
+// La L2 está dividida en bancos intercalados por línea; cada banco tiene su
+// propio mutex, de modo que L1 distintas que fallan en bancos distintos no
+// se serializan.
+//
+// Políticas de inclusión:
+//   Inclusive -> toda línea de una L1 está en la L2. Al desalojar una línea
+//                la L2 la invalida en las L1 (backInvalidate) antes de
+//                terminar el acceso que la desalojó.
+//   Exclusive -> una línea está en la L1 o en la L2, no en ambas: un hit de
+//                línea completa la sube a la L1 y la L2 se llena solo con las
+//                víctimas de las L1 (limpias vía evictClean, sucias vía
+//                writeLine).
+//   NINE      -> ni inclusiva ni exclusiva: se llena en cada miss y en cada
+//                writeback, sin back-invalidations.
+
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "cache.hpp"
+
+enum class InclusionPolicy : uint8_t { Inclusive = 0, Exclusive, NINE };
+
+inline const char* inclusionName(InclusionPolicy p) {
+  switch (p) {
+    case InclusionPolicy::Inclusive: return "Inclusive";
+    case InclusionPolicy::Exclusive: return "Exclusive";
+    case InclusionPolicy::NINE:      return "NINE";
+  }
+  return "?";
+}
+
+struct L2Config {
+  uint32_t banks         = 4;
+  uint32_t sets_per_bank = 16;
+  uint32_t ways          = 8;
+  uint32_t line_bytes    = 32;  // >= la línea de las L1; Exclusive exige la misma
+  InclusionPolicy policy = InclusionPolicy::Inclusive;
+
+  uint32_t sizeBytes() const { return banks * sets_per_bank * ways * line_bytes; }
+};
+
+class SharedL2 : public IMainMemory {
+public:
+  struct Stats {
+    uint64_t reads              = 0;  // readLine/read64 recibidos de las L1
+    uint64_t writes             = 0;  // writeLine/write64 (writebacks de las L1)
+    uint64_t hits               = 0;
+    uint64_t misses             = 0;
+    uint64_t fills              = 0;  // líneas traídas desde memoria
+    uint64_t victim_fills       = 0;  // líneas insertadas con víctimas de las L1 (Exclusive/NINE)
+    uint64_t evictions          = 0;
+    uint64_t writebacks         = 0;  // líneas sucias escritas a memoria
+    uint64_t write_through      = 0;  // escrituras que fallaron y fueron directo a memoria
+    uint64_t back_invalidations = 0;  // líneas invalidadas en las L1 (Inclusive)
+    uint64_t mem_reads          = 0;  // palabras leídas de memoria
+    uint64_t mem_writes         = 0;  // palabras escritas a memoria
+    std::vector<uint64_t> bank_accesses;  // accesos por banco
+
+    double hitRate() const { return hits + misses ? double(hits) / (hits + misses) : 0.0; }
+  };
+
+  SharedL2(IMainMemory& next, const L2Config& cfg);
+
+  /// Registra una L1 para recibir back-invalidations. Su línea no puede ser
+  /// mayor que la de la L2, y en Exclusive debe ser igual
+  /// (std::invalid_argument si no).
+  void attachL1(ICache* l1);
+
+  void read64(uint64_t addr, uint64_t& out) override;
+  void write64(uint64_t addr, uint64_t value) override;
+  void readLine(uint64_t addr, uint8_t* dst, uint32_t bytes) override;
+  void writeLine(uint64_t addr, const uint8_t* src, uint32_t bytes) override;
+  void evictClean(uint64_t addr, const uint8_t* src, uint32_t bytes) override;
+  bool contains(uint64_t addr, uint32_t bytes) const override { return next_.contains(addr, bytes); }
+
+  /// Escribe todas las líneas sucias a memoria (no invalida).
+  void flushAll();
+  void resetStats();
+  Stats getStats() const;
+  void dump(std::ostream& os) const;
+
+  const L2Config& config() const { return cfg_; }
+  bool contains(uint64_t addr) const;
+
+private:
+  struct Line {
+    uint64_t line  = 0;  // número de línea completo (addr / line_bytes)
+    uint64_t stamp = 0;  // LRU
+    bool     valid = false;
+    bool     dirty = false;
+  };
+
+  struct Bank {
+    mutable std::mutex mx;
+    std::vector<Line> lines;     // sets_per_bank * ways
+    std::vector<uint8_t> data;   // mismo orden que lines
+    uint64_t tick = 0;
+    uint64_t accesses = 0;
+    Stats stats;       // bank_accesses se arma en getStats()
+  };
+
+  uint64_t lineOf(uint64_t addr) const { return addr >> line_shift_; }
+  Bank& bankOf(uint64_t line) { return *banks_[line & (cfg_.banks - 1)]; }
+  const Bank& bankOf(uint64_t line) const { return *banks_[line & (cfg_.banks - 1)]; }
+  uint32_t setOf(uint64_t line) const { return static_cast<uint32_t>((line >> bank_shift_) & (cfg_.sets_per_bank - 1)); }
+  uint8_t* dataOf(Bank& b, uint32_t i) { return &b.data[static_cast<size_t>(i) * cfg_.line_bytes]; }
+
+  void checkRange(uint64_t addr, uint32_t bytes) const;
+  int find(const Bank& b, uint64_t line) const;
+  uint32_t victim(const Bank& b, uint32_t set) const;
+  static constexpr uint64_t NO_LINE = ~0ull;
+  // Desaloja la víctima y devuelve la entrada; en Inclusive deja en
+  // `back_inv` la dirección que las L1 deben invalidar.
+  uint32_t allocate(Bank& b, uint64_t line, uint64_t* back_inv = nullptr);
+  bool evict(Bank& b, uint32_t i);  // true si hay que back-invalidar
+  void backInvalidateL1s(uint64_t base);  // sin el mutex de ningún banco
+  void fetch(Bank& b, uint32_t i, uint64_t line);
+
+  IMainMemory& next_;
+  L2Config cfg_;
+  uint32_t line_shift_ = 0;
+  uint32_t bank_shift_ = 0;
+  std::vector<std::unique_ptr<Bank>> banks_;
+  std::mutex l1_mx_;
+  std::vector<ICache*> l1s_;
+};
@@ -0,0 +1,78 @@
+// line_buffer.hpp
+// Buffer pequeño y totalmente asociativo de líneas completas, fuera de los
+// sets de la caché (buffer de prefetch / stream buffers, victim cache).
+// Las entradas guardan su propio estado de coherencia para que la caché
+// pueda responder a los snoops también sobre ellas.
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+template <typename State>
+class LineBuffer {
+public:
+  struct Entry {
+    uint64_t base  = 0;
+    uint64_t stamp = 0;   // orden de inserción/uso (la víctima es el menor)
+    State    state{};
+    bool     valid = false;
+    bool     dirty = false;
+  };
+
+  void configure(uint32_t entries, uint32_t line_bytes) {
+    entries_.assign(entries, Entry{});
+    data_.assign(static_cast<size_t>(entries) * line_bytes, 0);
+    line_bytes_ = line_bytes;
+    tick_ = 0;
+  }
+
+  uint32_t capacity() const { return static_cast<uint32_t>(entries_.size()); }
+  bool empty() const { return entries_.empty(); }
+
+  int find(uint64_t base) const {
+    for (size_t i = 0; i < entries_.size(); ++i) {
+      if (entries_[i].valid && entries_[i].base == base) return static_cast<int>(i);
+    }
+    return -1;
+  }
+
+  Entry& entry(int i) { return entries_[i]; }
+  const Entry& entry(int i) const { return entries_[i]; }
+  uint8_t* data(int i) { return &data_[static_cast<size_t>(i) * line_bytes_]; }
+  const uint8_t* data(int i) const { return &data_[static_cast<size_t>(i) * line_bytes_]; }
+
+  /// Entrada a reemplazar: una inválida, o la de stamp más antiguo.
+  int victim() const {
+    int v = 0;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+      if (!entries_[i].valid) return static_cast<int>(i);
+      if (entries_[i].stamp < entries_[v].stamp) v = static_cast<int>(i);
+    }
+    return v;
+  }
+
+  /// Ocupa la entrada `i` (el llamador ya se ocupó de su contenido previo).
+  void fill(int i, uint64_t base, State st, bool dirty, const uint8_t* src) {
+    Entry& e = entries_[i];
+    e.base  = base;
+    e.state = st;
+    e.dirty = dirty;
+    e.valid = true;
+    e.stamp = ++tick_;
+    if (src) std::memcpy(data(i), src, line_bytes_);
+  }
+
+  void touch(int i) { entries_[i].stamp = ++tick_; }
+  void remove(int i) { entries_[i].valid = false; entries_[i].dirty = false; }
+
+  void clear() {
+    for (auto& e : entries_) { e.valid = false; e.dirty = false; }
+  }
+
+private:
+  std::vector<Entry> entries_;
+  std::vector<uint8_t> data_;
+  uint32_t line_bytes_ = 0;
+  uint64_t tick_ = 0;
+};
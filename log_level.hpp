@@ -0,0 +1,33 @@
+// log_level.hpp
+// Nivel de trazas elegido en tiempo de compilación.
+//
+//   MESI_LOG_LEVEL=0  Throughput: se elimina todo el código de eventos y
+//                     logs (barridos por lotes, benchmarks).
+//   MESI_LOG_LEVEL=1  Events: solo eventos estructurados (EventCallback),
+//                     sin formatear texto.
+//   MESI_LOG_LEVEL=2  Trace: trazas completas en texto para la GUI
+//                     (valor por defecto).
+//
+// Todas las unidades de un mismo binario deben compilarse con el mismo
+// nivel (make LOG_LEVEL=0 o -DMESI_LOG_LEVEL=0).
+
+#pragma once
+
+#ifndef MESI_LOG_LEVEL
+#define MESI_LOG_LEVEL 2
+#endif
+
+enum class LogLevel : int { Throughput = 0, Events = 1, Trace = 2 };
+
+inline constexpr LogLevel kLogLevel = static_cast<LogLevel>(MESI_LOG_LEVEL);
+
+constexpr bool logEnabled(LogLevel level) { return static_cast<int>(kLogLevel) >= static_cast<int>(level); }
+
+inline const char* logLevelName(LogLevel level) {
+  switch (level) {
+    case LogLevel::Throughput: return "Throughput";
+    case LogLevel::Events:     return "Events";
+    case LogLevel::Trace:      return "Trace";
+  }
+  return "?";
+}
@@ -1,7 +1,7 @@
 #include "main_memory.hpp"
 #include <cstring>
 
-MainMemory::MainMemory() : read_count(0), write_count(0) {
+MainMemory::MainMemory() : read_count(0), write_count(0), burst_reads(0), burst_writes(0) {
     memory.resize(MEM_SIZE_WORDS, 0);
 }
 
@@ -17,6 +17,15 @@ void MainMemory::checkBounds(uint64_t addr) const {
     }
 }
 
+void MainMemory::checkRange(uint64_t addr, uint32_t bytes) const {
+    if (addr % 8 != 0 || bytes % 8 != 0 || bytes == 0) {
+        throw std::runtime_error("Unaligned memory access");
+    }
+    if (!inRange(addr, bytes)) {
+        throw std::out_of_range("Memory address out of range");
+    }
+}
+
 void MainMemory::writeWord(uint64_t addr, uint64_t data) {
     checkAlignment(addr);
     checkBounds(addr);
@@ -35,6 +44,24 @@ uint64_t MainMemory::readWord(uint64_t addr) const {
     return memory[addr / 8];
 }
 
+void MainMemory::readLine(uint64_t addr, uint8_t* dst, uint32_t bytes) const {
+    checkRange(addr, bytes);
+
+    std::lock_guard<std::mutex> lock(mem_mutex);
+    std::memcpy(dst, &memory[addr / 8], bytes);
+    read_count += bytes / 8;
+    burst_reads++;
+}
+
+void MainMemory::writeLine(uint64_t addr, const uint8_t* src, uint32_t bytes) {
+    checkRange(addr, bytes);
+
+    std::lock_guard<std::mutex> lock(mem_mutex);
+    std::memcpy(&memory[addr / 8], src, bytes);
+    write_count += bytes / 8;
+    burst_writes++;
+}
+
 void MainMemory::writeDouble(uint64_t addr, double data) {
     uint64_t bits;
     std::memcpy(&bits, &data, sizeof(double));
@@ -51,4 +78,6 @@ double MainMemory::readDouble(uint64_t addr) const {
 void MainMemory::resetStats() {
     read_count = 0;
     write_count = 0;
+    burst_reads = 0;
+    burst_writes = 0;
 }
\ No newline at end of file
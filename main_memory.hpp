@@ -12,11 +12,14 @@ private:
     const uint64_t MEM_SIZE_WORDS = 512;
     mutable std::mutex mem_mutex;  // Para acceso thread-safe
     
-    mutable uint64_t read_count;
-    mutable uint64_t write_count;
+    mutable uint64_t read_count;   // palabras leídas
+    mutable uint64_t write_count;  // palabras escritas
+    mutable uint64_t burst_reads;  // transferencias de línea (readLine)
+    mutable uint64_t burst_writes; // transferencias de línea (writeLine)
 
     void checkAlignment(uint64_t addr) const;
     void checkBounds(uint64_t addr) const;
+    void checkRange(uint64_t addr, uint32_t bytes) const;
 
 public:
     MainMemory();
@@ -28,10 +31,20 @@ public:
     // Lectura/escritura de doubles
     void writeDouble(uint64_t addr, double data);
     double readDouble(uint64_t addr) const;
+
+    // Ráfagas de una línea completa: una verificación, un lock y un memcpy.
+    // `bytes` debe ser múltiplo de 8; cuenta bytes/8 palabras y una ráfaga.
+    void readLine(uint64_t addr, uint8_t* dst, uint32_t bytes) const;
+    void writeLine(uint64_t addr, const uint8_t* src, uint32_t bytes);
+
+    // ¿Cae [addr, addr + bytes) dentro de la memoria? (sin verificar alineación)
+    bool inRange(uint64_t addr, uint32_t bytes) const { return addr / 8 + bytes / 8 <= MEM_SIZE_WORDS; }
     
     // Estadísticas
     uint64_t getReadCount() const { return read_count; }
     uint64_t getWriteCount() const { return write_count; }
+    uint64_t getBurstReadCount() const { return burst_reads; }
+    uint64_t getBurstWriteCount() const { return burst_writes; }
     void resetStats();
 };
 
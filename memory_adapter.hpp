@@ -9,6 +9,9 @@ public:
   explicit MainMemoryAdapter(MainMemory& mem) : mem_(mem) {}
   void read64(uint64_t addr, uint64_t& out) override { out = mem_.readWord(addr); }
   void write64(uint64_t addr, uint64_t value) override { mem_.writeWord(addr, value); }
+  void readLine(uint64_t addr, uint8_t* dst, uint32_t bytes) override { mem_.readLine(addr, dst, bytes); }
+  void writeLine(uint64_t addr, const uint8_t* src, uint32_t bytes) override { mem_.writeLine(addr, src, bytes); }
+  bool contains(uint64_t addr, uint32_t bytes) const override { return mem_.inRange(addr, bytes); }
 private:
   MainMemory& mem_;
 };
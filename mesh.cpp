@@ -0,0 +1,237 @@
+#include "mesh.hpp"
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <stdexcept>
+
+static DirectoryConfig withHomes(DirectoryConfig dir, const MeshConfig& cfg) {
+  dir.homes = cfg.cols * cfg.rows;
+  return dir;
+}
+
+MeshInterconnect::MeshInterconnect(const MeshConfig& cfg, DirectoryConfig dir)
+    : DirectoryInterconnect(withHomes(dir, cfg)), cfg_(cfg) {
+  if (cfg.cols == 0 || cfg.rows == 0 || cfg.link_bytes_per_cycle == 0 || cfg.vcs == 0 || cfg.vc_depth == 0) {
+    throw std::invalid_argument("MeshInterconnect: cols, rows, link_bytes_per_cycle, vcs y vc_depth deben ser > 0");
+  }
+  for (uint32_t i = 0; i < tiles() * PORTS; ++i) links_.push_back(std::make_unique<BusTimeline>());
+  buffers_.resize(static_cast<size_t>(tiles()) * PORTS * cfg.vcs);
+  routers_.assign(tiles(), RouterStats{});
+}
+
+void MeshInterconnect::attach(IBusClient* c) {
+  {
+    std::scoped_lock lk(mx_);
+    if (clientCount() >= tiles()) {
+      throw std::out_of_range("MeshInterconnect: más cachés que tiles");
+    }
+  }
+  DirectoryInterconnect::attach(c);
+}
+
+uint32_t MeshInterconnect::hops(uint32_t from, uint32_t to) const {
+  const uint32_t dx = from % cfg_.cols > to % cfg_.cols ? from % cfg_.cols - to % cfg_.cols : to % cfg_.cols - from % cfg_.cols;
+  const uint32_t dy = from / cfg_.cols > to / cfg_.cols ? from / cfg_.cols - to / cfg_.cols : to / cfg_.cols - from / cfg_.cols;
+  return dx + dy;
+}
+
+uint32_t MeshInterconnect::neighbor(uint32_t tile, uint32_t port) const {
+  switch (port) {
+    case East:  return tile + 1;
+    case West:  return tile - 1;
+    case North: return tile - cfg_.cols;
+    default:    return tile + cfg_.cols;
+  }
+}
+
+// XY: primero corrige la columna y después la fila
+uint32_t MeshInterconnect::nextPort(uint32_t from, uint32_t to) const {
+  if (to % cfg_.cols > from % cfg_.cols) return East;
+  if (to % cfg_.cols < from % cfg_.cols) return West;
+  return to / cfg_.cols < from / cfg_.cols ? North : South;
+}
+
+std::vector<uint32_t> MeshInterconnect::route(uint32_t from, uint32_t to) const {
+  std::vector<uint32_t> path{ from };
+  for (uint32_t t = from; t != to;) path.push_back(t = neighbor(t, nextPort(t, to)));
+  return path;
+}
+
+uint64_t MeshInterconnect::VcBuffer::firstFit(uint64_t t, uint32_t k, uint32_t depth) const {
+  if (occupancy(t) + k <= depth) return t;
+  // Si no, cuando salga alguno de los paquetes que lo ocupan
+  std::array<uint64_t, MAX_STAYS> outs;
+  size_t n = 0;
+  for (const Stay& s : stays) if (s.out > t) outs[n++] = s.out;
+  std::sort(outs.begin(), outs.begin() + n);
+  for (size_t i = 0; i < n; ++i) if (occupancy(outs[i]) + k <= depth) return outs[i];
+  return n == 0 ? t : outs[n - 1];
+}
+
+uint64_t MeshInterconnect::send(uint32_t from, uint32_t to, uint32_t bytes, bool response, uint64_t t, uint64_t* first) {
+  if (first) *first = t;
+  if (from == to) return t;
+  net_.packets++;
+  const uint32_t flits = std::max<uint32_t>(1, (bytes + cfg_.link_bytes_per_cycle - 1) / cfg_.link_bytes_per_cycle);
+  const uint32_t k = std::min(flits, cfg_.vc_depth);  // créditos que ocupa el paquete
+
+  // Con 2 o más VCs, las peticiones usan la primera mitad y las respuestas la segunda
+  const uint32_t half = cfg_.vcs / 2;
+  const uint32_t vc_lo = cfg_.vcs < 2 ? 0 : response ? half : 0;
+  const uint32_t vc_hi = cfg_.vcs < 2 ? cfg_.vcs : response ? cfg_.vcs : half;
+
+  // El paquete deja el buffer donde espera y devuelve sus créditos
+  VcBuffer* held = nullptr;
+  auto leave = [&](uint32_t router, uint64_t out) {
+    VcBuffer::Stay& s = held->stays.back();
+    s.out = out;
+    routers_[router].buffer_cycles += static_cast<uint64_t>(k) * (out - s.in);
+  };
+
+  for (uint32_t cur = from; cur != to;) {
+    const uint32_t port = nextPort(cur, to);
+    const uint32_t nxt = neighbor(cur, port);
+
+    // VC del router siguiente que primero tiene k créditos libres cuando
+    // el enlace también lo está
+    BusTimeline& link = *links_[cur * PORTS + port];
+    VcBuffer* buf = nullptr;
+    uint64_t start = t;
+    for (uint64_t ready = t;;) {
+      uint64_t credit = UINT64_MAX;
+      for (uint32_t vc = vc_lo; vc < vc_hi; ++vc) {
+        VcBuffer& b = buffer(nxt, port ^ 1, vc);
+        const uint64_t c = b.firstFit(ready + cfg_.hop_cycles, k, cfg_.vc_depth);
+        if (c < credit) { credit = c; buf = &b; }
+      }
+      start = link.probe(credit - cfg_.hop_cycles, flits);
+      if (start == credit - cfg_.hop_cycles) break;
+      ready = start;
+    }
+    if (start > link.probe(t, flits)) { routers_[cur].credit_stalls++; net_.credit_stalls++; }
+    link.reserve(start, flits);
+    if (cur == from && first) *first = start;
+    if (held) leave(cur, start + flits);
+    routers_[cur].flits += flits;
+    net_.flits += flits;
+    net_.hops++;
+
+    t = start + cfg_.hop_cycles;
+    routers_[nxt].peak_occupancy = std::max(routers_[nxt].peak_occupancy, buf->occupancy(t) + k);
+    if (buf->stays.size() >= VcBuffer::MAX_STAYS) buf->stays.erase(buf->stays.begin());
+    buf->stays.push_back({ t, UINT64_MAX, k });  // hasta que salga
+    held = buf;
+    cur = nxt;
+  }
+
+  // Eyección en el destino: el último flit llega flits - 1 ciclos después
+  const uint64_t tail = t + flits - 1;
+  leave(to, tail + 1);
+  return tail;
+}
+
+BusGrant MeshInterconnect::reserveBus(const BusTransfer& x) {
+  const uint32_t home = homeTile(x.base_addr);
+  uint32_t s = home;  // un emisor no conectado se trata como local al home
+  const ClientList& cl = clientList();
+  if (auto it = cl.ids.find(x.src); it != cl.ids.end()) s = it->second;
+  const NodeList targets = snoopTargets(x.msg, x.base_addr);
+  const bool upd = x.msg == BusMsg::BusUpd;
+
+  std::scoped_lock lk(net_mx_);
+  // 1. Petición al home (un Flush termina al escribir la línea ahí)
+  uint64_t start;
+  const uint32_t req_bytes = x.addr_bytes + (x.msg == BusMsg::Flush || upd ? x.data_bytes : 0);
+  const uint64_t at_home = send(s, home, req_bytes, false, x.ready, &start);
+  if (x.msg == BusMsg::Flush) return { start, at_home };
+  const uint64_t looked_up = at_home + x.snoop_cycles;
+
+  // 2. Snoops punto a punto y acks de regreso al home
+  uint64_t acked = looked_up;
+  for (uint32_t n : targets) {
+    if (n == s) continue;
+    const uint64_t seen = send(home, n, x.addr_bytes + (upd ? x.data_bytes : 0), false, looked_up) + x.snoop_cycles;
+    acked = std::max(acked, send(n, home, x.addr_bytes, true, seen));
+  }
+
+  // 3. Datos (o ack) al solicitante
+  const uint32_t reply_bytes = BusCost::carriesData(x.msg) ? x.data_bytes : x.addr_bytes;
+  return { start, send(home, s, reply_bytes, true, acked) };
+}
+
+uint64_t MeshInterconnect::busyCycles() const {
+  uint64_t m = 0;
+  for (const auto& l : links_) m = std::max(m, l->busyCycles());
+  return m;
+}
+
+void MeshInterconnect::resetTiming() {
+  std::scoped_lock lk(net_mx_);
+  for (auto& l : links_) l->reset();
+  for (auto& b : buffers_) b.stays.clear();
+}
+
+std::vector<uint64_t> MeshInterconnect::linkBusyCycles() const {
+  std::vector<uint64_t> out;
+  out.reserve(links_.size());
+  for (const auto& l : links_) out.push_back(l->busyCycles());
+  return out;
+}
+
+std::vector<MeshInterconnect::RouterStats> MeshInterconnect::routerStats() const {
+  std::scoped_lock lk(net_mx_);
+  return routers_;
+}
+
+MeshInterconnect::NetStats MeshInterconnect::netStats() const {
+  std::scoped_lock lk(net_mx_);
+  return net_;
+}
+
+void MeshInterconnect::resetStats() {
+  DirectoryInterconnect::resetStats();
+  std::scoped_lock lk(net_mx_);
+  std::fill(routers_.begin(), routers_.end(), RouterStats{});
+  net_ = NetStats{};
+}
+
+void MeshInterconnect::dump(std::ostream& os, uint64_t total_cycles) const {
+  DirectoryInterconnect::dump(os);
+  const NetStats st = netStats();
+  os << "Mesh (" << cfg_.cols << "x" << cfg_.rows << ", " << cfg_.vcs << " VCs x " << cfg_.vc_depth
+     << " flits, hop=" << cfg_.hop_cycles << ", " << cfg_.link_bytes_per_cycle << " B/ciclo)\n"
+     << "  packets=" << st.packets
+     << " flits=" << st.flits
+     << " hops=" << st.hops
+     << " creditStalls=" << st.credit_stalls
+     << "\n";
+  if (total_cycles == 0) return;
+
+  const std::vector<uint64_t> busy = linkBusyCycles();
+  const std::vector<RouterStats> rs = routerStats();
+  const auto flags = os.flags();
+  const auto prec = os.precision();
+  os << std::fixed;
+  os << "  Enlace de salida más cargado por router (%):\n";
+  for (uint32_t r = 0; r < cfg_.rows; ++r) {
+    os << "   ";
+    for (uint32_t c = 0; c < cfg_.cols; ++c) {
+      const uint32_t t = r * cfg_.cols + c;
+      const uint64_t m = *std::max_element(busy.begin() + t * PORTS, busy.begin() + (t + 1) * PORTS);
+      os << std::setprecision(0) << std::setw(5) << 100.0 * m / total_cycles;
+    }
+    os << "\n";
+  }
+  os << "  Ocupación media de buffers por router (flits) / pico por VC:\n";
+  for (uint32_t r = 0; r < cfg_.rows; ++r) {
+    os << "   ";
+    for (uint32_t c = 0; c < cfg_.cols; ++c) {
+      const RouterStats& x = rs[r * cfg_.cols + c];
+      os << std::setprecision(1) << std::setw(6) << static_cast<double>(x.buffer_cycles) / total_cycles
+         << "/" << x.peak_occupancy;
+    }
+    os << "\n";
+  }
+  os.flags(flags);
+  os.precision(prec);
+}
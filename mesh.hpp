@@ -0,0 +1,135 @@
+// mesh.hpp
+// Malla 2D (network-on-chip) con routers, canales virtuales y control de
+// flujo por créditos, para estudios de 16 a 256 PEs.
+//
+// MeshInterconnect es un DirectoryInterconnect: la coherencia es la del
+// directorio, repartido en un home node por tile (línea % tiles), y la caché
+// i queda en el tile i (fila i / cols, columna i % cols).
+//
+//   MeshInterconnect mesh(MeshConfig{ 4, 4 });   // 4x4 tiles
+//   c0.setBus(&mesh);  mesh.attach(&c0);
+//
+// Tiempo (reserveBus()): cada mensaje es un paquete de flits de
+// `link_bytes_per_cycle` bytes que avanza con ruteo XY (primero la
+// columna, después la fila). Una transacción envía:
+//   1. solicitante -> home (dirección; también la línea de un Flush o la
+//      palabra de un BusUpd), y el directorio tarda `snoop_cycles`;
+//   2. home -> cada destino del snoop (snoopTargets()) y su ack de regreso;
+//   3. home -> solicitante con los datos, o un ack si el mensaje no los lleva.
+//
+// Cada router tiene 4 puertos de entrada (E, O, N, S) con `vcs` canales
+// virtuales de `vc_depth` flits. Un paquete solo avanza al siguiente router
+// cuando el VC elegido allí tiene créditos para sus flits (hasta vc_depth),
+// y los devuelve cuando sale de ese router. Como los enlaces, cada VC guarda
+// los intervalos [llegada, salida) de los paquetes y no solo el último: los
+// relojes de los PEs no avanzan juntos. Las peticiones y las respuestas
+// usan mitades distintas de los VCs (si hay al menos 2), como las clases de
+// mensaje que evitan el deadlock de protocolo. Los enlaces se reservan en
+// BusTimelines, así que la contención aparece por enlace y por buffer.
+//
+// Estadísticas por router: flits enviados, ocupación de buffers
+// (flits x ciclos), ocupación pico de un VC y esperas por créditos; por
+// enlace, ciclos ocupados. dump() las muestra como mapas de la malla.
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#include "directory.hpp"
+
+struct MeshConfig {
+  uint32_t cols                 = 4;
+  uint32_t rows                 = 4;
+  uint32_t hop_cycles           = 1;   // router + enlace por salto
+  uint32_t link_bytes_per_cycle = 16;  // un flit por ciclo y enlace
+  uint32_t vcs                  = 2;   // canales virtuales por puerto de entrada
+  uint32_t vc_depth             = 4;   // flits por canal virtual (créditos)
+};
+
+class MeshInterconnect : public DirectoryInterconnect {
+public:
+  enum Port : uint32_t { East = 0, West, North, South, PORTS };
+
+  struct RouterStats {
+    uint64_t flits          = 0;  // flits enviados por sus enlaces de salida
+    uint64_t buffer_cycles  = 0;  // flits x ciclos en sus buffers de entrada
+    uint32_t peak_occupancy = 0;  // máximo de flits en un VC a la vez
+    uint64_t credit_stalls  = 0;  // paquetes que esperaron créditos para salir
+  };
+
+  struct NetStats {
+    uint64_t packets       = 0;
+    uint64_t flits         = 0;  // flits x saltos
+    uint64_t hops          = 0;  // paquetes x saltos
+    uint64_t credit_stalls = 0;
+  };
+
+  /// `dir.homes` se reemplaza por cols x rows: un home por tile.
+  explicit MeshInterconnect(const MeshConfig& cfg = {}, DirectoryConfig dir = {});
+
+  /// Coloca la caché en el siguiente tile libre.
+  void attach(IBusClient* c) override;
+
+  BusGrant reserveBus(const BusTransfer& x) override;
+  /// Ocupación del enlace más cargado.
+  uint64_t busyCycles() const override;
+  void resetTiming() override;
+
+  uint32_t tiles() const { return cfg_.cols * cfg_.rows; }
+  uint32_t homeTile(uint64_t base_addr) const { return static_cast<uint32_t>(base_addr / config().line_bytes % tiles()); }
+  /// Saltos entre dos tiles (distancia Manhattan: XY es mínimo).
+  uint32_t hops(uint32_t from, uint32_t to) const;
+  /// Tiles que recorre el ruteo XY de `from` a `to`, ambos incluidos.
+  std::vector<uint32_t> route(uint32_t from, uint32_t to) const;
+
+  /// Ocupación de cada enlace de salida: [tile * PORTS + puerto]. Los
+  /// puertos del borde de la malla quedan en 0.
+  std::vector<uint64_t> linkBusyCycles() const;
+  std::vector<RouterStats> routerStats() const;
+  NetStats netStats() const;
+
+  /// Limpia también las estadísticas de la red.
+  void resetStats();
+  using DirectoryInterconnect::dump;
+  /// Directorio y red; con `total_cycles` > 0 también los mapas de
+  /// utilización de enlaces y ocupación de buffers por router.
+  void dump(std::ostream& os, uint64_t total_cycles) const;
+  const MeshConfig& meshConfig() const { return cfg_; }
+
+private:
+  // Paquetes que pasaron por un VC de entrada, con sus flits.
+  struct VcBuffer {
+    static constexpr size_t MAX_STAYS = 64;  // se olvidan los más viejos
+    struct Stay { uint64_t in, out; uint32_t flits; };
+    std::vector<Stay> stays;
+
+    uint32_t occupancy(uint64_t t) const {
+      uint32_t n = 0;
+      for (const Stay& s : stays) if (s.in <= t && t < s.out) n += s.flits;
+      return n;
+    }
+    // Primer ciclo >= t en que hay `k` créditos libres
+    uint64_t firstFit(uint64_t t, uint32_t k, uint32_t depth) const;
+  };
+
+  uint32_t neighbor(uint32_t tile, uint32_t port) const;
+  uint32_t nextPort(uint32_t from, uint32_t to) const;
+  VcBuffer& buffer(uint32_t tile, uint32_t port, uint32_t vc) {
+    return buffers_[(static_cast<size_t>(tile) * PORTS + port) * cfg_.vcs + vc];
+  }
+  // Envía un paquete de `bytes` de `from` a `to` a partir del ciclo `t`
+  // (con net_mx_ tomado); devuelve el ciclo en que llega su último flit.
+  // `first` recibe el inicio en el primer enlace.
+  uint64_t send(uint32_t from, uint32_t to, uint32_t bytes, bool response, uint64_t t, uint64_t* first = nullptr);
+
+  MeshConfig cfg_;
+  std::vector<std::unique_ptr<BusTimeline>> links_;  // PORTS por tile
+
+  // Créditos y estadísticas de la red
+  mutable std::mutex net_mx_;
+  std::vector<VcBuffer> buffers_;
+  std::vector<RouterStats> routers_;
+  NetStats net_;
+};
@@ -0,0 +1,169 @@
+// migratory.hpp
+// Detección de líneas migratorias para Interconnect (ver
+// Interconnect::setMigratoryDetection()).
+//
+// Una línea es migratoria cuando las cachés la leen y enseguida la escriben
+// por turnos (acumuladores, contadores protegidos por lock...). Con MESI
+// cada turno cuesta un BusRd que deja la línea en S y un BusUpgr. Una vez
+// detectado el patrón, el bus sirve los BusRd de demanda de esa línea en
+// exclusiva: los snoopers la reciben como BusRdX (la entregan e invalidan)
+// y el solicitante la llena en E, o en M si llegó sucia, así que su store
+// no necesita upgrade.
+//
+// Cada línea tiene un contador saturado (histéresis):
+//   +1  una caché escribe la línea que acaba de leer como única lectora y
+//       la escritura anterior fue de otra caché (lectura-escritura migratoria),
+//       o la caché que la recibió en exclusiva la escribió antes del
+//       siguiente lector.
+//   -1  se escribe una línea que leyeron varias cachés, o la que la recibió
+//       en exclusiva no la escribió.
+// Con el contador en `threshold` o más se conceden lecturas exclusivas.
+//
+// Las transacciones de líneas del mismo shard se serializan con el mutex del
+// shard, que Interconnect mantiene tomado mientras dura el snoop.
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+struct MigratoryConfig {
+  uint8_t  threshold  = 2;   // contador desde el que se conceden lecturas exclusivas
+  uint8_t  max_count  = 3;   // saturación del contador
+  uint32_t shards     = 16;
+  uint32_t line_bytes = 32;
+};
+
+class MigratoryDetector {
+public:
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  struct Stats {
+    uint64_t reads      = 0;  // BusRd de demanda observados
+    uint64_t grants     = 0;  // BusRd servidos en exclusiva
+    uint64_t promotions = 0;  // líneas que pasaron a migratorias
+    uint64_t demotions  = 0;  // líneas que dejaron de serlo
+  };
+
+  explicit MigratoryDetector(const MigratoryConfig& cfg) : cfg_(cfg) {
+    if (cfg.shards == 0 || cfg.line_bytes == 0) {
+      throw std::invalid_argument("MigratoryDetector: shards y line_bytes deben ser > 0");
+    }
+    if (cfg.threshold == 0 || cfg.threshold > cfg.max_count) {
+      throw std::invalid_argument("MigratoryDetector: threshold debe estar entre 1 y max_count");
+    }
+    for (uint32_t i = 0; i < cfg.shards; ++i) shards_.push_back(std::make_unique<Shard>());
+  }
+
+  const MigratoryConfig& config() const { return cfg_; }
+  uint64_t lineOf(uint64_t addr) const { return addr / cfg_.line_bytes; }
+  std::mutex& shardLock(uint64_t line) { return shardOf(line).mx; }
+
+  // Las dos operaciones siguientes se llaman con shardLock(line) tomado.
+
+  /// ¿Se sirve en exclusiva este BusRd de demanda?
+  bool shouldGrant(uint64_t line) const {
+    const auto& lines = shardOf(line).lines;
+    auto it = lines.find(line);
+    return it != lines.end() && it->second.count >= cfg_.threshold;
+  }
+
+  /// Actualiza el patrón de la línea con una transacción ya resuelta.
+  /// `is_read`: BusRd de demanda; `is_write`: BusRdX/BusUpgr/BusUpd.
+  /// `holder_wrote`: la caché que recibió la última lectura exclusiva
+  /// respondió con la línea sucia y escrita por ella (ver
+  /// SnoopReply::grant_unused).
+  void observe(uint64_t line, uint32_t src, bool is_read, bool is_write, bool granted, bool holder_wrote) {
+    Shard& s = shardOf(line);
+    if (!is_read && !is_write) return;
+    Entry& e = s.lines[line];
+    if (is_read) {
+      s.stats.reads++;
+      // ¿La caché que recibió la línea en exclusiva llegó a escribirla?
+      if (e.holder != NONE && e.holder != src) {
+        if (holder_wrote) { bump(e, s.stats, +1); e.last_writer = e.holder; }
+        else              { bump(e, s.stats, -1); }
+      }
+      e.holder = NONE;
+      if (granted) {
+        s.stats.grants++;
+        e.holder = src;
+        e.readers = 0;
+        return;
+      }
+      if (e.readers < UINT8_MAX) e.readers++;
+      e.last_reader = src;
+      return;
+    }
+    if (e.readers == 1 && e.last_reader == src && e.last_writer != NONE && e.last_writer != src) {
+      bump(e, s.stats, +1);
+    } else if (e.readers > 1) {
+      bump(e, s.stats, -1);
+    }
+    e.last_writer = src;
+    e.readers = 0;
+    e.holder = NONE;
+  }
+
+  Stats getStats() const {
+    Stats t;
+    for (const auto& s : shards_) {
+      std::scoped_lock lk(s->mx);
+      t.reads      += s->stats.reads;
+      t.grants     += s->stats.grants;
+      t.promotions += s->stats.promotions;
+      t.demotions  += s->stats.demotions;
+    }
+    return t;
+  }
+
+  void resetStats() {
+    for (auto& s : shards_) {
+      std::scoped_lock lk(s->mx);
+      s->stats = Stats{};
+    }
+  }
+
+  /// Líneas con el contador en el umbral o más.
+  uint64_t migratoryLines() const {
+    uint64_t n = 0;
+    for (const auto& s : shards_) {
+      std::scoped_lock lk(s->mx);
+      for (const auto& [line, e] : s->lines) n += e.count >= cfg_.threshold;
+    }
+    return n;
+  }
+
+private:
+  struct Entry {
+    uint32_t last_writer = NONE;
+    uint32_t last_reader = NONE;
+    uint32_t holder      = NONE;  // recibió la última lectura exclusiva
+    uint8_t  readers     = 0;     // lectores desde la última escritura
+    uint8_t  count       = 0;
+  };
+
+  struct Shard {
+    mutable std::mutex mx;
+    std::unordered_map<uint64_t, Entry> lines;
+    Stats stats;
+  };
+
+  void bump(Entry& e, Stats& st, int d) const {
+    const bool was = e.count >= cfg_.threshold;
+    if (d > 0 && e.count < cfg_.max_count) e.count++;
+    if (d < 0 && e.count > 0) e.count--;
+    const bool is = e.count >= cfg_.threshold;
+    if (is && !was) st.promotions++;
+    if (was && !is) st.demotions++;
+  }
+
+  Shard& shardOf(uint64_t line) { return *shards_[line % cfg_.shards]; }
+  const Shard& shardOf(uint64_t line) const { return *shards_[line % cfg_.shards]; }
+
+  MigratoryConfig cfg_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
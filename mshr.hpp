@@ -0,0 +1,86 @@
+// mshr.hpp
+// Archivo de registros MSHR (Miss Status Holding Registers) de una caché.
+//
+// El simulador completa cada llenado de forma funcional en el momento del
+// miss, pero el MSHR mantiene la línea "en vuelo" durante fill_latency
+// accesos de la caché. Mientras tanto:
+//   - un acceso a la misma línea es un miss secundario y se fusiona con la
+//     entrada existente (no genera otra transacción de bus),
+//   - los accesos a otras líneas con hit siguen adelante (hit-under-miss),
+//   - un miss nuevo con el archivo lleno detiene la caché hasta que se
+//     libere la entrada más antigua.
+// Con fill_latency = 0 (valor por defecto) la caché se comporta como una
+// caché bloqueante y todos los contadores de MSHR quedan en cero.
+
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+class MSHRFile {
+public:
+  struct Entry {
+    uint64_t base   = 0;
+    uint64_t ready  = 0;  // tick en el que el llenado se considera completo
+    uint32_t merged = 0;  // misses secundarios fusionados
+    bool     valid  = false;
+  };
+
+  explicit MSHRFile(uint32_t entries = 1, uint32_t fill_latency = 0) { configure(entries, fill_latency); }
+
+  void configure(uint32_t entries, uint32_t fill_latency) {
+    if (entries == 0) throw std::invalid_argument("MSHRFile: entries debe ser > 0");
+    entries_.assign(entries, Entry{});
+    fill_latency_ = fill_latency;
+    outstanding_ = 0;
+  }
+
+  uint32_t capacity() const { return static_cast<uint32_t>(entries_.size()); }
+  uint32_t fillLatency() const { return fill_latency_; }
+  uint32_t outstanding() const { return outstanding_; }
+  bool enabled() const { return fill_latency_ > 0; }
+  bool full() const { return outstanding_ == entries_.size(); }
+
+  /// Libera las entradas cuyo llenado terminó antes de `now`.
+  void retire(uint64_t now) {
+    if (outstanding_ == 0) return;
+    for (auto& e : entries_) {
+      if (e.valid && e.ready <= now) { e.valid = false; --outstanding_; }
+    }
+  }
+
+  Entry* find(uint64_t base) {
+    if (outstanding_ == 0) return nullptr;
+    for (auto& e : entries_) if (e.valid && e.base == base) return &e;
+    return nullptr;
+  }
+
+  /// Tick en el que se libera la primera entrada (solo con el archivo lleno).
+  uint64_t earliestReady() const {
+    uint64_t t = UINT64_MAX;
+    for (const auto& e : entries_) if (e.valid && e.ready < t) t = e.ready;
+    return t;
+  }
+
+  /// Reserva una entrada para `base`; el llamador garantiza que hay espacio.
+  void allocate(uint64_t base, uint64_t now) {
+    if (Entry* e = find(base)) { e->ready = now + fill_latency_; return; }
+    for (auto& e : entries_) {
+      if (!e.valid) {
+        e = Entry{ base, now + fill_latency_, 0, true };
+        ++outstanding_;
+        return;
+      }
+    }
+  }
+
+  void clear() {
+    for (auto& e : entries_) e.valid = false;
+    outstanding_ = 0;
+  }
+
+private:
+  std::vector<Entry> entries_;
+  uint32_t fill_latency_ = 0;
+  uint32_t outstanding_  = 0;
+};
@@ -0,0 +1,182 @@
+// prefetcher.hpp
+// Prefetchers de hardware que se conectan a una caché con setPrefetcher().
+//
+// La caché llama onAccess() en cada acceso de demanda; el prefetcher
+// devuelve direcciones base de línea candidatas y la caché las emite como
+// BusRd por el Interconnect (ver Cache::issuePrefetches).
+//
+//   NextLinePrefetcher   -> en cada miss (o hit sobre una línea traída por
+//                           prefetch) pide las `degree` líneas siguientes.
+//   StridePrefetcher     -> tabla de predicción indexada por el PC del PE;
+//                           con confianza suficiente pide addr + k*stride.
+//   StreamBufferPrefetcher -> `streams` flujos secuenciales de profundidad
+//                           `depth`; las líneas van a un buffer aparte de
+//                           la caché y solo entran a ella cuando se usan.
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+enum class PrefetcherKind : uint8_t { None = 0, NextLine, Stride, StreamBuffer };
+
+inline const char* prefetcherName(PrefetcherKind k) {
+  switch (k) {
+    case PrefetcherKind::None:         return "None";
+    case PrefetcherKind::NextLine:     return "NextLine";
+    case PrefetcherKind::Stride:       return "Stride";
+    case PrefetcherKind::StreamBuffer: return "StreamBuffer";
+  }
+  return "?";
+}
+
+struct PrefetchAccess {
+  uint64_t pc;            // PC de la instrucción LOAD/STORE (setAccessPC)
+  uint64_t addr;          // dirección de la palabra
+  uint64_t line_base;     // base de la línea accedida
+  bool     miss;          // miss de demanda
+  bool     prefetch_hit;  // el acceso usó una línea traída por prefetch
+};
+
+class IPrefetcher {
+public:
+  static constexpr uint32_t MAX_CANDIDATES = 16;
+
+  virtual ~IPrefetcher() = default;
+  virtual PrefetcherKind kind() const = 0;
+
+  /// Tamaño de línea de la caché a la que se conecta.
+  virtual void attach(uint32_t line_bytes) { line_bytes_ = line_bytes; }
+
+  /// Escribe hasta MAX_CANDIDATES bases de línea en `out`; devuelve cuántas.
+  virtual uint32_t onAccess(const PrefetchAccess& a, uint64_t* out) = 0;
+
+  /// Líneas de buffer propio que necesita (0 = llena directamente la caché).
+  virtual uint32_t bufferLines() const { return 0; }
+
+  virtual void reset() {}
+
+protected:
+  uint32_t line_bytes_ = 32;
+};
+
+class NextLinePrefetcher : public IPrefetcher {
+public:
+  explicit NextLinePrefetcher(uint32_t degree = 1) : degree_(degree < MAX_CANDIDATES ? degree : MAX_CANDIDATES) {}
+  PrefetcherKind kind() const override { return PrefetcherKind::NextLine; }
+
+  uint32_t onAccess(const PrefetchAccess& a, uint64_t* out) override {
+    if (!a.miss && !a.prefetch_hit) return 0;
+    for (uint32_t k = 0; k < degree_; ++k) out[k] = a.line_base + (k + 1) * line_bytes_;
+    return degree_;
+  }
+
+private:
+  uint32_t degree_;
+};
+
+class StridePrefetcher : public IPrefetcher {
+public:
+  explicit StridePrefetcher(uint32_t degree = 1, uint32_t table_entries = 16)
+    : degree_(degree < MAX_CANDIDATES ? degree : MAX_CANDIDATES), table_(table_entries) {
+    if (table_entries == 0) throw std::invalid_argument("StridePrefetcher: table_entries debe ser > 0");
+  }
+  PrefetcherKind kind() const override { return PrefetcherKind::Stride; }
+
+  uint32_t onAccess(const PrefetchAccess& a, uint64_t* out) override {
+    Entry& e = table_[a.pc % table_.size()];
+    if (!e.valid || e.pc != a.pc) {
+      e = Entry{ a.pc, a.addr, 0, 0, true };
+      return 0;
+    }
+    const int64_t stride = static_cast<int64_t>(a.addr - e.last_addr);
+    if (stride != 0 && stride == e.stride) {
+      if (e.confidence < 3) e.confidence++;
+    } else {
+      if (e.confidence > 0) e.confidence--;
+      if (e.confidence == 0) e.stride = stride;
+    }
+    e.last_addr = a.addr;
+    if (e.confidence < 2 || e.stride == 0) return 0;
+
+    // Pide las líneas de las próximas `degree` líneas distintas en la dirección del stride
+    uint32_t n = 0;
+    uint64_t last_line = a.line_base;
+    const uint64_t mask = ~static_cast<uint64_t>(line_bytes_ - 1);
+    for (uint32_t k = 1; n < degree_ && k <= degree_ * (line_bytes_ / 8 + 1); ++k) {
+      const uint64_t line = (a.addr + static_cast<uint64_t>(e.stride) * k) & mask;
+      if (line != last_line) { out[n++] = line; last_line = line; }
+    }
+    return n;
+  }
+
+  void reset() override { for (auto& e : table_) e = Entry{}; }
+
+private:
+  struct Entry {
+    uint64_t pc = 0;
+    uint64_t last_addr = 0;
+    int64_t  stride = 0;
+    uint8_t  confidence = 0;  // contador saturado de 2 bits
+    bool     valid = false;
+  };
+  uint32_t degree_;
+  std::vector<Entry> table_;
+};
+
+class StreamBufferPrefetcher : public IPrefetcher {
+public:
+  explicit StreamBufferPrefetcher(uint32_t streams = 2, uint32_t depth = 4)
+    : depth_(depth < MAX_CANDIDATES ? depth : MAX_CANDIDATES), streams_(streams) {
+    if (streams == 0) throw std::invalid_argument("StreamBufferPrefetcher: streams debe ser > 0");
+  }
+  PrefetcherKind kind() const override { return PrefetcherKind::StreamBuffer; }
+  uint32_t bufferLines() const override { return static_cast<uint32_t>(streams_.size()) * depth_; }
+
+  uint32_t onAccess(const PrefetchAccess& a, uint64_t* out) override {
+    if (a.prefetch_hit) {
+      // Avanza el flujo que contenía la línea: pide una más al final
+      for (auto& s : streams_) {
+        if (s.valid && a.line_base < s.next && a.line_base + depth_ * line_bytes_ >= s.next) {
+          s.stamp = ++tick_;
+          out[0] = s.next;
+          s.next += line_bytes_;
+          return 1;
+        }
+      }
+      return 0;
+    }
+    if (!a.miss) return 0;
+
+    // Miss en caché y en los buffers: reasigna el flujo menos usado
+    Stream* v = &streams_[0];
+    for (auto& s : streams_) if (!s.valid || s.stamp < v->stamp) { v = &s; if (!s.valid) break; }
+    for (uint32_t k = 0; k < depth_; ++k) out[k] = a.line_base + (k + 1) * line_bytes_;
+    *v = Stream{ a.line_base + (depth_ + 1) * line_bytes_, ++tick_, true };
+    return depth_;
+  }
+
+  void reset() override { for (auto& s : streams_) s = Stream{}; tick_ = 0; }
+
+private:
+  struct Stream {
+    uint64_t next  = 0;  // próxima línea que se pedirá para este flujo
+    uint64_t stamp = 0;
+    bool     valid = false;
+  };
+  uint32_t depth_;
+  std::vector<Stream> streams_;
+  uint64_t tick_ = 0;
+};
+
+/// `degree` = grado para NextLine/Stride, profundidad para StreamBuffer.
+inline std::unique_ptr<IPrefetcher> makePrefetcher(PrefetcherKind k, uint32_t degree = 2) {
+  switch (k) {
+    case PrefetcherKind::NextLine:     return std::make_unique<NextLinePrefetcher>(degree);
+    case PrefetcherKind::Stride:       return std::make_unique<StridePrefetcher>(degree);
+    case PrefetcherKind::StreamBuffer: return std::make_unique<StreamBufferPrefetcher>(2, degree);
+    case PrefetcherKind::None:         break;
+  }
+  return nullptr;
+}
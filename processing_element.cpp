@@ -1,6 +1,7 @@
 #include "processing_element.hpp"
 #include "cache.hpp"  // AQUÍ SÍ incluimos cache.hpp porque necesitamos la definición completa
 #include <cstring>
+#include <iomanip>
 #include <stdexcept>
 
 ProcessingElement::ProcessingElement(int id) 
@@ -21,6 +22,7 @@ void ProcessingElement::executeNextInstruction() {
     }
     
     Instruction& inst = program[pc];
+    instructions++;
     
     switch (inst.type) {
         case InstructionType::LOAD: {
@@ -29,7 +31,10 @@ void ProcessingElement::executeNextInstruction() {
             uint64_t addr = getRegister(inst.reg_src1);
             double value = 0.0;
 
+            cache_->setAccessPC(pc);
+            cache_->setClock(cycles);
             bool hit = cache_->loadDouble(addr, value);
+            cycles = cache_->clock();
             setRegisterDouble(inst.reg_dest, value);
             read_ops++;
             pc++;
@@ -42,7 +47,10 @@ void ProcessingElement::executeNextInstruction() {
             uint64_t addr = getRegister(inst.reg_src1);
             double value = getRegisterDouble(inst.reg_dest);
 
+            cache_->setAccessPC(pc);
+            cache_->setClock(cycles);
             bool hit = cache_->storeDouble(addr, value);
+            cycles = cache_->clock();
             write_ops++;
             pc++;
             break;
@@ -52,6 +60,7 @@ void ProcessingElement::executeNextInstruction() {
             double a = getRegisterDouble(inst.reg_src1);
             double b = getRegisterDouble(inst.reg_src2);
             setRegisterDouble(inst.reg_dest, a * b);
+            cycles += alu_cycles;
             pc++;
             break;
         }
@@ -60,23 +69,27 @@ void ProcessingElement::executeNextInstruction() {
             double a = getRegisterDouble(inst.reg_src1);
             double b = getRegisterDouble(inst.reg_src2);
             setRegisterDouble(inst.reg_dest, a + b);
+            cycles += alu_cycles;
             pc++;
             break;
         }
         
         case InstructionType::INC: {
             registers[inst.reg_dest]+= 8;
+            cycles += alu_cycles;
             pc++;
             break;
         }
         
         case InstructionType::DEC: {
             registers[inst.reg_dest]--;
+            cycles += alu_cycles;
             pc++;
             break;
         }
         
         case InstructionType::JNZ: {
+            cycles += alu_cycles;
             if (registers[inst.reg_dest] != 0) {
                 pc = inst.label;
             } else {
@@ -133,6 +146,13 @@ double ProcessingElement::getRegisterDouble(int reg_num) const {
 void ProcessingElement::resetStats() {
     read_ops = 0;
     write_ops = 0;
+    instructions = 0;
+    cycles = 0;
+}
+
+void ProcessingElement::setTiming(const TimingConfig& t) {
+    alu_cycles = t.alu_cycles;
+    if (cache_) cache_->setTiming(t);
 }
 
 // Implementación del método para obtener estado MESI
@@ -145,4 +165,32 @@ std::optional<int> ProcessingElement::getMESIStateAsInt(uint64_t addr) const {
         }
     }
     return std::nullopt;
-}
\ No newline at end of file
+}
+RunReport makeRunReport(const std::vector<const ProcessingElement*>& pes, const Interconnect* bus) {
+    RunReport r;
+    for (const ProcessingElement* pe : pes) {
+        const uint64_t wait = pe->getCache() ? pe->getCache()->getStats().bus_wait_cycles : 0;
+        r.pes.push_back({ pe->getPEId(), pe->getInstructions(), pe->getCycles(), wait, pe->getCPI() });
+        if (pe->getCycles() > r.total_cycles) r.total_cycles = pe->getCycles();
+    }
+    if (bus) r.bus_busy_cycles = bus->busyCycles();
+    return r;
+}
+
+void RunReport::print(std::ostream& os) const {
+    const auto flags = os.flags();
+    const auto prec = os.precision();
+    os << std::left << std::setw(6) << "PE" << std::right
+       << std::setw(10) << "instr" << std::setw(12) << "ciclos"
+       << std::setw(8) << "CPI" << std::setw(12) << "esperaBus" << "\n";
+    for (const auto& p : pes) {
+        os << std::left << std::setw(6) << ("PE" + std::to_string(p.id)) << std::right
+           << std::setw(10) << p.instructions << std::setw(12) << p.cycles
+           << std::setw(8) << std::fixed << std::setprecision(2) << p.cpi
+           << std::setw(12) << p.bus_wait_cycles << "\n";
+    }
+    os << "Total: " << total_cycles << " ciclos | bus ocupado " << bus_busy_cycles
+       << " ciclos (" << std::fixed << std::setprecision(1) << 100.0 * busUtilization() << "%)\n";
+    os.flags(flags);
+    os.precision(prec);
+}
@@ -5,9 +5,12 @@
 #include <vector>
 #include <string>
 #include <optional>
+#include <ostream>
+#include "timing.hpp"
 
 // Forward declaration - solo necesitamos esto porque usamos puntero
-class Cache2Way;
+class ICache;
+class Interconnect;
 
 // Tipos de instrucción según ISA especificado
 enum class InstructionType {
@@ -31,7 +34,7 @@ struct Instruction {
 
 class ProcessingElement {
 private:
-    Cache2Way* cache_ = nullptr;  // Puntero a la caché
+    ICache* cache_ = nullptr;  // Puntero a la caché (cualquier geometría)
     int pe_id;
     uint64_t registers[8];  // 8 registros de 64 bits (REG0-REG7)
     std::vector<Instruction> program;  // Programa cargado
@@ -40,6 +43,9 @@ private:
     // Estadísticas
     uint64_t read_ops;
     uint64_t write_ops;
+    uint64_t instructions = 0;  // instrucciones ejecutadas
+    uint64_t cycles = 0;        // reloj del PE en ciclos simulados (ver timing.hpp)
+    uint32_t alu_cycles = 1;
 
 public:
     ProcessingElement(int id);
@@ -63,10 +69,17 @@ public:
     // Estadísticas
     uint64_t getReadOps() const { return read_ops; }
     uint64_t getWriteOps() const { return write_ops; }
+    uint64_t getInstructions() const { return instructions; }
+    uint64_t getCycles() const { return cycles; }
+    double getCPI() const { return instructions ? double(cycles) / instructions : 0.0; }
     void resetStats();
+
+    // Latencias del modelo de tiempo; también se las pasa a la caché
+    void setTiming(const TimingConfig& t);
     
     // Métodos de acceso a la caché
-    void setCache(Cache2Way* c) { cache_ = c; }
+    void setCache(ICache* c) { cache_ = c; }
+    ICache* getCache() const { return cache_; }
     
     int getPEId() const { return pe_id; }
     
@@ -81,4 +94,24 @@ public:
     std::optional<int> getMESIStateAsInt(uint64_t addr) const;
 };
 
+// Resumen de tiempo de una corrida: ciclos y CPI de cada PE y utilización
+// del bus sobre el total (el reloj del PE que terminó último).
+struct RunReport {
+    struct PE {
+        int id;
+        uint64_t instructions;
+        uint64_t cycles;
+        uint64_t bus_wait_cycles;
+        double cpi;
+    };
+    std::vector<PE> pes;
+    uint64_t total_cycles = 0;
+    uint64_t bus_busy_cycles = 0;
+
+    double busUtilization() const { return total_cycles ? double(bus_busy_cycles) / total_cycles : 0.0; }
+    void print(std::ostream& os) const;
+};
+
+RunReport makeRunReport(const std::vector<const ProcessingElement*>& pes, const Interconnect* bus);
+
 #endif // PROCESSING_ELEMENT_HPP
\ No newline at end of file
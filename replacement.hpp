@@ -0,0 +1,174 @@
+// replacement.hpp
+// Políticas de reemplazo para Cache<Sets, Ways, LineBytes, Replacement>.
+//
+// Cada política es una plantilla <Sets, Ways> con el mismo contrato:
+//   touch(set, way)   -> acceso con hit a la vía
+//   insert(set, way)  -> la vía acaba de llenarse
+//   victim(set)       -> vía a desalojar (solo se llama con el set lleno)
+//   state(set, way)   -> metadato para la GUI / dump (stamp, RRPV, ...)
+//   reset()           -> estado inicial
+// La caché siempre prefiere una vía inválida antes de consultar victim().
+
+#pragma once
+#include <array>
+#include <cstdint>
+
+enum class ReplacementKind : uint8_t { LRU = 0, TreePLRU, SRRIP, BRRIP, Random };
+
+inline const char* replacementName(ReplacementKind k) {
+  switch (k) {
+    case ReplacementKind::LRU:      return "LRU";
+    case ReplacementKind::TreePLRU: return "PLRU";
+    case ReplacementKind::SRRIP:    return "SRRIP";
+    case ReplacementKind::BRRIP:    return "BRRIP";
+    case ReplacementKind::Random:   return "Random";
+  }
+  return "?";
+}
+
+/// Generador xorshift64 (determinista, sin estado global).
+struct XorShift64 {
+  uint64_t s = 0x9E3779B97F4A7C15ull;
+  uint64_t next() {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    return s;
+  }
+};
+
+// ============================================================================
+// LRU exacto: un stamp de 64 bits por vía, búsqueda lineal del mínimo.
+// ============================================================================
+template <uint32_t Sets, uint32_t Ways>
+class LRUReplacement {
+public:
+  static constexpr ReplacementKind KIND = ReplacementKind::LRU;
+
+  void touch(uint32_t set, uint32_t way)  { stamp_[set][way] = ++tick_; }
+  void insert(uint32_t set, uint32_t way) { stamp_[set][way] = ++tick_; }
+
+  uint32_t victim(uint32_t set) {
+    const auto& st = stamp_[set];
+    uint32_t v = 0;
+    for (uint32_t w = 1; w < Ways; ++w) if (st[w] < st[v]) v = w;
+    return v;
+  }
+
+  uint64_t state(uint32_t set, uint32_t way) const { return stamp_[set][way]; }
+  void reset() { stamp_ = {}; tick_ = 0; }
+
+private:
+  std::array<std::array<uint64_t, Ways>, Sets> stamp_{};
+  uint64_t tick_ = 0;
+};
+
+// ============================================================================
+// Tree-PLRU: Ways-1 bits por set en un árbol binario implícito (nodo raíz = 1).
+// Cada bit apunta hacia la mitad que debe desalojarse (0 = izquierda).
+// ============================================================================
+template <uint32_t Sets, uint32_t Ways>
+class TreePLRUReplacement {
+  static_assert(Ways >= 1 && (Ways & (Ways - 1)) == 0, "Tree-PLRU requiere Ways potencia de 2");
+  static_assert(Ways <= 64, "Tree-PLRU usa un uint64_t por set");
+
+public:
+  static constexpr ReplacementKind KIND = ReplacementKind::TreePLRU;
+
+  void touch(uint32_t set, uint32_t way)  { pointAway(set, way); }
+  void insert(uint32_t set, uint32_t way) { pointAway(set, way); }
+
+  uint32_t victim(uint32_t set) const {
+    const uint64_t bits = tree_[set];
+    uint32_t node = 1;
+    for (uint32_t l = 0; l < LEVELS; ++l) node = (node << 1) | ((bits >> node) & 1u);
+    return node - Ways;
+  }
+
+  // 1 si la vía es la víctima actual del set
+  uint64_t state(uint32_t set, uint32_t way) const { return victim(set) == way ? 1 : 0; }
+  void reset() { tree_ = {}; }
+
+private:
+  static constexpr uint32_t levels(uint32_t w) { return w <= 1 ? 0 : 1 + levels(w >> 1); }
+  static constexpr uint32_t LEVELS = levels(Ways);
+
+  void pointAway(uint32_t set, uint32_t way) {
+    uint64_t& bits = tree_[set];
+    uint32_t node = 1;
+    for (uint32_t l = 0; l < LEVELS; ++l) {
+      const uint32_t dir = (way >> (LEVELS - 1 - l)) & 1u;
+      if (dir) bits &= ~(1ull << node); else bits |= (1ull << node);
+      node = (node << 1) | dir;
+    }
+  }
+
+  std::array<uint64_t, Sets> tree_{};
+};
+
+// ============================================================================
+// RRIP (Jaleel et al.): RRPV de 2 bits por vía.
+// SRRIP inserta con "re-referencia lejana" (2); BRRIP inserta casi siempre
+// con "distante" (3) y solo 1 de cada 32 con 2, lo que protege al set de
+// patrones de streaming como el recorrido de A y B.
+// ============================================================================
+template <uint32_t Sets, uint32_t Ways, bool Bimodal>
+class RRIPReplacementBase {
+public:
+  static constexpr ReplacementKind KIND = Bimodal ? ReplacementKind::BRRIP : ReplacementKind::SRRIP;
+  static constexpr uint8_t RRPV_MAX = 3;
+
+  void touch(uint32_t set, uint32_t way) { rrpv_[set][way] = 0; }
+
+  void insert(uint32_t set, uint32_t way) {
+    if (Bimodal) rrpv_[set][way] = (rng_.next() & 31u) == 0 ? RRPV_MAX - 1 : RRPV_MAX;
+    else         rrpv_[set][way] = RRPV_MAX - 1;
+  }
+
+  uint32_t victim(uint32_t set) {
+    auto& r = rrpv_[set];
+    for (;;) {
+      for (uint32_t w = 0; w < Ways; ++w) if (r[w] >= RRPV_MAX) return w;
+      for (uint32_t w = 0; w < Ways; ++w) ++r[w];
+    }
+  }
+
+  uint64_t state(uint32_t set, uint32_t way) const { return rrpv_[set][way]; }
+  void reset() { rrpv_ = {}; rng_ = {}; }
+
+private:
+  std::array<std::array<uint8_t, Ways>, Sets> rrpv_{};
+  XorShift64 rng_;
+};
+
+template <uint32_t Sets, uint32_t Ways>
+class SRRIPReplacement : public RRIPReplacementBase<Sets, Ways, false> {};
+
+template <uint32_t Sets, uint32_t Ways>
+class BRRIPReplacement : public RRIPReplacementBase<Sets, Ways, true> {};
+
+// ============================================================================
+// Aleatorio: sin estado por línea.
+// ============================================================================
+template <uint32_t Sets, uint32_t Ways>
+class RandomReplacement {
+public:
+  static constexpr ReplacementKind KIND = ReplacementKind::Random;
+
+  void touch(uint32_t, uint32_t) {}
+  void insert(uint32_t, uint32_t) {}
+  uint32_t victim(uint32_t) { return static_cast<uint32_t>(rng_.next() % Ways); }
+  uint64_t state(uint32_t, uint32_t) const { return 0; }
+  void reset() { rng_ = {}; }
+
+private:
+  XorShift64 rng_;
+};
+
+// Lista de políticas para la fábrica: X(plantilla, ReplacementKind).
+#define CACHE_REPLACEMENT_POLICIES(X, SETS_, WAYS_, LINE_) \
+  X(SETS_, WAYS_, LINE_, LRUReplacement,      LRU)         \
+  X(SETS_, WAYS_, LINE_, TreePLRUReplacement, TreePLRU)    \
+  X(SETS_, WAYS_, LINE_, SRRIPReplacement,    SRRIP)       \
+  X(SETS_, WAYS_, LINE_, BRRIPReplacement,    BRRIP)       \
+  X(SETS_, WAYS_, LINE_, RandomReplacement,   Random)
@@ -0,0 +1,172 @@
+#include "ring.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+
+RingInterconnect::RingInterconnect(const RingConfig& cfg) : cfg_(cfg) {
+  if (cfg.link_bytes_per_cycle == 0 || cfg.ordering_points == 0 || cfg.line_bytes == 0) {
+    throw std::invalid_argument("RingInterconnect: link_bytes_per_cycle, ordering_points y line_bytes deben ser > 0");
+  }
+  for (uint32_t i = 0; i < cfg.ordering_points; ++i) points_.push_back(std::make_unique<OrderingPoint>());
+}
+
+void RingInterconnect::attach(IBusClient* c) {
+  Interconnect::attach(c);
+  std::scoped_lock lk(mx_);
+  links_.clear();
+  for (size_t i = 0; i < 2 * clientCount(); ++i) links_.push_back(std::make_unique<BusTimeline>());
+}
+
+uint32_t RingInterconnect::nodes() const {
+  return static_cast<uint32_t>(clientCount());
+}
+
+uint32_t RingInterconnect::orderingNode(uint64_t base_addr) const {
+  const uint32_t n = nodes();
+  if (n == 0) return 0;
+  const uint64_t k = lineOf(base_addr) % points_.size();
+  return static_cast<uint32_t>(k * n / points_.size());
+}
+
+uint32_t RingInterconnect::distance(uint32_t from, uint32_t to) const {
+  const uint32_t n = nodes();
+  if (n == 0) return 0;
+  const uint32_t cw = (to + n - from) % n;
+  return std::min(cw, n - cw);
+}
+
+SnoopResponse RingInterconnect::broadcast(IBusClient* src, BusMsg msg, uint64_t base_addr, SnoopReply& reply) {
+  const uint64_t line = lineOf(base_addr);
+  OrderingPoint& op = pointOf(line);
+  {
+    std::unique_lock lk(op.mx);
+    if (op.pending.count(line)) op.stats.conflicts++;
+    op.cv.wait(lk, [&] { return !op.busy && !op.pending.count(line); });
+    op.busy = true;
+    op.stats.transactions++;
+  }
+
+  // El snoop corre sin op.mx: una caché que llama a complete() con su
+  // propio lock tomado no puede bloquear a quien la está snoopeando.
+  const SnoopResponse resp = Interconnect::broadcast(src, msg, base_addr, reply);
+
+  std::scoped_lock lk(op.mx);
+  op.busy = false;
+  if (reply.hold) op.pending.insert(line);
+  op.cv.notify_all();
+  return resp;
+}
+
+void RingInterconnect::complete(IBusClient* /*src*/, uint64_t base_addr) {
+  const uint64_t line = lineOf(base_addr);
+  OrderingPoint& op = pointOf(line);
+  std::scoped_lock lk(op.mx);
+  op.pending.erase(line);
+  op.cv.notify_all();
+}
+
+uint64_t RingInterconnect::travel(uint32_t from, uint32_t hops, bool cw, uint32_t bytes, uint64_t t, uint64_t* first) {
+  if (first) *first = t;
+  if (hops == 0) return t;
+  const uint32_t n = static_cast<uint32_t>(links_.size() / 2);
+  const uint32_t flits = std::max<uint32_t>(1, (bytes + cfg_.link_bytes_per_cycle - 1) / cfg_.link_bytes_per_cycle);
+  uint32_t node = from;
+  for (uint32_t h = 0; h < hops; ++h) {
+    const uint64_t start = links_[cw ? node : n + node]->reserve(t, flits);
+    if (h == 0 && first) *first = start;
+    t = start + cfg_.hop_cycles;
+    node = cw ? (node + 1) % n : (node + n - 1) % n;
+  }
+  hops_.fetch_add(hops, std::memory_order_relaxed);
+  return t + flits - 1;
+}
+
+uint64_t RingInterconnect::send(uint32_t from, uint32_t to, uint32_t bytes, uint64_t t, uint64_t* first) {
+  const uint32_t n = static_cast<uint32_t>(links_.size() / 2);
+  const uint32_t cw = (to + n - from) % n;
+  return cw <= n - cw ? travel(from, cw, true, bytes, t, first) : travel(from, n - cw, false, bytes, t, first);
+}
+
+BusGrant RingInterconnect::reserveBus(const BusTransfer& x) {
+  const ClientList& cl = clientList();
+  const uint32_t n = static_cast<uint32_t>(cl.clients.size());
+  uint32_t s = 0;
+  if (auto it = cl.ids.find(x.src); it != cl.ids.end()) s = it->second;
+  if (n == 0) return { x.ready, x.ready + x.snoop_cycles };
+  const uint32_t o = orderingNode(x.base_addr);
+
+  // 1. Petición al ordering point
+  uint64_t start;
+  const uint64_t at_op = send(s, o, x.addr_bytes, x.ready, &start);
+
+  // 2. Snoop media vuelta por cada sentido y respuestas de regreso
+  const uint32_t cw_hops = n / 2, ccw_hops = (n - 1) / 2;
+  const uint64_t cw_end = travel(o, cw_hops, true, x.addr_bytes, at_op) + x.snoop_cycles;
+  const uint64_t ccw_end = travel(o, ccw_hops, false, x.addr_bytes, at_op) + x.snoop_cycles;
+  const uint64_t snooped = std::max(travel((o + cw_hops) % n, cw_hops, false, x.addr_bytes, cw_end),
+                                    travel((o + n - ccw_hops) % n, ccw_hops, true, x.addr_bytes, ccw_end));
+
+  // 3. Datos (o ack) al solicitante
+  const uint64_t done = send(o, s, x.data_bytes ? x.data_bytes : x.addr_bytes, snooped);
+  return { start, done };
+}
+
+uint64_t RingInterconnect::busyCycles() const {
+  uint64_t m = 0;
+  for (uint64_t b : linkBusyCycles()) m = std::max(m, b);
+  return m;
+}
+
+void RingInterconnect::resetTiming() {
+  std::scoped_lock lk(mx_);
+  for (auto& l : links_) l->reset();
+}
+
+std::vector<uint64_t> RingInterconnect::linkBusyCycles() const {
+  std::scoped_lock lk(mx_);
+  std::vector<uint64_t> out;
+  out.reserve(links_.size());
+  for (const auto& l : links_) out.push_back(l->busyCycles());
+  return out;
+}
+
+RingInterconnect::Stats RingInterconnect::getStats() const {
+  Stats t;
+  for (const auto& p : points_) {
+    std::scoped_lock lk(p->mx);
+    t.transactions += p->stats.transactions;
+    t.conflicts    += p->stats.conflicts;
+  }
+  t.hops = hops_.load(std::memory_order_relaxed);
+  return t;
+}
+
+void RingInterconnect::resetStats() {
+  for (auto& p : points_) {
+    std::scoped_lock lk(p->mx);
+    p->stats = Stats{};
+  }
+  hops_.store(0, std::memory_order_relaxed);
+}
+
+void RingInterconnect::dump(std::ostream& os, uint64_t total_cycles) const {
+  const Stats st = getStats();
+  const std::vector<uint64_t> busy = linkBusyCycles();
+  const uint32_t n = static_cast<uint32_t>(busy.size() / 2);
+  os << "Ring (" << n << " nodos, " << cfg_.ordering_points << " ordering points, hop="
+     << cfg_.hop_cycles << ", " << cfg_.link_bytes_per_cycle << " B/ciclo)\n"
+     << "  transactions=" << st.transactions
+     << " conflicts=" << st.conflicts
+     << " hops=" << st.hops
+     << "\n";
+  if (total_cycles == 0) return;
+  const auto flags = os.flags();
+  const auto prec = os.precision();
+  os << std::fixed << std::setprecision(1);
+  for (uint32_t i = 0; i < n; ++i) {
+    os << "  " << i << "->" << (i + 1) % n << " " << 100.0 * busy[i] / total_cycles << "%"
+       << "  " << i << "->" << (i + n - 1) % n << " " << 100.0 * busy[n + i] / total_cycles << "%\n";
+  }
+  os.flags(flags);
+  os.precision(prec);
+}
@@ -0,0 +1,108 @@
+// ring.hpp
+// Anillo bidireccional como alternativa al bus compartido.
+//
+// RingInterconnect es un Interconnect: las cachés se conectan con attach()
+// (la caché i queda en el nodo i del anillo) y emiten las mismas
+// transacciones. Lo que cambia es el orden y el tiempo:
+//
+//   RingInterconnect ring(RingConfig{ 1, 16, 4 });  // hop, bytes/ciclo, ordering points
+//   c0.setBus(&ring);  ring.attach(&c0);
+//
+// Orden: cada línea pertenece a un ordering point (línea % ordering_points,
+// repartidos a distancias iguales en el anillo). El ordering point
+// serializa las transacciones de sus líneas: atiende una por vez y, como el
+// bus partido, no deja pasar otra sobre una línea cuyo solicitante aún no
+// llamó a complete(). Líneas de ordering points distintos avanzan en paralelo.
+//
+// Tiempo (reserveBus()): cada enlace es unidireccional, transmite
+// `link_bytes_per_cycle` bytes por ciclo y cada salto agrega `hop_cycles`.
+// Una transacción recorre:
+//   1. solicitante -> ordering point, por el sentido más corto (dirección);
+//   2. snoop del ordering point a todos los nodos, media vuelta por cada
+//      sentido, y las respuestas de regreso al ordering point;
+//   3. ordering point -> solicitante con los datos (o un ack del tamaño de
+//      una dirección si el mensaje no lleva datos).
+// Cada paso reserva los enlaces que usa, así que la contención aparece por
+// enlace y no en un recurso global. linkBusyCycles() da la ocupación de cada
+// enlace; busyCycles() la del más cargado.
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unordered_set>
+#include <vector>
+#include "interconnect.hpp"
+
+struct RingConfig {
+  uint32_t hop_cycles           = 1;   // latencia de un salto entre nodos vecinos
+  uint32_t link_bytes_per_cycle = 16;  // ancho de cada enlace
+  uint32_t ordering_points      = 1;   // 1 = orden global, como un bus
+  uint32_t line_bytes           = 32;
+};
+
+class RingInterconnect : public Interconnect {
+public:
+  struct Stats {
+    uint64_t transactions = 0;  // transacciones ordenadas
+    uint64_t conflicts    = 0;  // esperaron a otra transacción de su línea
+    uint64_t hops         = 0;  // saltos de mensaje reservados en los enlaces
+  };
+
+  explicit RingInterconnect(const RingConfig& cfg = {});
+
+  /// Agrega un nodo al anillo. Debe hacerse antes de la primera
+  /// transacción: los enlaces se rearman con cada nodo nuevo.
+  void attach(IBusClient* c) override;
+  using Interconnect::broadcast;
+  SnoopResponse broadcast(IBusClient* src, BusMsg msg, uint64_t base_addr, SnoopReply& reply) override;
+  void complete(IBusClient* src, uint64_t base_addr) override;
+
+  BusGrant reserveBus(const BusTransfer& x) override;
+  /// Ocupación del enlace más cargado.
+  uint64_t busyCycles() const override;
+  void resetTiming() override;
+
+  uint32_t nodes() const;
+  /// Ordering point de la línea de `base_addr`.
+  uint32_t orderingNode(uint64_t base_addr) const;
+  /// Saltos del camino más corto entre dos nodos.
+  uint32_t distance(uint32_t from, uint32_t to) const;
+
+  /// Ocupación de cada enlace: [0, n) sentido horario (i -> i+1) y
+  /// [n, 2n) antihorario (i -> i-1).
+  std::vector<uint64_t> linkBusyCycles() const;
+
+  Stats getStats() const;
+  void resetStats();
+  /// Con `total_cycles` > 0 también imprime la utilización de cada enlace.
+  void dump(std::ostream& os, uint64_t total_cycles = 0) const;
+  const RingConfig& config() const { return cfg_; }
+
+private:
+  struct OrderingPoint {
+    std::mutex mx;
+    std::condition_variable cv;
+    bool busy = false;                  // una transacción haciendo snoop
+    std::unordered_set<uint64_t> pending;  // líneas esperando complete()
+    Stats stats;
+  };
+
+  uint64_t lineOf(uint64_t addr) const { return addr / cfg_.line_bytes; }
+  OrderingPoint& pointOf(uint64_t line) { return *points_[line % points_.size()]; }
+
+  // Recorre `hops` enlaces desde `from` en un sentido reservando cada uno;
+  // devuelve el ciclo en que llega la cola del mensaje. `first` recibe el
+  // inicio en el primer enlace.
+  uint64_t travel(uint32_t from, uint32_t hops, bool cw, uint32_t bytes, uint64_t t, uint64_t* first = nullptr);
+  // Igual, por el sentido más corto entre `from` y `to`.
+  uint64_t send(uint32_t from, uint32_t to, uint32_t bytes, uint64_t t, uint64_t* first = nullptr);
+
+  RingConfig cfg_;
+  std::vector<std::unique_ptr<OrderingPoint>> points_;
+  std::vector<std::unique_ptr<BusTimeline>> links_;  // 2 por nodo
+  std::atomic<uint64_t> hops_{0};
+};
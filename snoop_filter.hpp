@@ -0,0 +1,168 @@
+// snoop_filter.hpp
+// Filtro de snoops para Interconnect (ver Interconnect::setSnoopFilter()).
+//
+// Registra qué cachés pueden tener cada línea a partir de las propias
+// transacciones del bus: un BusRd/BusRdX agrega al solicitante y un snoop
+// que invalida una copia real la quita. Los desalojos de las L1 no pasan por
+// el bus, así que el filtro puede sobrestimar (snoops de más), pero nunca
+// omite a una caché que tiene la línea.
+//
+//   Exact         -> un bit por caché y por línea (tabla por shard).
+//   CountingBloom -> por caché, `bloom_counters` contadores de 8 bits y
+//                    `bloom_hashes` funciones hash. Tamaño fijo sin importar
+//                    cuántas líneas haya; los contadores saturados ya no se
+//                    decrementan.
+//
+// Las transacciones de líneas del mismo shard se serializan con el mutex del
+// shard, que Interconnect mantiene tomado mientras dura el snoop.
+
+#pragma once
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+enum class SnoopFilterKind : uint8_t { Exact = 0, CountingBloom };
+
+inline const char* snoopFilterName(SnoopFilterKind k) {
+  switch (k) {
+    case SnoopFilterKind::Exact:         return "Exact";
+    case SnoopFilterKind::CountingBloom: return "CountingBloom";
+  }
+  return "?";
+}
+
+struct SnoopFilterConfig {
+  SnoopFilterKind kind    = SnoopFilterKind::Exact;
+  uint32_t bloom_counters = 1024;  // por caché, potencia de 2
+  uint32_t bloom_hashes   = 2;
+  uint32_t shards         = 16;
+  uint32_t line_bytes     = 32;
+};
+
+class SnoopFilter {
+public:
+  static constexpr uint32_t MAX_CLIENTS = 256;
+
+  struct Stats {
+    uint64_t transactions = 0;  // transacciones que pasaron por el filtro
+    uint64_t forwarded    = 0;  // snoops entregados a una caché
+    uint64_t filtered     = 0;  // snoops evitados
+    uint64_t removals     = 0;  // copias invalidadas quitadas del filtro
+  };
+
+  explicit SnoopFilter(const SnoopFilterConfig& cfg) : cfg_(cfg) {
+    if (cfg.shards == 0 || cfg.line_bytes == 0) {
+      throw std::invalid_argument("SnoopFilter: shards y line_bytes deben ser > 0");
+    }
+    if (cfg.kind == SnoopFilterKind::CountingBloom &&
+        (cfg.bloom_counters == 0 || (cfg.bloom_counters & (cfg.bloom_counters - 1)) != 0 ||
+         cfg.bloom_hashes == 0)) {
+      throw std::invalid_argument("SnoopFilter: bloom_counters debe ser potencia de 2 y bloom_hashes > 0");
+    }
+    for (uint32_t i = 0; i < cfg.shards; ++i) shards_.push_back(std::make_unique<Shard>());
+  }
+
+  const SnoopFilterConfig& config() const { return cfg_; }
+  uint64_t lineOf(uint64_t addr) const { return addr / cfg_.line_bytes; }
+  std::mutex& shardLock(uint64_t line) { return shardOf(line).mx; }
+
+  /// Reserva el estado de la caché `client` (ids consecutivos desde 0).
+  void addClient(uint32_t client) {
+    if (client >= MAX_CLIENTS) throw std::out_of_range("SnoopFilter: máximo 256 cachés");
+    if (cfg_.kind == SnoopFilterKind::CountingBloom) {
+      while (bloom_.size() <= client) {
+        bloom_.push_back(std::make_unique<std::atomic<uint8_t>[]>(cfg_.bloom_counters));
+      }
+    }
+  }
+
+  // Las tres operaciones siguientes se llaman con shardLock(line) tomado.
+  bool mayHold(uint32_t client, uint64_t line) const {
+    if (cfg_.kind == SnoopFilterKind::Exact) {
+      const auto& lines = shardOf(line).lines;
+      auto it = lines.find(line);
+      return it != lines.end() && it->second.test(client);
+    }
+    for (uint32_t k = 0; k < cfg_.bloom_hashes; ++k) {
+      if (bloom_[client][hash(line, k)].load(std::memory_order_relaxed) == 0) return false;
+    }
+    return true;
+  }
+
+  void insert(uint32_t client, uint64_t line) {
+    if (cfg_.kind == SnoopFilterKind::Exact) {
+      shardOf(line).lines[line].set(client);
+      return;
+    }
+    for (uint32_t k = 0; k < cfg_.bloom_hashes; ++k) {
+      auto& c = bloom_[client][hash(line, k)];
+      uint8_t v = c.load(std::memory_order_relaxed);
+      while (v != UINT8_MAX && !c.compare_exchange_weak(v, v + 1, std::memory_order_relaxed)) {}
+    }
+  }
+
+  /// `client` tenía la línea y el snoop la invalidó.
+  void remove(uint32_t client, uint64_t line) {
+    Shard& s = shardOf(line);
+    s.stats.removals++;
+    if (cfg_.kind == SnoopFilterKind::Exact) {
+      auto it = s.lines.find(line);
+      if (it == s.lines.end()) return;
+      it->second.reset(client);
+      if (it->second.none()) s.lines.erase(it);
+      return;
+    }
+    for (uint32_t k = 0; k < cfg_.bloom_hashes; ++k) {
+      auto& c = bloom_[client][hash(line, k)];
+      uint8_t v = c.load(std::memory_order_relaxed);
+      while (v != 0 && v != UINT8_MAX && !c.compare_exchange_weak(v, v - 1, std::memory_order_relaxed)) {}
+    }
+  }
+
+  /// Contadores de la transacción en curso (con shardLock(line) tomado).
+  Stats& shardStats(uint64_t line) { return shardOf(line).stats; }
+
+  Stats getStats() const {
+    Stats t;
+    for (const auto& s : shards_) {
+      std::scoped_lock lk(s->mx);
+      t.transactions += s->stats.transactions;
+      t.forwarded    += s->stats.forwarded;
+      t.filtered     += s->stats.filtered;
+      t.removals     += s->stats.removals;
+    }
+    return t;
+  }
+
+  void resetStats() {
+    for (auto& s : shards_) {
+      std::scoped_lock lk(s->mx);
+      s->stats = Stats{};
+    }
+  }
+
+private:
+  struct Shard {
+    std::mutex mx;
+    std::unordered_map<uint64_t, std::bitset<MAX_CLIENTS>> lines;  // solo Exact
+    Stats stats;
+  };
+
+  Shard& shardOf(uint64_t line) { return *shards_[line % cfg_.shards]; }
+  const Shard& shardOf(uint64_t line) const { return *shards_[line % cfg_.shards]; }
+
+  uint32_t hash(uint64_t line, uint32_t k) const {
+    uint64_t h = (line + 1) * (0x9E3779B97F4A7C15ull + 2 * k);
+    h ^= h >> 29;
+    return static_cast<uint32_t>(h) & (cfg_.bloom_counters - 1);
+  }
+
+  SnoopFilterConfig cfg_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::vector<std::unique_ptr<std::atomic<uint8_t>[]>> bloom_;  // por caché
+};
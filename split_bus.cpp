@@ -0,0 +1,157 @@
+#include "split_bus.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+std::unique_ptr<IArbiter> makeArbiter(ArbiterKind kind) {
+  switch (kind) {
+    case ArbiterKind::RoundRobin:    return std::make_unique<RoundRobinArbiter>();
+    case ArbiterKind::FixedPriority: return std::make_unique<FixedPriorityArbiter>();
+    case ArbiterKind::Age:           return std::make_unique<AgeArbiter>();
+  }
+  throw std::invalid_argument("makeArbiter: tipo desconocido");
+}
+
+SplitTransactionBus::SplitTransactionBus(const SplitBusConfig& cfg)
+    : cfg_(cfg), arbiter_(makeArbiter(cfg.arbiter)) {
+  if (cfg.line_bytes == 0) throw std::invalid_argument("SplitTransactionBus: line_bytes debe ser > 0");
+}
+
+void SplitTransactionBus::attach(IBusClient* c) {
+  Interconnect::attach(c);
+  std::scoped_lock lk(arb_mx_);
+  queues_.emplace_back();
+  grants_.push_back(0);
+}
+
+void SplitTransactionBus::grantNext() {
+  if (addr_busy_) return;
+  cand_.clear();
+  for (uint32_t i = 0; i <= queues_.size(); ++i) {
+    auto& q = i < queues_.size() ? queues_[i] : external_;
+    if (q.empty()) continue;
+    Request& r = q.front();
+    if (pending_.count(r.line)) {
+      if (!r.blocked) { r.blocked = true; stats_.conflicts++; }
+      continue;
+    }
+    cand_.push_back({ i < queues_.size() ? i : NONE, r.ticket });
+  }
+  if (cand_.empty()) return;
+
+  const ArbiterRequest& w = cand_[arbiter_->pick(cand_.data(), static_cast<uint32_t>(cand_.size()))];
+  queueOf(w.client).pop_front();
+  addr_busy_ = true;
+  granted_ = w.ticket;
+  granted_cv_.notify_all();
+}
+
+SnoopResponse SplitTransactionBus::broadcast(IBusClient* src, BusMsg msg, uint64_t base_addr, SnoopReply& reply) {
+  const uint64_t line = base_addr / cfg_.line_bytes;
+  uint32_t id = NONE;
+  const ClientList& cl = clientList();
+  if (auto it = cl.ids.find(src); it != cl.ids.end()) id = it->second;
+
+  std::unique_lock lk(arb_mx_);
+  const uint64_t ticket = next_ticket_++;
+  if (addr_busy_ || waiting_ > 0) stats_.queued++;
+  queueOf(id).push_back({ ticket, line });
+  if (++waiting_ > stats_.peak_waiting) stats_.peak_waiting = waiting_;
+  grantNext();
+  granted_cv_.wait(lk, [&] { return granted_ == ticket; });
+  waiting_--;
+  stats_.transactions++;
+  if (id < grants_.size()) grants_[id]++;
+  if (record_) order_.push_back({ serial_, id, msg, line });
+  serial_++;
+  lk.unlock();
+
+  // Fase de dirección: snoop de las demás cachés, con el orden ya fijado
+  const SnoopResponse resp = Interconnect::broadcast(src, msg, base_addr, reply);
+
+  lk.lock();
+  addr_busy_ = false;
+  if (reply.hold) pending_.insert(line);
+  grantNext();
+  return resp;
+}
+
+void SplitTransactionBus::complete(IBusClient* /*src*/, uint64_t base_addr) {
+  std::scoped_lock lk(arb_mx_);
+  pending_.erase(base_addr / cfg_.line_bytes);
+  grantNext();
+}
+
+BusGrant SplitTransactionBus::reserveBus(const BusTransfer& x) {
+  const uint64_t start = timeline_.reserve(x.ready, x.addr_cycles);
+  const uint64_t data_ready = start + x.addr_cycles + x.snoop_cycles;
+  const uint64_t data_start = x.data_cycles ? data_timeline_.reserve(data_ready, x.data_cycles) : data_ready;
+  return { start, data_start + x.data_cycles };
+}
+
+uint64_t SplitTransactionBus::busyCycles() const {
+  return std::max(timeline_.busyCycles(), data_timeline_.busyCycles());
+}
+
+void SplitTransactionBus::resetTiming() {
+  timeline_.reset();
+  data_timeline_.reset();
+}
+
+void SplitTransactionBus::setArbiter(std::unique_ptr<IArbiter> a) {
+  if (!a) throw std::invalid_argument("SplitTransactionBus: árbitro nulo");
+  std::scoped_lock lk(arb_mx_);
+  arbiter_ = std::move(a);
+}
+
+ArbiterKind SplitTransactionBus::arbiterKind() const {
+  std::scoped_lock lk(arb_mx_);
+  return arbiter_->kind();
+}
+
+void SplitTransactionBus::recordOrder(bool on) {
+  std::scoped_lock lk(arb_mx_);
+  record_ = on;
+  if (!on) order_.clear();
+}
+
+std::vector<SplitTransactionBus::Serialized> SplitTransactionBus::serialOrder() const {
+  std::scoped_lock lk(arb_mx_);
+  return order_;
+}
+
+SplitTransactionBus::Stats SplitTransactionBus::getStats() const {
+  std::scoped_lock lk(arb_mx_);
+  return stats_;
+}
+
+std::vector<uint64_t> SplitTransactionBus::grantsPerClient() const {
+  std::scoped_lock lk(arb_mx_);
+  return grants_;
+}
+
+size_t SplitTransactionBus::pendingLines() const {
+  std::scoped_lock lk(arb_mx_);
+  return pending_.size();
+}
+
+void SplitTransactionBus::resetStats() {
+  std::scoped_lock lk(arb_mx_);
+  stats_ = Stats{};
+  std::fill(grants_.begin(), grants_.end(), 0);
+  order_.clear();
+}
+
+void SplitTransactionBus::dump(std::ostream& os) const {
+  const Stats st = getStats();
+  const std::vector<uint64_t> grants = grantsPerClient();
+  os << "SplitTransactionBus (" << arbiterName(arbiterKind()) << ")\n"
+     << "  transactions=" << st.transactions
+     << " queued=" << st.queued
+     << " conflicts=" << st.conflicts
+     << " peakWaiting=" << st.peak_waiting
+     << " addrBusy=" << addressBusyCycles()
+     << " dataBusy=" << dataBusyCycles()
+     << "\n  grants:";
+  for (size_t i = 0; i < grants.size(); ++i) os << " C" << i << "=" << grants[i];
+  os << "\n";
+}
@@ -0,0 +1,186 @@
+// split_bus.hpp
+// Bus de transacciones partidas (split-transaction) con arbitraje.
+//
+// En Interconnect cada transacción se difunde directamente desde el hilo del
+// solicitante: no hay orden entre cachés y otra transacción sobre la misma
+// línea puede colarse entre el emit() de una caché y su llenado.
+// SplitTransactionBus mantiene la misma interfaz, pero:
+//
+//   - cada caché tiene su cola de peticiones (FIFO);
+//   - un árbitro intercambiable (IArbiter) elige qué cabeza de cola obtiene
+//     la fase de dirección:
+//       RoundRobin    -> turno rotativo a partir del último concedido
+//       FixedPriority -> gana el id de caché menor (puede dejar sin turno)
+//       Age           -> gana la petición más antigua
+//   - solo una transacción a la vez está en fase de dirección (el snoop) y
+//     cada una recibe un número de orden global: ese es el orden de
+//     serialización de todas las cachés;
+//   - la fase de datos queda abierta hasta complete(), cuando el
+//     solicitante ya instaló la línea o su nuevo estado. Mientras tanto el
+//     bus atiende otras líneas, pero una petición sobre la misma línea espera
+//     en su cola (tabla de transacciones pendientes por línea).
+//
+//   SplitTransactionBus bus(SplitBusConfig{ ArbiterKind::Age });
+//   c0.setBus(&bus);  bus.attach(&c0);
+//
+// En el tiempo simulado (timing.hpp) las fases usan buses separados: la
+// dirección de un mensaje puede solaparse con los datos de otro.
+// Un cliente que no pide `reply.hold` (p. ej. una prueba que llama a
+// broadcast() directamente) termina su transacción con la fase de dirección.
+
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unordered_set>
+#include <vector>
+#include "interconnect.hpp"
+
+enum class ArbiterKind : uint8_t { RoundRobin = 0, FixedPriority, Age };
+
+inline const char* arbiterName(ArbiterKind k) {
+  switch (k) {
+    case ArbiterKind::RoundRobin:    return "RoundRobin";
+    case ArbiterKind::FixedPriority: return "FixedPriority";
+    case ArbiterKind::Age:           return "Age";
+  }
+  return "?";
+}
+
+/// Cabeza de una cola que puede recibir la fase de dirección.
+struct ArbiterRequest {
+  uint32_t client;  // id de la caché (orden de attach)
+  uint64_t ticket;  // orden de llegada al bus
+};
+
+class IArbiter {
+public:
+  virtual ~IArbiter() = default;
+  virtual ArbiterKind kind() const = 0;
+  /// Elige una de las `n` candidatas (n >= 1, ordenadas por cliente) y
+  /// devuelve su índice.
+  virtual uint32_t pick(const ArbiterRequest* cand, uint32_t n) = 0;
+};
+
+class RoundRobinArbiter : public IArbiter {
+public:
+  ArbiterKind kind() const override { return ArbiterKind::RoundRobin; }
+  uint32_t pick(const ArbiterRequest* cand, uint32_t n) override {
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+      if (cand[i].client > last_) { k = i; break; }
+    }
+    last_ = cand[k].client;
+    return k;
+  }
+private:
+  uint32_t last_ = UINT32_MAX;  // nadie aún: el primero es el id menor
+};
+
+class FixedPriorityArbiter : public IArbiter {
+public:
+  ArbiterKind kind() const override { return ArbiterKind::FixedPriority; }
+  uint32_t pick(const ArbiterRequest*, uint32_t) override { return 0; }
+};
+
+class AgeArbiter : public IArbiter {
+public:
+  ArbiterKind kind() const override { return ArbiterKind::Age; }
+  uint32_t pick(const ArbiterRequest* cand, uint32_t n) override {
+    uint32_t k = 0;
+    for (uint32_t i = 1; i < n; ++i) if (cand[i].ticket < cand[k].ticket) k = i;
+    return k;
+  }
+};
+
+std::unique_ptr<IArbiter> makeArbiter(ArbiterKind kind);
+
+struct SplitBusConfig {
+  ArbiterKind arbiter = ArbiterKind::RoundRobin;
+  uint32_t line_bytes = 32;
+};
+
+class SplitTransactionBus : public Interconnect {
+public:
+  struct Stats {
+    uint64_t transactions = 0;  // fases de dirección concedidas
+    uint64_t queued       = 0;  // peticiones que encontraron el bus ocupado o con cola
+    uint64_t conflicts    = 0;  // peticiones que esperaron a otra transacción de su línea
+    uint64_t peak_waiting = 0;  // máximo de peticiones esperando a la vez
+  };
+
+  /// Transacción en el orden global de serialización.
+  struct Serialized {
+    uint64_t seq;
+    uint32_t client;  // NONE si el emisor no está conectado
+    BusMsg msg;
+    uint64_t line;
+  };
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  explicit SplitTransactionBus(const SplitBusConfig& cfg = {});
+
+  void attach(IBusClient* c) override;
+  using Interconnect::broadcast;
+  SnoopResponse broadcast(IBusClient* src, BusMsg msg, uint64_t base_addr, SnoopReply& reply) override;
+  void complete(IBusClient* src, uint64_t base_addr) override;
+
+  /// Dirección y datos en buses separados: los datos empiezan cuando los
+  /// snoopers respondieron y el bus de datos está libre.
+  BusGrant reserveBus(const BusTransfer& x) override;
+  /// Ocupación de la fase más cargada (la que limita el bus).
+  uint64_t busyCycles() const override;
+  uint64_t addressBusyCycles() const { return timeline_.busyCycles(); }
+  uint64_t dataBusyCycles() const { return data_timeline_.busyCycles(); }
+  void resetTiming() override;
+
+  /// Cambia el árbitro (no debe haber peticiones en espera).
+  void setArbiter(std::unique_ptr<IArbiter> a);
+  ArbiterKind arbiterKind() const;
+
+  /// Guarda el orden global de las transacciones (serialOrder()).
+  void recordOrder(bool on);
+  std::vector<Serialized> serialOrder() const;
+
+  Stats getStats() const;
+  std::vector<uint64_t> grantsPerClient() const;
+  /// Líneas con una transacción concedida que aún no terminó.
+  size_t pendingLines() const;
+  void resetStats();
+  void dump(std::ostream& os) const;
+
+private:
+  struct Request {
+    uint64_t ticket;
+    uint64_t line;
+    bool blocked = false;  // ya se contó como conflicto
+  };
+
+  std::deque<Request>& queueOf(uint32_t id) { return id < queues_.size() ? queues_[id] : external_; }
+  void grantNext();
+
+  SplitBusConfig cfg_;
+  BusTimeline data_timeline_;
+
+  // Estado del árbitro, protegido por arb_mx_. Nunca se toma otro lock con
+  // arb_mx_ tomado: los snoops corren sin él.
+  mutable std::mutex arb_mx_;
+  std::condition_variable granted_cv_;
+  std::unique_ptr<IArbiter> arbiter_;
+  std::vector<std::deque<Request>> queues_;  // una por caché
+  std::deque<Request> external_;             // emisores no conectados
+  std::vector<ArbiterRequest> cand_;
+  std::unordered_set<uint64_t> pending_;     // líneas con fase de datos abierta
+  std::vector<uint64_t> grants_;             // por caché
+  uint64_t next_ticket_ = 1;
+  uint64_t granted_ = 0;                     // ticket con la fase de dirección
+  bool addr_busy_ = false;
+  uint64_t waiting_ = 0;
+  uint64_t serial_ = 0;
+  bool record_ = false;
+  std::vector<Serialized> order_;
+  Stats stats_;
+};
@@ -0,0 +1,45 @@
+// tag_match.hpp
+// Comparación de tags de todas las vías de un set en una sola pasada.
+// Devuelve una máscara con un bit por vía cuyo tag coincide; el llamador la
+// combina con la máscara de válidos del set.
+//
+// Con -mavx2 se comparan 4 tags por instrucción, con -msse4.1 se comparan 2;
+// en cualquier otro caso se usa el lazo escalar (que el compilador suele
+// vectorizar por su cuenta para Ways pequeños).
+
+#pragma once
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+template <uint32_t Ways>
+inline uint32_t matchTags(const uint64_t* tags, uint64_t tg) {
+  static_assert(Ways <= 32, "La máscara de vías es de 32 bits");
+  uint32_t m = 0;
+#if defined(__AVX2__)
+  if constexpr (Ways % 4 == 0) {
+    const __m256i key = _mm256_set1_epi64x(static_cast<long long>(tg));
+    for (uint32_t w = 0; w < Ways; w += 4) {
+      const __m256i t  = _mm256_load_si256(reinterpret_cast<const __m256i*>(tags + w));
+      const __m256i eq = _mm256_cmpeq_epi64(t, key);
+      m |= static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(eq))) << w;
+    }
+    return m;
+  }
+#endif
+#if defined(__SSE4_1__)
+  if constexpr (Ways % 2 == 0) {
+    const __m128i key = _mm_set1_epi64x(static_cast<long long>(tg));
+    for (uint32_t w = 0; w < Ways; w += 2) {
+      const __m128i t  = _mm_load_si128(reinterpret_cast<const __m128i*>(tags + w));
+      const __m128i eq = _mm_cmpeq_epi64(t, key);
+      m |= static_cast<uint32_t>(_mm_movemask_pd(_mm_castsi128_pd(eq))) << w;
+    }
+    return m;
+  }
+#endif
+  for (uint32_t w = 0; w < Ways; ++w) m |= static_cast<uint32_t>(tags[w] == tg) << w;
+  return m;
+}
@@ -0,0 +1,263 @@
+// bench_broadcast.cpp
+// Microbenchmark de Interconnect::broadcast con 4, 16 y 64 clientes.
+// Compara la lista de clientes publicada como instantánea inmutable (se lee
+// sin lock y sin copiar) con lo que hacía antes cada mensaje: tomar el
+// mutex del bus y copiar el vector de clientes. También mide el directorio
+// (DirectoryInterconnect) con todas las cachés como poseedoras, de modo que
+// cada BusUpd va punto a punto a las otras n - 1. Mide mensajes por segundo
+// con 1 hilo y con 4 hilos emitiendo a la vez, y cuenta las reservas de
+// memoria dinámica durante los mensajes: con la instantánea y con el
+// directorio deben ser cero. Los clientes no hacen nada en el snoop: se
+// mide solo el costo del bus.
+//
+// Con muchos clientes el recorrido de los snoops (63 llamadas por mensaje
+// con 64 clientes) domina a obtener la lista. El snoop vacío no se expande
+// en línea: si se expandía, el compilador lo hacía solo en la copia (que
+// está en este archivo) y, como ahí sabe que la dirección es múltiplo de
+// 32, quitaba la escritura en reply de cada snoop, cosa que no puede hacer
+// en Interconnect::broadcast. Con 64 clientes eso hacía parecer más lenta
+// a la instantánea. Con el mismo recorrido en las dos, la diferencia en ns
+// por mensaje (última columna) es lo que cuesta obtener la lista copiándola
+// bajo el lock en vez de leer la instantánea. Cada medida es la mejor de
+// REPS repeticiones, y los hilos arrancan juntos tras una barrera. Con
+// menos núcleos que hilos, la columna de 4 hilos solo reparte el tiempo
+// entre ellos.
+//
+// Al final recorre el camino de miss real (Cache::load64/store64 con dos
+// cachés que se quitan las líneas): cost(), reserveBus() y broadcast() no
+// deben reservar memoria una vez caliente la línea de tiempo del bus.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "interconnect.hpp"
+#include "directory.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+// Todas las formas de new/delete (simples, de arreglo, nothrow y alineadas)
+// pasan por reservar()/liberar(). No se expanden en línea: así el compilador
+// ve un new emparejado con su delete y no el free() de adentro.
+static std::atomic<uint64_t> g_reservas{0};
+
+[[gnu::noinline]] static void* reservar(std::size_t n, std::size_t alin, bool lanza) {
+    g_reservas.fetch_add(1, std::memory_order_relaxed);
+    n = n ? n : 1;
+    void* p = alin <= alignof(std::max_align_t) ? std::malloc(n)
+                                                : std::aligned_alloc(alin, (n + alin - 1) / alin * alin);
+    if (!p && lanza) throw std::bad_alloc();
+    return p;
+}
+[[gnu::noinline]] static void liberar(void* p) noexcept { std::free(p); }
+
+void* operator new(std::size_t n) { return reservar(n, 0, true); }
+void* operator new[](std::size_t n) { return reservar(n, 0, true); }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept { return reservar(n, 0, false); }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { return reservar(n, 0, false); }
+void* operator new(std::size_t n, std::align_val_t a) { return reservar(n, std::size_t(a), true); }
+void* operator new[](std::size_t n, std::align_val_t a) { return reservar(n, std::size_t(a), true); }
+void* operator new(std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return reservar(n, std::size_t(a), false); }
+void* operator new[](std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return reservar(n, std::size_t(a), false); }
+
+void operator delete(void* p) noexcept { liberar(p); }
+void operator delete[](void* p) noexcept { liberar(p); }
+void operator delete(void* p, std::size_t) noexcept { liberar(p); }
+void operator delete[](void* p, std::size_t) noexcept { liberar(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { liberar(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { liberar(p); }
+void operator delete(void* p, std::align_val_t) noexcept { liberar(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { liberar(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { liberar(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { liberar(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { liberar(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { liberar(p); }
+
+static thread_local uint64_t t_snoops = 0;
+
+struct ClienteVacio : IBusClient {
+    [[gnu::noinline]] void snoop(BusMsg, uint64_t base_addr, SnoopReply& reply) override {
+        t_snoops++;
+        reply.hit |= (base_addr & 1) != 0;
+    }
+};
+
+// Como era Interconnect::broadcast: copia de la lista bajo el mutex del bus
+struct ListaConLock {
+    std::mutex mx;
+    std::vector<IBusClient*> clientes;
+
+    void broadcast(IBusClient* src, BusMsg msg, uint64_t base_addr, SnoopReply& reply) {
+        std::vector<IBusClient*> targets;
+        {
+            std::scoped_lock lk(mx);
+            targets = clientes;
+        }
+        for (auto* c : targets)
+            if (c != src) c->snoop(msg, base_addr, reply);
+    }
+};
+
+struct Medida {
+    double mbroadcasts_s;  // millones de broadcasts por segundo (todos los hilos)
+    uint64_t reservas;     // solo con 1 hilo
+    double ns() const { return 1e3 / mbroadcasts_s; }
+};
+
+static const int REPS = 5;
+
+// `hilos` hilos emiten `por_hilo` broadcasts cada uno desde clientes
+// distintos; se queda con la repetición más rápida
+template <class Emitir>
+static Medida medir(int hilos, int por_hilo, size_t n, Emitir emitir) {
+    Medida mejor{ 0.0, 0 };
+    for (int rep = 0; rep < REPS; rep++) {
+        const uint64_t antes = g_reservas.load();
+        std::chrono::steady_clock::time_point t0;
+        if (hilos == 1) {
+            t0 = std::chrono::steady_clock::now();
+            emitir(0, por_hilo);
+            assert(t_snoops == uint64_t(por_hilo) * (n - 1));
+            t_snoops = 0;
+        } else {
+            std::atomic<int> listos{0};
+            std::atomic<bool> ya{false};
+            std::vector<std::thread> th;
+            for (int h = 0; h < hilos; h++)
+                th.emplace_back([&, h] {
+                    listos++;
+                    while (!ya.load()) std::this_thread::yield();
+                    emitir(h, por_hilo);
+                });
+            while (listos.load() < hilos) std::this_thread::yield();
+            t0 = std::chrono::steady_clock::now();
+            ya = true;
+            for (auto& t : th) t.join();
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        const uint64_t reservas = g_reservas.load() - antes;
+        const double seg = std::chrono::duration<double>(t1 - t0).count();
+        const double m = double(hilos) * por_hilo / seg / 1e6;
+        if (m > mejor.mbroadcasts_s) mejor.mbroadcasts_s = m;
+        mejor.reservas = hilos == 1 ? reservas : 0;
+    }
+    return mejor;
+}
+
+// Misses reales: dos Cache2Way se quitan las líneas con stores (BusRdX con
+// entrega caché a caché) y recorren más líneas de las que caben (BusRd y
+// writebacks). Tras el calentamiento ni el bus ni las cachés reservan memoria.
+static void caminoDeMiss() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    Cache2Way c0(adapter), c1(adapter);
+    c0.setId(0); c0.setBus(&bus); bus.attach(&c0);
+    c1.setId(1); c1.setBus(&bus); bus.attach(&c1);
+
+    auto rondas = [&](int k) {
+        uint64_t v;
+        for (int i = 0; i < k; i++) {
+            const uint64_t a = uint64_t(i % 128) * 32;   // las 128 líneas de la memoria
+            c0.store64(a, i);
+            c1.store64(a, i + 1);
+            c0.load64(a, v);
+        }
+    };
+    rondas(8192);  // calentamiento: la línea de tiempo del bus llega a su capacidad
+
+    const uint64_t misses0 = c0.getStats().misses + c1.getStats().misses;
+    const uint64_t antes = g_reservas.load();
+    const auto t0 = std::chrono::steady_clock::now();
+    rondas(200000);
+    const auto t1 = std::chrono::steady_clock::now();
+    const uint64_t reservas = g_reservas.load() - antes;
+    const uint64_t misses = c0.getStats().misses + c1.getStats().misses - misses0;
+    const double seg = std::chrono::duration<double>(t1 - t0).count();
+
+    std::cout << "\nCamino de miss (2 x Cache2Way, load64/store64): " << misses << " misses, "
+              << std::fixed << std::setprecision(2) << misses / seg / 1e6 << " M/s, "
+              << reservas << " reservas\n";
+    assert(misses >= 400000);
+    assert(reservas == 0);
+}
+
+int main() {
+    std::cout << "=== Microbenchmark de broadcast (snoop vacío) ===\n\n";
+    std::cout << std::setw(9) << "Clientes" << std::setw(24) << "Copia bajo lock (M/s)"
+              << std::setw(22) << "Instantánea (M/s)" << std::setw(22) << "Directorio (M/s)"
+              << std::setw(18) << "Reservas" << std::setw(10) << "Ganancia"
+              << std::setw(16) << "Copia - inst." << "\n";
+    std::cout << std::setw(9) << "" << std::setw(12) << "1 hilo" << std::setw(12) << "4 hilos"
+              << std::setw(11) << "1 hilo" << std::setw(11) << "4 hilos"
+              << std::setw(11) << "1 hilo" << std::setw(11) << "4 hilos"
+              << std::setw(6) << "antes" << std::setw(6) << "ahora" << std::setw(6) << "dir"
+              << std::setw(10) << "1 hilo"
+              << std::setw(16) << "(ns/msg)" << "\n";
+
+    const uint64_t LINEAS = 16;
+    for (size_t n : { 4, 16, 64 }) {
+        std::vector<ClienteVacio> clientes(n);
+        Interconnect bus;
+        DirectoryInterconnect dir;
+        ListaConLock viejo;
+        for (auto& c : clientes) { bus.attach(&c); dir.attach(&c); viejo.clientes.push_back(&c); }
+        assert(bus.clientCount() == n && dir.clientCount() == n);
+
+        // Cada caché lee las LINEAS líneas: todas quedan como poseedoras y
+        // las entradas del directorio ya existen antes de medir
+        for (auto& c : clientes)
+            for (uint64_t l = 0; l < LINEAS; l++) { SnoopReply r; dir.broadcast(&c, BusMsg::BusRd, l * 32, r); }
+        t_snoops = 0;
+
+        const int por_hilo = int(8000000 / n);
+        auto con_lock = [&](int h, int k) {
+            SnoopReply r;
+            for (int i = 0; i < k; i++) viejo.broadcast(&clientes[h], BusMsg::BusRd, uint64_t(i) * 32, r);
+        };
+        auto instantanea = [&](int h, int k) {
+            SnoopReply r;
+            for (int i = 0; i < k; i++) bus.broadcast(&clientes[h], BusMsg::BusRd, uint64_t(i) * 32, r);
+        };
+        auto directorio = [&](int h, int k) {
+            SnoopReply r;
+            for (int i = 0; i < k; i++) dir.broadcast(&clientes[h], BusMsg::BusUpd, uint64_t(i) % LINEAS * 32, r);
+        };
+        const Medida a1 = medir(1, por_hilo, n, con_lock);
+        const Medida a4 = medir(4, por_hilo, n, con_lock);
+        const Medida b1 = medir(1, por_hilo, n, instantanea);
+        const Medida b4 = medir(4, por_hilo, n, instantanea);
+        const Medida c1 = medir(1, por_hilo, n, directorio);
+        const Medida c4 = medir(4, por_hilo, n, directorio);
+
+        // La copia reserva un vector por mensaje; la instantánea y el directorio, nada
+        assert(a1.reservas >= uint64_t(por_hilo));
+        assert(b1.reservas == 0);
+        assert(c1.reservas == 0);
+
+        std::cout << std::fixed << std::setprecision(2) << std::setw(9) << n
+                  << std::setw(12) << a1.mbroadcasts_s << std::setw(12) << a4.mbroadcasts_s
+                  << std::setw(11) << b1.mbroadcasts_s << std::setw(11) << b4.mbroadcasts_s
+                  << std::setw(11) << c1.mbroadcasts_s << std::setw(11) << c4.mbroadcasts_s
+                  << std::setw(6) << a1.reservas / por_hilo << std::setw(6) << b1.reservas
+                  << std::setw(6) << c1.reservas
+                  << std::setw(9) << b1.mbroadcasts_s / a1.mbroadcasts_s << "x"
+                  << std::setw(16) << a1.ns() - b1.ns() << "\n";
+    }
+    caminoDeMiss();
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/bench_broadcast.cpp cache.cpp main_memory.cpp processing_element.cpp directory.cpp -o bench_broadcast
+//./bench_broadcast
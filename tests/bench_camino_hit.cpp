@@ -0,0 +1,139 @@
+// bench_camino_hit.cpp
+// Microbenchmark del camino de hit de la caché.
+// Mide accesos simulados por segundo con hits en E, M y S:
+//   - sin callbacks (barridos por lotes),
+//   - con EventCallback (eventos estructurados, sin formato),
+//   - con LogCallback (la GUI: cada evento se formatea como texto, que es
+//     lo que antes pagaba todo acceso aunque nadie escuchara).
+// Además cuenta las reservas de memoria dinámica durante los hits: deben
+// ser cero salvo con LogCallback.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "interconnect.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <new>
+#include <cassert>
+
+// Todas las formas de new/delete (simples, de arreglo, nothrow y alineadas)
+// pasan por reservar()/liberar(). No se expanden en línea: así el compilador
+// ve un new emparejado con su delete y no el free() de adentro.
+static std::atomic<uint64_t> g_reservas{0};
+
+[[gnu::noinline]] static void* reservar(std::size_t n, std::size_t alin, bool lanza) {
+    g_reservas.fetch_add(1, std::memory_order_relaxed);
+    n = n ? n : 1;
+    void* p = alin <= alignof(std::max_align_t) ? std::malloc(n)
+                                                : std::aligned_alloc(alin, (n + alin - 1) / alin * alin);
+    if (!p && lanza) throw std::bad_alloc();
+    return p;
+}
+[[gnu::noinline]] static void liberar(void* p) noexcept { std::free(p); }
+
+void* operator new(std::size_t n) { return reservar(n, 0, true); }
+void* operator new[](std::size_t n) { return reservar(n, 0, true); }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept { return reservar(n, 0, false); }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { return reservar(n, 0, false); }
+void* operator new(std::size_t n, std::align_val_t a) { return reservar(n, std::size_t(a), true); }
+void* operator new[](std::size_t n, std::align_val_t a) { return reservar(n, std::size_t(a), true); }
+void* operator new(std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return reservar(n, std::size_t(a), false); }
+void* operator new[](std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return reservar(n, std::size_t(a), false); }
+
+void operator delete(void* p) noexcept { liberar(p); }
+void operator delete[](void* p) noexcept { liberar(p); }
+void operator delete(void* p, std::size_t) noexcept { liberar(p); }
+void operator delete[](void* p, std::size_t) noexcept { liberar(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { liberar(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { liberar(p); }
+void operator delete(void* p, std::align_val_t) noexcept { liberar(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { liberar(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { liberar(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { liberar(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { liberar(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { liberar(p); }
+
+struct Medida {
+    double maccesos_s;
+    uint64_t reservas;
+};
+
+// Recorre 256 B (una línea por set de Cache2Way): hits en E y M, y en S
+// para la parte que también leyó la otra caché.
+static Medida medir(Cache2Way& cache, int iteraciones) {
+    uint64_t v = 0, suma = 0;
+    const uint64_t antes = g_reservas.load();
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int it = 0; it < iteraciones; it++) {
+        const uint64_t addr = (uint64_t(it) * 8) & 0xFF;
+        if (addr < 0x80 && (it & 1)) cache.store64(addr, it);
+        else { cache.load64(addr, v); suma += v; }
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    const uint64_t reservas = g_reservas.load() - antes;
+    const double seg = std::chrono::duration<double>(t1 - t0).count();
+    if (suma == 42) std::cout << "";  // evita que el lazo se elimine
+    return { iteraciones / seg / 1e6, reservas };
+}
+
+int main() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    Cache2Way cache(adapter), otra(adapter);
+    cache.setId(0); cache.setBus(&bus); bus.attach(&cache);
+    otra.setId(1);  otra.setBus(&bus);  bus.attach(&otra);
+
+    // Calentamiento: 0x00-0x7F en M, 0x80-0xBF en S, 0xC0-0xFF en E
+    uint64_t v = 0;
+    for (uint64_t a = 0; a < 0x100; a += 8) cache.load64(a, v);
+    for (uint64_t a = 0x80; a < 0xC0; a += 8) otra.load64(a, v);
+    for (uint64_t a = 0; a < 0x80; a += 8) cache.store64(a, 1);
+
+    const int N = 2000000;
+    const Medida sin_cb = medir(cache, N);
+
+    uint64_t eventos = 0;
+    cache.setEventCallback([&](const ICache::Event&) { eventos++; });
+    const Medida con_evento = medir(cache, N);
+    cache.setEventCallback(nullptr);
+
+    uint64_t bytes = 0;
+    cache.setLogCallback([&](const std::string& s) { bytes += s.size(); });
+    const Medida con_log = medir(cache, N / 10);
+    cache.setLogCallback(nullptr);
+
+    const auto st = cache.getStats();
+    assert(st.misses == 8);   // solo los 8 del calentamiento: todo lo demás son hits
+    assert(sin_cb.reservas == 0);
+    assert(con_evento.reservas == 0);
+    if constexpr (logEnabled(LogLevel::Events)) assert(eventos == uint64_t(N));
+    else assert(eventos == 0);
+    if constexpr (logEnabled(LogLevel::Trace)) assert(con_log.reservas > 0 && bytes > 0);
+    else assert(con_log.reservas == 0 && bytes == 0);
+
+    std::cout << "=== Microbenchmark del camino de hit (Cache2Way, nivel "
+              << logLevelName(kLogLevel) << ") ===\n\n";
+    std::cout << std::left << std::setw(22) << "Configuración" << std::right
+              << std::setw(14) << "Maccesos/s" << std::setw(12) << "Reservas" << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::left << std::setw(22) << "Sin callbacks" << std::right
+              << std::setw(14) << sin_cb.maccesos_s << std::setw(12) << sin_cb.reservas << "\n";
+    std::cout << std::left << std::setw(22) << "EventCallback" << std::right
+              << std::setw(14) << con_evento.maccesos_s << std::setw(12) << con_evento.reservas << "\n";
+    std::cout << std::left << std::setw(22) << "LogCallback (texto)" << std::right
+              << std::setw(14) << con_log.maccesos_s << std::setw(12) << con_log.reservas << "\n";
+    if constexpr (logEnabled(LogLevel::Trace))
+        std::cout << "\nGanancia sin formato: " << sin_cb.maccesos_s / con_log.maccesos_s << "x\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/bench_camino_hit.cpp cache.cpp main_memory.cpp processing_element.cpp -o bench_camino_hit
+//./bench_camino_hit
+//Con -DMESI_LOG_LEVEL=0 (en todas las unidades) se mide el build de throughput
@@ -0,0 +1,86 @@
+// producto_punto.hpp
+// Producto punto que comparten las pruebas de interconexión (bus partido,
+// anillo, malla y tiempo): A en 0x400, B en 0x800 y una suma parcial por
+// PE. Cada PE tiene su Cache2Way conectada al Interconnect dado y se
+// ejecuta una instrucción por PE y por vuelta, así que es determinista.
+
+#pragma once
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "processing_element.hpp"
+#include "interconnect.hpp"
+
+#include <vector>
+#include <memory>
+#include <cassert>
+
+// Programa del producto punto (Figura 2): REG0 = A, REG1 = B,
+// REG2 = partial_sums[ID], REG3 = elementos por PE.
+inline std::vector<Instruction> productoPunto() {
+    return {
+        { InstructionType::LOAD,  4, 2, 0, 0 },
+        { InstructionType::LOAD,  5, 0, 0, 0 },
+        { InstructionType::LOAD,  6, 1, 0, 0 },
+        { InstructionType::FMUL,  7, 5, 6, 0 },
+        { InstructionType::FADD,  4, 4, 7, 0 },
+        { InstructionType::INC,   0, 0, 0, 0 },
+        { InstructionType::INC,   1, 0, 0, 0 },
+        { InstructionType::DEC,   3, 0, 0, 0 },
+        { InstructionType::JNZ,   3, 0, 0, 1 },
+        { InstructionType::STORE, 4, 2, 0, 0 },
+    };
+}
+
+struct ProductoPunto {
+    int n = 128;                        // elementos de A y B
+    uint64_t sumas = 0x0C00;            // suma parcial del PE i en sumas + i * paso
+    uint64_t paso = 8;                  // 8: varias por línea (hay invalidaciones)
+    const TimingConfig* tiempo = nullptr;
+    uint64_t* ocupacion = nullptr;      // si no es nulo, suma de bus_cycles de las cachés
+};
+
+// Reparte `pp.n` elementos en `np` PEs, comprueba el resultado tras el
+// flush y devuelve el informe de ciclos.
+inline RunReport productoPuntoEn(Interconnect& bus, int np, const ProductoPunto& pp = {}) {
+    const int N = pp.n;
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    std::vector<std::unique_ptr<Cache2Way>> caches;
+    std::vector<std::unique_ptr<ProcessingElement>> pes;
+    for (int i = 0; i < N; i++) {
+        memoria.writeDouble(0x0400 + i * 8, i + 1.0);
+        memoria.writeDouble(0x0800 + i * 8, 2.0);
+    }
+    for (int i = 0; i < np; i++) {
+        caches.push_back(std::make_unique<Cache2Way>(adapter));
+        caches[i]->setId(i);
+        caches[i]->setBus(&bus);
+        bus.attach(caches[i].get());
+        pes.push_back(std::make_unique<ProcessingElement>(i));
+        pes[i]->setCache(caches[i].get());
+        if (pp.tiempo) pes[i]->setTiming(*pp.tiempo);
+        pes[i]->loadProgram(productoPunto());
+        pes[i]->setRegister(0, 0x0400 + i * (N / np) * 8);
+        pes[i]->setRegister(1, 0x0800 + i * (N / np) * 8);
+        pes[i]->setRegister(2, pp.sumas + i * pp.paso);
+        pes[i]->setRegister(3, N / np);
+    }
+    for (bool activo = true; activo;) {
+        activo = false;
+        for (auto& pe : pes)
+            if (!pe->hasFinished()) { pe->executeNextInstruction(); activo = true; }
+    }
+    for (auto& c : caches) c->flushAll();
+    double total = 0.0;
+    for (int i = 0; i < np; i++) total += memoria.readDouble(pp.sumas + i * pp.paso);
+    assert(total == 2.0 * N * (N + 1) / 2);
+
+    if (pp.ocupacion) {
+        *pp.ocupacion = 0;
+        for (auto& c : caches) *pp.ocupacion += c->getStats().bus_cycles;
+    }
+    std::vector<const ProcessingElement*> vista;
+    for (auto& pe : pes) vista.push_back(pe.get());
+    return makeRunReport(vista, &bus);
+}
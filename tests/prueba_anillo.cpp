@@ -0,0 +1,144 @@
+// prueba_anillo.cpp
+// Anillo bidireccional (ring.hpp).
+//  1) Geometría: distancias y ordering points repartidos en el anillo.
+//  2) Latencia de un miss: petición, snoop de media vuelta por sentido,
+//     respuestas y datos, salto por salto.
+//  3) Escalado de 4 a 32 PEs: producto punto sobre el bus atómico y sobre
+//     el anillo con 1 y 4 ordering points; ciclos totales y utilización
+//     del recurso más cargado (el bus o el enlace más ocupado).
+//  4) Hilos en paralelo con 4 ordering points: ninguna escritura se pierde.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "processing_element.hpp"
+#include "interconnect.hpp"
+#include "ring.hpp"
+#include "producto_punto.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <string>
+#include <cassert>
+
+static void geometria() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    RingInterconnect ring(RingConfig{ 1, 16, 4 });
+    std::vector<std::unique_ptr<Cache2Way>> caches;
+    for (int i = 0; i < 8; i++) {
+        caches.push_back(std::make_unique<Cache2Way>(adapter));
+        ring.attach(caches[i].get());
+    }
+    assert(ring.nodes() == 8);
+    assert(ring.distance(0, 5) == 3 && ring.distance(5, 0) == 3 && ring.distance(2, 3) == 1);
+    // Línea k -> ordering point k % 4, en los nodos 0, 2, 4 y 6
+    assert(ring.orderingNode(0 * 32) == 0 && ring.orderingNode(1 * 32) == 2);
+    assert(ring.orderingNode(3 * 32) == 6 && ring.orderingNode(4 * 32) == 0);
+    std::cout << "Geometría: OK\n";
+}
+
+static void latenciaMiss() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    const RingConfig rc{ 1, 16, 1 };
+    RingInterconnect ring(rc);
+    std::vector<std::unique_ptr<Cache2Way>> caches;
+    for (int i = 0; i < 4; i++) {
+        caches.push_back(std::make_unique<Cache2Way>(adapter));
+        caches[i]->setBus(&ring);
+        ring.attach(caches[i].get());
+    }
+    const TimingConfig tc;
+    uint64_t v;
+    caches[2]->load64(0x0, v);   // nodo 2, ordering point en el nodo 0
+
+    // 2 saltos hasta el nodo 0; snoop 2 saltos horario y 1 antihorario, y
+    // las respuestas de regreso; 32 B de datos (2 flits) por 2 saltos.
+    const uint64_t peticion = 2 * rc.hop_cycles;
+    const uint64_t snoop = 2 * rc.hop_cycles + tc.snoop_cycles + 2 * rc.hop_cycles;
+    const uint64_t datos = 2 * rc.hop_cycles + (32 / rc.link_bytes_per_cycle - 1);
+    const uint64_t esperado = tc.hit_cycles + peticion + snoop + datos + tc.mem_read_cycles + tc.fill_cycles;
+    std::cout << "Miss en el nodo 2 (4 nodos): " << caches[2]->clock() << " ciclos (esperado " << esperado << ")\n";
+    assert(caches[2]->clock() == esperado);
+    ring.dump(std::cout);
+    assert(ring.getStats().transactions == 1);
+    assert(ring.getStats().hops == 2 + 2 + 1 + 2 + 1 + 2);
+}
+
+static void escalado() {
+    std::cout << "\n" << std::setw(4) << "PEs"
+              << std::setw(12) << "bus" << std::setw(8) << "util%"
+              << std::setw(12) << "anillo/1" << std::setw(8) << "max%"
+              << std::setw(12) << "anillo/4" << std::setw(8) << "max%" << "\n";
+    const ProductoPunto anillo{ 128, 0x0C00, 32 };   // una suma parcial por línea
+    for (int np : { 4, 8, 16, 32 }) {
+        Interconnect bus;
+        RingInterconnect r1(RingConfig{ 1, 16, 1 });
+        RingInterconnect r4(RingConfig{ 1, 16, 4 });
+        const RunReport rb = productoPuntoEn(bus, np, anillo);
+        const RunReport a1 = productoPuntoEn(r1, np, anillo);
+        const RunReport a4 = productoPuntoEn(r4, np, anillo);
+        std::cout << std::fixed << std::setprecision(1) << std::setw(4) << np
+                  << std::setw(12) << rb.total_cycles << std::setw(8) << 100.0 * rb.busUtilization()
+                  << std::setw(12) << a1.total_cycles << std::setw(8) << 100.0 * a1.busUtilization()
+                  << std::setw(12) << a4.total_cycles << std::setw(8) << 100.0 * a4.busUtilization() << "\n";
+        // Con ordering points repartidos ningún enlace carga todo el tráfico
+        assert(a4.busUtilization() <= a1.busUtilization());
+        if (np == 8) {
+            std::cout << "\n";
+            r4.dump(std::cout, a4.total_cycles);
+            std::cout << "\n";
+        }
+    }
+}
+
+static void paralelo() {
+    const int NC = 4, LINEAS = 8, ITER = 20000;
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    RingInterconnect ring(RingConfig{ 1, 16, 4 });
+    std::vector<std::unique_ptr<Cache2Way>> caches;
+    for (int i = 0; i < NC; i++) {
+        caches.push_back(std::make_unique<Cache2Way>(adapter));
+        caches[i]->setId(i);
+        caches[i]->setBus(&ring);
+        ring.attach(caches[i].get());
+    }
+    std::atomic<int> listos{0};
+    std::vector<std::thread> hilos;
+    for (int i = 0; i < NC; i++) {
+        hilos.emplace_back([&, i] {
+            listos++;
+            while (listos.load() < NC) std::this_thread::yield();
+            for (int k = 1; k <= ITER; k++)
+                for (int l = 0; l < LINEAS; l++) caches[i]->storeDouble(l * 32 + i * 8, k * 10.0 + i);
+        });
+    }
+    for (auto& h : hilos) h.join();
+    for (auto& c : caches) c->flushAll();
+    int perdidas = 0;
+    for (int l = 0; l < LINEAS; l++)
+        for (int i = 0; i < NC; i++)
+            if (memoria.readDouble(l * 32 + i * 8) != ITER * 10.0 + i) perdidas++;
+    std::cout << "Paralelo, 4 ordering points: " << ring.getStats().transactions
+              << " transacciones, escrituras perdidas: " << perdidas << "\n";
+    assert(perdidas == 0);
+}
+
+int main() {
+    geometria();
+    latenciaMiss();
+    escalado();
+    paralelo();
+    std::cout << "\nOK\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_anillo.cpp cache.cpp main_memory.cpp processing_element.cpp ring.cpp -o prueba_anillo
+//./prueba_anillo
@@ -0,0 +1,67 @@
+// prueba_burst.cpp
+// Transferencias de línea completa (readLine/writeLine) en MainMemory y
+// MainMemoryAdapter: contenido, conteo de ráfagas, errores de rango y que
+// cada llenado/writeback de la caché sea una sola ráfaga.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+
+#include <iostream>
+#include <cstring>
+#include <stdexcept>
+#include <cassert>
+
+int main() {
+    std::cout << "=== Ráfagas de línea en MainMemory ===\n\n";
+
+    MainMemory memoria;
+    for (int i = 0; i < 8; i++) memoria.writeWord(0x40 + i * 8, 100 + i);
+    memoria.resetStats();
+
+    uint8_t linea[32];
+    memoria.readLine(0x40, linea, 32);
+    for (int i = 0; i < 4; i++) {
+        uint64_t w = 0;
+        std::memcpy(&w, linea + i * 8, 8);
+        assert(w == uint64_t(100 + i));
+    }
+    assert(memoria.getBurstReadCount() == 1);
+    assert(memoria.getReadCount() == 4);
+
+    uint64_t nuevos[4] = {7, 8, 9, 10};
+    memoria.writeLine(0x60, reinterpret_cast<const uint8_t*>(nuevos), 32);
+    assert(memoria.readWord(0x78) == 10);
+    assert(memoria.getBurstWriteCount() == 1);
+    assert(memoria.getWriteCount() == 4);
+    std::cout << "readLine/writeLine: OK\n";
+
+    bool fuera = false, desalineada = false;
+    try { memoria.readLine(0xFF0, linea, 32); } catch (const std::out_of_range&) { fuera = true; }
+    try { memoria.readLine(0x44, linea, 32); } catch (const std::runtime_error&) { desalineada = true; }
+    assert(fuera && desalineada);
+    std::cout << "Verificación de rango y alineación: OK\n";
+
+    // La caché llena y escribe líneas completas a través del adaptador
+    memoria.resetStats();
+    MainMemoryAdapter adapter(memoria);
+    Cache<8, 2, 32> cache(adapter);
+    double v = 0.0;
+    for (uint64_t a = 0; a < 0x400; a += 8) cache.loadDouble(a, v);
+    cache.storeDouble(0x000, 1.0);
+    cache.flushAll();
+    auto st = cache.getStats();
+    assert(memoria.getBurstReadCount() == st.line_fills);
+    assert(memoria.getBurstWriteCount() == st.writebacks);
+    assert(memoria.getReadCount() == st.mem_reads);
+    std::cout << "Caché: " << st.line_fills << " llenados = " << memoria.getBurstReadCount()
+              << " ráfagas de lectura, " << st.writebacks << " writeback(s) = "
+              << memoria.getBurstWriteCount() << " ráfaga(s) de escritura\n";
+
+    std::cout << "\n=== Prueba de ráfagas completada ===\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_burst.cpp cache.cpp main_memory.cpp processing_element.cpp -o prueba_burst
+//./prueba_burst
@@ -0,0 +1,159 @@
+// prueba_bus_partido.cpp
+// Bus de transacciones partidas (split_bus.hpp).
+//  1) Árbitros: RoundRobin rota, FixedPriority elige el id menor y Age la
+//     petición más antigua.
+//  2) Hilos en paralelo escribiendo palabras distintas de las mismas líneas
+//     (falso compartir): con el bus partido ninguna escritura se pierde, a
+//     lo sumo una caché queda con cada línea en M/E y el orden global
+//     registra todas las transacciones.
+//  3) Arbitraje bajo contención: concesiones por caché con cada árbitro.
+//  4) Tiempo simulado: producto punto con 4 PEs sobre bus atómico y bus
+//     partido (dirección y datos solapados).
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "processing_element.hpp"
+#include "interconnect.hpp"
+#include "split_bus.hpp"
+#include "producto_punto.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <cassert>
+
+static void arbitros() {
+    const ArbiterRequest c[] = { { 0, 9 }, { 2, 4 }, { 3, 7 } };
+    RoundRobinArbiter rr;
+    assert(rr.pick(c, 3) == 0);   // primero el id menor
+    assert(rr.pick(c, 3) == 1);   // luego el siguiente después de C0
+    assert(rr.pick(c, 3) == 2);
+    assert(rr.pick(c, 3) == 0);   // vuelve a empezar
+    FixedPriorityArbiter fp;
+    assert(fp.pick(c, 3) == 0 && fp.pick(c, 3) == 0);
+    AgeArbiter age;
+    assert(age.pick(c, 3) == 1);  // ticket 4
+    assert(makeArbiter(ArbiterKind::Age)->kind() == ArbiterKind::Age);
+    std::cout << "Árbitros: OK\n";
+}
+
+// NC hilos; el hilo i escribe la palabra i de cada una de las LINEAS líneas
+// (y lee la de su vecino) ITER veces. Devuelve cuántas palabras quedaron
+// mal en memoria.
+template <class Bus>
+static int falsoCompartir(Bus& bus, bool verificar_estados) {
+    const int NC = 4, LINEAS = 4, ITER = 50000;
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    std::vector<std::unique_ptr<Cache2Way>> caches;
+    for (int i = 0; i < NC; i++) {
+        caches.push_back(std::make_unique<Cache2Way>(adapter));
+        caches[i]->setId(i);
+        caches[i]->setBus(&bus);
+        bus.attach(caches[i].get());
+    }
+
+    std::atomic<int> listos{0};
+    std::vector<std::thread> hilos;
+    for (int i = 0; i < NC; i++) {
+        hilos.emplace_back([&, i] {
+            double v;
+            // Todos arrancan juntos para que compitan por el bus
+            listos++;
+            while (listos.load() < NC) std::this_thread::yield();
+            for (int k = 1; k <= ITER; k++)
+                for (int l = 0; l < LINEAS; l++) {
+                    caches[i]->storeDouble(l * 32 + i * 8, k * 10.0 + i);
+                    caches[i]->loadDouble(l * 32 + ((i + 1) % NC) * 8, v);
+                }
+        });
+    }
+    for (auto& h : hilos) h.join();
+
+    if (verificar_estados) {
+        for (int l = 0; l < LINEAS; l++) {
+            int duenas = 0, validas = 0;
+            for (auto& c : caches) {
+                const auto st = c->getLineMESI(l * 32);
+                if (!st || *st == ICache::MESI::I) continue;
+                validas++;
+                if (*st == ICache::MESI::M || *st == ICache::MESI::E) duenas++;
+            }
+            assert(duenas <= 1 && (duenas == 0 || validas == 1));
+        }
+    }
+
+    for (auto& c : caches) c->flushAll();
+    int perdidas = 0;
+    for (int l = 0; l < LINEAS; l++)
+        for (int i = 0; i < NC; i++)
+            if (memoria.readDouble(l * 32 + i * 8) != ITER * 10.0 + i) perdidas++;
+    return perdidas;
+}
+
+static void coherenciaEnParalelo() {
+    SplitTransactionBus partido;
+    partido.recordOrder(true);
+    const int perdidas = falsoCompartir(partido, true);
+    const auto st = partido.getStats();
+    const auto orden = partido.serialOrder();
+    std::cout << "\nFalso compartir, 4 hilos en paralelo:\n";
+    partido.dump(std::cout);
+    std::cout << "  escrituras perdidas: " << perdidas << "\n";
+    assert(perdidas == 0);
+    assert(orden.size() == st.transactions && st.transactions > 0);
+    for (size_t k = 0; k < orden.size(); k++) assert(orden[k].seq == k);
+    assert(partido.pendingLines() == 0);
+    uint64_t concedidas = 0;
+    for (uint64_t g : partido.grantsPerClient()) concedidas += g;
+    assert(concedidas == st.transactions);
+}
+
+static void arbitrajeBajoContencion() {
+    std::cout << "\n" << std::left << std::setw(15) << "Árbitro" << std::right
+              << std::setw(9) << "trans" << std::setw(9) << "encol"
+              << std::setw(8) << "C0" << std::setw(8) << "C1" << std::setw(8) << "C2" << std::setw(8) << "C3" << "\n";
+    for (ArbiterKind k : { ArbiterKind::RoundRobin, ArbiterKind::FixedPriority, ArbiterKind::Age }) {
+        SplitTransactionBus bus(SplitBusConfig{ k });
+        assert(falsoCompartir(bus, false) == 0);
+        const auto st = bus.getStats();
+        std::cout << std::left << std::setw(14) << arbiterName(k) << std::right
+                  << std::setw(9) << st.transactions << std::setw(9) << st.queued;
+        for (uint64_t g : bus.grantsPerClient()) std::cout << std::setw(8) << g;
+        std::cout << "\n";
+    }
+}
+
+static void tiempoSimulado() {
+    Interconnect atomico;
+    SplitTransactionBus partido;
+    const ProductoPunto pp{ 64, 0x0100, 64 };
+    const RunReport ra = productoPuntoEn(atomico, 4, pp);
+    const RunReport rp = productoPuntoEn(partido, 4, pp);
+
+    std::cout << "\n-- Bus atómico --\n";
+    ra.print(std::cout);
+    std::cout << "-- Bus partido (dirección " << partido.addressBusyCycles()
+              << " ciclos, datos " << partido.dataBusyCycles() << " ciclos) --\n";
+    rp.print(std::cout);
+    assert(partido.addressBusyCycles() + partido.dataBusyCycles() == atomico.busyCycles());
+    assert(rp.total_cycles <= ra.total_cycles);
+    assert(rp.busUtilization() < ra.busUtilization());
+}
+
+int main() {
+    arbitros();
+    coherenciaEnParalelo();
+    arbitrajeBajoContencion();
+    tiempoSimulado();
+    std::cout << "\nOK\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_bus_partido.cpp cache.cpp main_memory.cpp processing_element.cpp split_bus.cpp -o prueba_bus_partido
+//./prueba_bus_partido
@@ -0,0 +1,109 @@
+// prueba_c2c.cpp
+// Transferencias caché a caché. Dos patrones sobre 4 cachés, varias rondas:
+//   - cadena de escritores: cada caché escribe la línea (BusRdX sobre M)
+//   - contador migratorio: load + store en cada caché (BusRd sobre M)
+// La copia sucia viaja por el bus en la respuesta del snoop; memoria solo
+// se actualiza cuando el protocolo lo exige o con setC2CUpdatesMemory(true).
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "interconnect.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <cassert>
+
+static void transferencias(bool migratorio, CoherenceProtocol proto, bool actualiza_memoria) {
+    const int NC = 4;
+    const int RONDAS = 16;
+
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    std::vector<std::unique_ptr<Cache2Way>> caches;
+    for (int i = 0; i < NC; i++) {
+        caches.push_back(std::make_unique<Cache2Way>(adapter));
+        caches[i]->setId(i);
+        caches[i]->setBus(&bus);
+        caches[i]->setProtocol(proto);
+        caches[i]->setC2CUpdatesMemory(actualiza_memoria);
+        bus.attach(caches[i].get());
+    }
+
+    for (int r = 0; r < RONDAS; r++) {
+        for (int i = 0; i < NC; i++) {
+            double v = r * NC + i;
+            if (migratorio) caches[i]->loadDouble(0x80, v), v += 1.0;
+            caches[i]->storeDouble(0x80, v);
+        }
+    }
+    for (auto& c : caches) c->flushAll();
+    assert(memoria.readDouble(0x80) == (migratorio ? RONDAS * NC : RONDAS * NC - 1));
+
+    ICache::Stats tot;
+    for (auto& c : caches) {
+        auto st = c->getStats();
+        tot.c2c_fills += st.c2c_fills;
+        tot.mem_fills += st.mem_fills;
+        tot.c2c_supplied += st.c2c_supplied;
+        tot.line_fills += st.line_fills;
+    }
+    assert(tot.c2c_fills == tot.c2c_supplied);
+    assert(tot.c2c_fills + tot.mem_fills == tot.line_fills);
+
+    std::cout << std::left << std::setw(12) << (migratorio ? "migratorio" : "escritores")
+              << std::setw(8) << protocolName(proto)
+              << std::setw(actualiza_memoria ? 9 : 8) << (actualiza_memoria ? "sí" : "no") << std::right
+              << std::setw(10) << tot.c2c_fills << std::setw(10) << tot.mem_fills
+              << std::setw(12) << memoria.getBurstReadCount()
+              << std::setw(12) << memoria.getBurstWriteCount()
+              << std::setw(10) << memoria.readDouble(0x80) << "\n";
+}
+
+// En MESI una lectura sobre M deja dos copias S: memoria debe quedar al día
+// aunque el dato llegue por el bus.
+static void lecturaSobreM() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    Cache2Way c0(adapter), c1(adapter);
+    c0.setId(0); c0.setBus(&bus); bus.attach(&c0);
+    c1.setId(1); c1.setBus(&bus); bus.attach(&c1);
+
+    double v = 0.0;
+    c0.storeDouble(0x40, 9.0);
+    const uint64_t lecturas = memoria.getBurstReadCount();
+    c1.loadDouble(0x40, v);
+    assert(v == 9.0);
+    assert(memoria.getBurstReadCount() == lecturas);   // sin lectura de memoria
+    assert(memoria.readDouble(0x40) == 9.0);           // pero sí el flush
+    assert(c0.getLineMESI(0x40) == ICache::MESI::S);
+    assert(c1.getLineMESI(0x40) == ICache::MESI::S);
+    assert(c1.getStats().c2c_fills == 1 && c0.getStats().c2c_supplied == 1);
+    std::cout << "Lectura sobre M: dato por el bus, memoria actualizada, M->S\n";
+}
+
+int main() {
+    std::cout << "=== Transferencias caché a caché (4 cachés, 16 rondas) ===\n\n";
+    std::cout << std::left << std::setw(13) << "Patrón" << std::setw(8) << "Modo" << std::setw(8) << "MemUpd" << std::right
+              << std::setw(10) << "C2C" << std::setw(10) << "MemFills"
+              << std::setw(13) << "MemR (lín.)" << std::setw(13) << "MemW (lín.)"
+              << std::setw(10) << "Final" << "\n";
+    for (bool migratorio : { false, true }) {
+        for (auto proto : { CoherenceProtocol::MESI, CoherenceProtocol::MOESI, CoherenceProtocol::MESIF }) {
+            transferencias(migratorio, proto, false);
+            transferencias(migratorio, proto, true);
+        }
+    }
+    std::cout << "\n";
+    lecturaSobreM();
+    std::cout << "\n=== Prueba C2C completada ===\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_c2c.cpp cache.cpp main_memory.cpp processing_element.cpp -o prueba_c2c
+//./prueba_c2c
@@ -0,0 +1,146 @@
+// prueba_directorio.cpp
+// Directorio (DirectoryInterconnect) frente al bus de snooping con 4 a 256
+// cachés. Misma carga en ambos:
+//   1) todas leen una tabla compartida de 8 líneas
+//   2) cada caché escribe su palabra en una línea de trabajo (hasta 4 por línea)
+//   3) la caché 0 reescribe la tabla (invalida a todos los lectores)
+//   4) bloques contiguos de N/8 cachés leen cada uno su línea de grupo y
+//      una caché del bloque la reescribe (invalida solo a su bloque)
+// Se comparan los snoops que recibe cada caché y se verifica que memoria y
+// estadísticas de coherencia coincidan con el bus.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "interconnect.hpp"
+#include "directory.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <cassert>
+
+static const uint64_t TABLA = 96 * 32;   // líneas 96..103
+static const int LINEAS_TABLA = 8;
+static const uint64_t GRUPOS = 104 * 32;  // líneas 104..111
+
+struct Resultado {
+    uint64_t transacciones = 0;
+    uint64_t snoops = 0;
+    uint64_t misses = 0;
+    uint64_t bus_upgr = 0;
+    std::vector<double> memoria;
+};
+
+static Resultado correr(int nc, std::optional<DirectoryConfig> dir_cfg, DirectoryInterconnect::Stats* dir_stats) {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    std::unique_ptr<Interconnect> bus;
+    if (dir_cfg) bus = std::make_unique<DirectoryInterconnect>(*dir_cfg);
+    else         bus = std::make_unique<Interconnect>();
+
+    std::vector<std::unique_ptr<Cache2Way>> caches;
+    for (int i = 0; i < nc; i++) {
+        caches.push_back(std::make_unique<Cache2Way>(adapter));
+        caches[i]->setId(i);
+        caches[i]->setBus(bus.get());
+        bus->attach(caches[i].get());
+    }
+    for (int l = 0; l < LINEAS_TABLA * 4; l++) memoria.writeDouble(TABLA + l * 8, l);
+
+    double v = 0.0;
+    for (auto& c : caches)
+        for (int l = 0; l < LINEAS_TABLA; l++) { c->loadDouble(TABLA + l * 32, v); assert(v == l * 4); }
+    for (int i = 0; i < nc; i++) {
+        const uint64_t addr = (i % 64) * 32 + (i / 64) * 8;
+        caches[i]->loadDouble(addr, v);
+        caches[i]->storeDouble(addr, 1000.0 + i);
+    }
+    for (int l = 0; l < LINEAS_TABLA; l++) caches[0]->storeDouble(TABLA + l * 32, -1.0 - l);
+    const int bloque = nc >= 8 ? nc / 8 : 1;
+    for (int i = 0; i < nc; i++) caches[i]->loadDouble(GRUPOS + (i / bloque) * 32, v);
+    for (int g = 0; g * bloque < nc; g++) caches[g * bloque + bloque / 2]->storeDouble(GRUPOS + g * 32 + 8, 50.0 + g);
+    for (auto& c : caches) c->flushAll();
+
+    Resultado r;
+    for (auto& c : caches) {
+        const auto st = c->getStats();
+        r.transacciones += st.bus_rd + st.bus_rdx + st.bus_upgr + st.bus_inv;
+        r.misses += st.misses;
+        r.bus_upgr += st.bus_upgr;
+    }
+    if (dir_cfg) {
+        *dir_stats = static_cast<DirectoryInterconnect&>(*bus).getStats();
+        r.snoops = dir_stats->messages;
+    } else {
+        r.snoops = r.transacciones * (nc - 1);
+    }
+    for (uint64_t a = 0; a < 4096; a += 8) r.memoria.push_back(memoria.readDouble(a));
+    for (int i = 0; i < nc; i++) assert(memoria.readDouble((i % 64) * 32 + (i / 64) * 8) == 1000.0 + i);
+    for (int l = 0; l < LINEAS_TABLA; l++) assert(memoria.readDouble(TABLA + l * 32) == -1.0 - l);
+    for (int g = 0; g * (nc >= 8 ? nc / 8 : 1) < nc; g++) assert(memoria.readDouble(GRUPOS + g * 32 + 8) == 50.0 + g);
+    return r;
+}
+
+int main() {
+    std::cout << "=== Directorio vs broadcast (Cache2Way, MESI) ===\n\n";
+    std::cout << std::left << std::setw(8) << "Cachés" << std::setw(24) << "Motor" << std::right
+              << std::setw(8) << "Trans." << std::setw(10) << "Snoops"
+              << std::setw(10) << "Snp/tr" << std::setw(11) << "Desbordes" << "\n";
+
+    const std::vector<std::pair<const char*, DirectoryConfig>> formatos = {
+        { "FullMap",            DirectoryConfig{ DirectoryFormat::FullMap } },
+        { "LimitedPtr (4)",     DirectoryConfig{ DirectoryFormat::LimitedPointer, 4 } },
+        { "CoarseVec (4, g=8)", DirectoryConfig{ DirectoryFormat::CoarseVector, 4, 8 } },
+    };
+
+    for (int nc : { 4, 16, 64, 256 }) {
+        const Resultado base = correr(nc, std::nullopt, nullptr);
+        std::cout << std::left << std::setw(7) << nc << std::setw(24) << "Broadcast" << std::right
+                  << std::setw(8) << base.transacciones << std::setw(10) << base.snoops
+                  << std::setw(10) << std::fixed << std::setprecision(1)
+                  << double(base.snoops) / base.transacciones << std::setw(11) << "-" << "\n";
+        for (const auto& [nombre, cfg] : formatos) {
+            DirectoryInterconnect::Stats ds;
+            const Resultado r = correr(nc, cfg, &ds);
+            // Mismo resultado y mismo tráfico de coherencia que el bus
+            assert(r.memoria == base.memoria);
+            assert(r.transacciones == base.transacciones && r.misses == base.misses && r.bus_upgr == base.bus_upgr);
+            assert(ds.requests == r.transacciones);
+            assert(r.snoops <= base.snoops);
+            std::cout << std::left << std::setw(7) << nc << std::setw(24) << nombre << std::right
+                      << std::setw(8) << r.transacciones << std::setw(10) << r.snoops
+                      << std::setw(10) << double(r.snoops) / r.transacciones
+                      << std::setw(11) << ds.overflows << "\n";
+        }
+        std::cout.unsetf(std::ios::fixed);
+    }
+
+    // Full-map registra exactamente a los lectores
+    {
+        MainMemory memoria;
+        MainMemoryAdapter adapter(memoria);
+        DirectoryInterconnect dir;
+        Cache2Way c0(adapter), c1(adapter), c2(adapter);
+        Cache2Way* cs[] = { &c0, &c1, &c2 };
+        for (int i = 0; i < 3; i++) { cs[i]->setId(i); cs[i]->setBus(&dir); dir.attach(cs[i]); }
+        double v;
+        c0.loadDouble(0x40, v);
+        c2.loadDouble(0x40, v);
+        assert((dir.sharers(0x40) == std::vector<uint32_t>{ 0, 2 }));
+        c1.storeDouble(0x40, 5.0);
+        assert((dir.sharers(0x40) == std::vector<uint32_t>{ 1 }));
+        assert(!c0.getLineMESI(0x40) && !c2.getLineMESI(0x40));
+        std::cout << "\n";
+        dir.dump(std::cout);
+    }
+
+    std::cout << "\n=== Prueba de directorio completada ===\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_directorio.cpp cache.cpp directory.cpp main_memory.cpp processing_element.cpp -o prueba_directorio
+//./prueba_directorio
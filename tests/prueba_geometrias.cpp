@@ -0,0 +1,134 @@
+// prueba_geometrias.cpp
+// Barrido de geometrías de caché con la fábrica makeCache().
+// Un solo binario recorre todas las especializaciones de CACHE_GEOMETRIES
+// y ejecuta el mismo producto punto sobre cada una.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "processing_element.hpp"
+#include "interconnect.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <cassert>
+
+static std::vector<Instruction> programaProductoPunto() {
+    std::vector<Instruction> code;
+    code.push_back({InstructionType::LOAD, 4, 2, 0, 0});
+    int loop_start = (int)code.size();
+    code.push_back({InstructionType::LOAD, 5, 0, 0, 0});
+    code.push_back({InstructionType::LOAD, 6, 1, 0, 0});
+    code.push_back({InstructionType::FMUL, 7, 5, 6, 0});
+    code.push_back({InstructionType::FADD, 4, 4, 7, 0});
+    code.push_back({InstructionType::INC, 0, 0, 0, 0});
+    code.push_back({InstructionType::INC, 1, 0, 0, 0});
+    code.push_back({InstructionType::DEC, 3, 0, 0, 0});
+    code.push_back({InstructionType::JNZ, 3, 0, 0, loop_start});
+    code.push_back({InstructionType::STORE, 4, 2, 0, 0});
+    return code;
+}
+
+int main(int argc, char** argv) {
+    const int NPE = 4;
+    const int N = 128;  // A y B ocupan 2 KB de los 4 KB de memoria
+    const uint64_t addr_A = 0x0000;
+    const uint64_t addr_B = 0x0080 + N * 8;
+    const uint64_t addr_P = 0x0080 + 2 * N * 8;
+
+    // Sin argumentos se barren todas las geometrías; con argumentos, solo las indicadas
+    std::vector<CacheConfig> configs;
+    for (int i = 1; i < argc; i++) configs.push_back(CacheConfig::parse(argv[i]));
+    if (configs.empty()) configs = supportedCacheConfigs();
+
+    std::cout << "=== Barrido de geometrías (N=" << N << ", " << NPE << " PEs) ===\n\n";
+    std::cout << std::left << std::setw(16) << "Geometría" << std::right
+              << std::setw(10) << "Tamaño" << std::setw(10) << "Hits"
+              << std::setw(10) << "Misses" << std::setw(10) << "Hit %"
+              << std::setw(12) << "Resultado" << "\n";
+
+    for (const auto& cfg : configs) {
+        MainMemory memoria;
+        MainMemoryAdapter adapter(memoria);
+        Interconnect bus;
+
+        std::vector<std::unique_ptr<ICache>> caches;
+        std::vector<std::unique_ptr<ProcessingElement>> pes;
+        for (int i = 0; i < NPE; i++) {
+            caches.push_back(makeCache(cfg, adapter));
+            caches[i]->setId(i);
+            caches[i]->setBus(&bus);
+            bus.attach(caches[i].get());
+            pes.push_back(std::make_unique<ProcessingElement>(i));
+            pes[i]->setCache(caches[i].get());
+        }
+        assert(caches[0]->numSets() == cfg.sets);
+        assert(caches[0]->numWays() == cfg.ways);
+        assert(caches[0]->lineBytes() == cfg.line_bytes);
+        assert(caches[0]->replacement() == cfg.replacement);
+
+        double esperado = 0.0;
+        for (int i = 0; i < N; i++) {
+            memoria.writeDouble(addr_A + i * 8, i + 1.0);
+            memoria.writeDouble(addr_B + i * 8, 2.0);
+            esperado += (i + 1.0) * 2.0;
+        }
+
+        const int por_pe = N / NPE;
+        for (int p = 0; p < NPE; p++) {
+            memoria.writeDouble(addr_P + p * 64, 0.0);
+            pes[p]->setRegister(0, addr_A + p * por_pe * 8);
+            pes[p]->setRegister(1, addr_B + p * por_pe * 8);
+            pes[p]->setRegister(2, addr_P + p * 64);
+            pes[p]->setRegister(3, por_pe);
+            pes[p]->loadProgram(programaProductoPunto());
+        }
+
+        bool vivos = true;
+        while (vivos) {
+            vivos = false;
+            for (auto& pe : pes) {
+                if (!pe->hasFinished()) { pe->executeNextInstruction(); vivos = true; }
+            }
+        }
+        for (auto& c : caches) c->flushAll();
+
+        double total = 0.0;
+        uint64_t hits = 0, misses = 0;
+        for (int p = 0; p < NPE; p++) {
+            total += memoria.readDouble(addr_P + p * 64);
+            auto st = caches[p]->getStats();
+            hits += st.hits;
+            misses += st.misses;
+        }
+        assert(std::abs(total - esperado) < 1e-6);
+
+        std::cout << std::left << std::setw(16) << cfg.toString() << std::right
+                  << std::setw(9) << (cfg.sizeBytes() >= 1024 ? cfg.sizeBytes() / 1024 : cfg.sizeBytes())
+                  << (cfg.sizeBytes() >= 1024 ? "K" : "B")
+                  << std::setw(10) << hits << std::setw(10) << misses
+                  << std::setw(9) << std::fixed << std::setprecision(1)
+                  << 100.0 * hits / (hits + misses) << "%"
+                  << std::setw(12) << std::setprecision(1) << total << "\n";
+        std::cout.unsetf(std::ios::fixed);
+        std::cout << std::setprecision(6);
+    }
+
+    // Una geometría fuera de la lista debe rechazarse
+    MainMemory mm;
+    MainMemoryAdapter ad(mm);
+    bool rechazada = false;
+    try { makeCache(CacheConfig{12, 3, 48}, ad); } catch (const std::invalid_argument&) { rechazada = true; }
+    assert(rechazada);
+
+    std::cout << "\n=== Barrido completado ===\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_geometrias.cpp cache.cpp main_memory.cpp processing_element.cpp -o prueba_geometrias
+//./prueba_geometrias            (todas las geometrías)
+//./prueba_geometrias 64x8x64    (solo las indicadas)
@@ -0,0 +1,302 @@
+// prueba_l2.cpp
+// L2 compartida (SharedL2) entre dos Cache2Way y MainMemory.
+// El producto punto se ejecuta dos veces seguidas: la segunda pasada ya no
+// cabe en las L1 (512 B cada una) pero sí en la L2, así que el tráfico a
+// memoria principal cae. Se comparan las tres políticas de inclusión
+// contra el sistema sin L2, y se verifican las back-invalidations de la
+// política inclusiva (también con una L1 inactiva y con hilos en paralelo),
+// el llenado con víctimas de la exclusiva y que ninguna política acepta una
+// L1 con líneas mayores que las de la L2.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "l2_cache.hpp"
+#include "processing_element.hpp"
+#include "interconnect.hpp"
+#include "split_bus.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <cmath>
+#include <thread>
+#include <atomic>
+#include <stdexcept>
+#include <cassert>
+
+static std::vector<Instruction> programaProductoPunto() {
+    std::vector<Instruction> code;
+    code.push_back({InstructionType::LOAD, 4, 2, 0, 0});
+    int loop_start = (int)code.size();
+    code.push_back({InstructionType::LOAD, 5, 0, 0, 0});
+    code.push_back({InstructionType::LOAD, 6, 1, 0, 0});
+    code.push_back({InstructionType::FMUL, 7, 5, 6, 0});
+    code.push_back({InstructionType::FADD, 4, 4, 7, 0});
+    code.push_back({InstructionType::INC, 0, 0, 0, 0});
+    code.push_back({InstructionType::INC, 1, 0, 0, 0});
+    code.push_back({InstructionType::DEC, 3, 0, 0, 0});
+    code.push_back({InstructionType::JNZ, 3, 0, 0, loop_start});
+    code.push_back({InstructionType::STORE, 4, 2, 0, 0});
+    return code;
+}
+
+static void productoPunto(std::optional<InclusionPolicy> politica) {
+    const int NPE = 2;
+    const int N = 128;
+    const uint64_t addr_A = 0x0000;
+    const uint64_t addr_B = 0x0080 + N * 8;
+    const uint64_t addr_P = 0x0080 + 2 * N * 8;
+
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    std::unique_ptr<SharedL2> l2;
+    if (politica) l2 = std::make_unique<SharedL2>(adapter, L2Config{4, 8, 4, 32, *politica});
+    IMainMemory& siguiente = l2 ? static_cast<IMainMemory&>(*l2) : adapter;
+    Interconnect bus;
+
+    std::vector<std::unique_ptr<Cache2Way>> caches;
+    std::vector<std::unique_ptr<ProcessingElement>> pes;
+    for (int i = 0; i < NPE; i++) {
+        caches.push_back(std::make_unique<Cache2Way>(siguiente));
+        caches[i]->setId(i);
+        caches[i]->setBus(&bus);
+        bus.attach(caches[i].get());
+        if (l2) l2->attachL1(caches[i].get());
+        pes.push_back(std::make_unique<ProcessingElement>(i));
+        pes[i]->setCache(caches[i].get());
+    }
+
+    double esperado = 0.0;
+    for (int i = 0; i < N; i++) {
+        memoria.writeDouble(addr_A + i * 8, i + 1.0);
+        memoria.writeDouble(addr_B + i * 8, 2.0);
+        esperado += (i + 1.0) * 2.0;
+    }
+    memoria.resetStats();
+
+    const int por_pe = N / NPE;
+    for (int pasada = 0; pasada < 2; pasada++) {
+        for (int p = 0; p < NPE; p++) {
+            pes[p]->setRegister(0, addr_A + p * por_pe * 8);
+            pes[p]->setRegister(1, addr_B + p * por_pe * 8);
+            pes[p]->setRegister(2, addr_P + p * 64);
+            pes[p]->setRegister(3, por_pe);
+            pes[p]->loadProgram(programaProductoPunto());
+        }
+        bool vivos = true;
+        while (vivos) {
+            vivos = false;
+            for (auto& pe : pes) {
+                if (!pe->hasFinished()) { pe->executeNextInstruction(); vivos = true; }
+            }
+        }
+    }
+    for (auto& c : caches) c->flushAll();
+    if (l2) l2->flushAll();
+
+    // La suma parcial se acumula sobre la de la primera pasada
+    double total = 0.0;
+    uint64_t l1_misses = 0, back_inv = 0;
+    for (int p = 0; p < NPE; p++) {
+        total += memoria.readDouble(addr_P + p * 64);
+        l1_misses += caches[p]->getStats().misses;
+        back_inv += caches[p]->getStats().back_invalidations;
+    }
+    assert(std::abs(total - 2 * esperado) < 1e-6);
+
+    std::cout << std::left << std::setw(12) << (politica ? inclusionName(*politica) : "Sin L2") << std::right
+              << std::setw(10) << l1_misses;
+    if (l2) {
+        auto st = l2->getStats();
+        assert(st.hits + st.misses == st.reads + st.writes);
+        std::cout << std::setw(8) << st.hits << std::setw(8) << st.misses
+                  << std::setw(8) << std::fixed << std::setprecision(1) << 100.0 * st.hitRate() << "%"
+                  << std::setw(8) << st.back_invalidations << std::setw(8) << back_inv;
+        std::cout.unsetf(std::ios::fixed);
+        std::cout << std::setprecision(6);
+    } else {
+        std::cout << std::setw(8) << "-" << std::setw(8) << "-" << std::setw(9) << "-"
+                  << std::setw(8) << "-" << std::setw(8) << "-";
+    }
+    std::cout << std::setw(10) << memoria.getReadCount() << std::setw(10) << memoria.getWriteCount()
+              << std::setw(10) << total << "\n";
+}
+
+static void pruebaBackInvalidation() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    SharedL2 l2(adapter, L2Config{1, 1, 2, 32, InclusionPolicy::Inclusive});
+    Cache2Way c0(l2);
+    l2.attachL1(&c0);
+
+    // 0x000, 0x020 y 0x040 van a sets distintos de la L1 pero al único set de la L2
+    double v = 0.0;
+    c0.storeDouble(0x0000, 6.0);        // M en la L1
+    c0.loadDouble(0x0020, v);
+    c0.loadDouble(0x0040, v);           // la L2 desaloja 0x000 -> back-invalidation
+    assert(!l2.contains(0x0000));
+    assert(!c0.getLineMESI(0x0000).has_value());   // ya al terminar el acceso
+    assert(c0.getStats().back_invalidations == 1);
+    assert(memoria.readDouble(0x0000) == 6.0);   // el dato sucio llegó a memoria
+    assert(l2.getStats().write_through == 1);
+    std::cout << "Back-invalidation inclusiva: OK (línea M escrita a memoria)\n";
+}
+
+// c0 y c1 comparten 0x000; solo c1 sigue trabajando y hace que la L2 la
+// desaloje. c0 no vuelve a acceder, y aun así ya no tiene la línea ni la
+// entrega a c1 cuando la vuelve a pedir.
+static void pruebaL1Inactiva() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    SharedL2 l2(adapter, L2Config{1, 1, 2, 32, InclusionPolicy::Inclusive});
+    Interconnect bus;
+    Cache2Way c0(l2), c1(l2);
+    for (Cache2Way* c : { &c0, &c1 }) {
+        c->setBus(&bus);
+        bus.attach(c);
+        l2.attachL1(c);
+    }
+    memoria.writeDouble(0x0000, 2.5);
+
+    double v = 0.0;
+    c0.loadDouble(0x0000, v);
+    c1.loadDouble(0x0000, v);
+    assert(c0.getLineMESI(0x0000) == ICache::MESI::S);
+    c1.loadDouble(0x0020, v);
+    c1.loadDouble(0x0040, v);           // desaloja 0x000 de la L2
+    assert(!l2.contains(0x0000));
+    assert(!c0.getLineMESI(0x0000).has_value() && !c1.getLineMESI(0x0000).has_value());
+
+    const uint64_t c2c = c1.getStats().c2c_fills;
+    c1.loadDouble(0x0000, v);
+    assert(v == 2.5 && c1.getStats().c2c_fills == c2c);
+    assert(c0.getStats().back_invalidations == 1);
+    std::cout << "Back-invalidation en una L1 inactiva: OK\n";
+}
+
+// Cuatro hilos con su L1 sobre una L2 inclusiva pequeña: desalojos y
+// back-invalidations cruzadas todo el tiempo. Sin deadlock, sin escrituras
+// perdidas y, al final, toda línea de una L1 sigue en la L2. El bus de
+// transacciones partidas serializa cada línea hasta que su llenado termina.
+static void pruebaInclusionParalela() {
+    const int NC = 4, LINEAS = 16, ITER = 20000;
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    SharedL2 l2(adapter, L2Config{2, 2, 2, 32, InclusionPolicy::Inclusive});
+    SplitTransactionBus bus;
+    std::vector<std::unique_ptr<Cache2Way>> caches;
+    for (int i = 0; i < NC; i++) {
+        caches.push_back(std::make_unique<Cache2Way>(l2));
+        caches[i]->setId(i);
+        caches[i]->setBus(&bus);
+        bus.attach(caches[i].get());
+        l2.attachL1(caches[i].get());
+    }
+    std::atomic<int> listos{0};
+    std::vector<std::thread> hilos;
+    for (int i = 0; i < NC; i++) {
+        hilos.emplace_back([&, i] {
+            listos++;
+            while (listos.load() < NC) std::this_thread::yield();
+            double v = 0.0;
+            for (int k = 1; k <= ITER; k++) {
+                const int l = (k * 7 + i * 3) % LINEAS;
+                caches[i]->storeDouble(l * 32 + i * 8, k * 10.0 + i);
+                caches[i]->loadDouble(((l + 5) % LINEAS) * 32, v);
+            }
+        });
+    }
+    for (auto& h : hilos) h.join();
+
+    for (auto& c : caches)
+        for (int l = 0; l < LINEAS; l++)
+            if (c->getLineMESI(l * 32).has_value()) assert(l2.contains(l * 32));
+
+    for (auto& c : caches) c->flushAll();
+    l2.flushAll();
+    for (int i = 0; i < NC; i++) {
+        int ultimo[LINEAS] = {};
+        for (int k = 1; k <= ITER; k++) ultimo[(k * 7 + i * 3) % LINEAS] = k;
+        for (int l = 0; l < LINEAS; l++)
+            if (ultimo[l]) assert(memoria.readDouble(l * 32 + i * 8) == ultimo[l] * 10.0 + i);
+    }
+    std::cout << "Inclusión con 4 hilos: OK (" << l2.getStats().back_invalidations << " back-invalidations)\n";
+}
+
+static void pruebaExclusiva() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    SharedL2 l2(adapter, L2Config{2, 4, 2, 32, InclusionPolicy::Exclusive});
+    Cache2Way c0(l2);
+    l2.attachL1(&c0);
+
+    double v = 0.0;
+    memoria.writeDouble(0x0000, 1.5);
+    c0.loadDouble(0x0000, v);           // miss en ambas: la L2 no se llena
+    assert(!l2.contains(0x0000));
+    c0.loadDouble(0x0100, v);
+    c0.loadDouble(0x0200, v);           // la L1 desaloja 0x000 limpia -> entra a la L2
+    assert(l2.contains(0x0000));
+    c0.loadDouble(0x0000, v);           // hit en L2: la línea sube y sale de la L2
+    assert(v == 1.5);
+    assert(!l2.contains(0x0000));
+    auto st = l2.getStats();
+    assert(st.hits == 1 && st.victim_fills >= 1);
+
+    // Una línea de L1 distinta de la de la L2 no puede entrar entera
+    auto c64 = makeCache(CacheConfig{32, 4, 64}, l2);
+    bool rechazada = false;
+    try { l2.attachL1(c64.get()); } catch (const std::invalid_argument&) { rechazada = true; }
+    assert(rechazada);
+    std::cout << "L2 exclusiva: OK (víctimas limpias llenan la L2, los hits la vacían)\n";
+}
+
+static void pruebaLineaMayor() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    for (auto pol : { InclusionPolicy::Inclusive, InclusionPolicy::NINE, InclusionPolicy::Exclusive }) {
+        SharedL2 l2(adapter, L2Config{4, 16, 8, 32, pol});
+        auto c64 = makeCache(CacheConfig{32, 4, 64}, l2);
+        bool rechazada = false;
+        try { l2.attachL1(c64.get()); } catch (const std::invalid_argument&) { rechazada = true; }
+        assert(rechazada);
+    }
+    // Una L1 de línea menor sí cabe (salvo en Exclusive)
+    SharedL2 l2(adapter, L2Config{4, 16, 8, 64, InclusionPolicy::Inclusive});
+    Cache2Way c0(l2);
+    l2.attachL1(&c0);
+    memoria.writeWord(0x40, 9);
+    uint64_t v = 0;
+    c0.load64(0x40, v);
+    assert(v == 9 && l2.contains(0x40));
+    std::cout << "Línea de L1 mayor que la de L2: rechazada en las tres políticas\n";
+}
+
+int main() {
+    std::cout << "=== L2 compartida (2 x Cache2Way, L2 4 bancos x 8 sets x 4 vías x 32B) ===\n\n";
+    std::cout << std::left << std::setw(12) << "Política" << std::right
+              << std::setw(10) << "L1 miss" << std::setw(8) << "L2 hit" << std::setw(8) << "L2 miss"
+              << std::setw(9) << "Hit %" << std::setw(8) << "BInv" << std::setw(8) << "L1 BInv"
+              << std::setw(10) << "MemR" << std::setw(10) << "MemW" << std::setw(10) << "Suma" << "\n";
+    productoPunto(std::nullopt);
+    productoPunto(InclusionPolicy::Inclusive);
+    productoPunto(InclusionPolicy::Exclusive);
+    productoPunto(InclusionPolicy::NINE);
+    std::cout << "\n";
+
+    pruebaBackInvalidation();
+    pruebaL1Inactiva();
+    pruebaInclusionParalela();
+    pruebaExclusiva();
+    pruebaLineaMayor();
+
+    std::cout << "\n=== Prueba de L2 completada ===\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_l2.cpp cache.cpp l2_cache.cpp main_memory.cpp processing_element.cpp split_bus.cpp -o prueba_l2
+//./prueba_l2
@@ -0,0 +1,169 @@
+// prueba_malla.cpp
+// Malla 2D con ruteo XY, canales virtuales y créditos (mesh.hpp).
+//  1) Geometría: ruta XY, saltos y home node por tile.
+//  2) Latencia de un miss en 2x2, salto por salto.
+//  3) Créditos: 16 cachés piden líneas del mismo home a la vez; con buffers
+//     de 1 flit hay esperas por créditos y con buffers hondos menos.
+//  4) Escalado: producto punto sobre el bus atómico y sobre mallas de 16,
+//     32 y 64 tiles; ciclos totales y utilización del recurso más cargado.
+//  5) 256 PEs (16x16): 16 líneas compartidas por todas las cachés, con home
+//     en la fila 0, y un escritor que las invalida. El mapa de la malla
+//     muestra el punto caliente.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "processing_element.hpp"
+#include "interconnect.hpp"
+#include "mesh.hpp"
+#include "producto_punto.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cassert>
+
+static void geometria() {
+    MeshInterconnect mesh(MeshConfig{ 4, 4 });
+    assert(mesh.tiles() == 16);
+    // XY: primero la columna (0 -> 3) y después la fila (0 -> 3)
+    assert((mesh.route(0, 15) == std::vector<uint32_t>{ 0, 1, 2, 3, 7, 11, 15 }));
+    assert((mesh.route(13, 6) == std::vector<uint32_t>{ 13, 14, 10, 6 }));
+    assert(mesh.hops(0, 15) == 6 && mesh.hops(13, 6) == 3 && mesh.hops(5, 5) == 0);
+    assert(mesh.homeTile(0) == 0 && mesh.homeTile(17 * 32) == 1);
+    assert(mesh.config().homes == 16);
+    std::cout << "Geometría: OK\n";
+}
+
+static void latenciaMiss() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    const MeshConfig mc{ 2, 2, 1, 16 };
+    MeshInterconnect mesh(mc);
+    std::vector<std::unique_ptr<Cache2Way>> caches;
+    for (int i = 0; i < 4; i++) {
+        caches.push_back(std::make_unique<Cache2Way>(adapter));
+        caches[i]->setBus(&mesh);
+        mesh.attach(caches[i].get());
+    }
+    const TimingConfig tc;
+    uint64_t v;
+    caches[3]->load64(0x0, v);   // tile 3, home en el tile 0
+
+    // Petición de 1 flit por 3 -> 2 -> 0, consulta del directorio (sin
+    // destinos) y 32 B de datos (2 flits) por 0 -> 1 -> 3.
+    const uint64_t peticion = 2 * mc.hop_cycles;
+    const uint64_t datos = 2 * mc.hop_cycles + (32 / mc.link_bytes_per_cycle - 1);
+    const uint64_t esperado = tc.hit_cycles + peticion + tc.snoop_cycles + datos + tc.mem_read_cycles + tc.fill_cycles;
+    std::cout << "Miss en el tile 3 (2x2): " << caches[3]->clock() << " ciclos (esperado " << esperado << ")\n";
+    assert(caches[3]->clock() == esperado);
+    const auto st = mesh.netStats();
+    assert(st.packets == 2 && st.hops == 4 && st.flits == 2 * 1 + 2 * 2 && st.credit_stalls == 0);
+    const auto rs = mesh.routerStats();
+    assert(rs[3].flits == 1 && rs[2].flits == 1 && rs[0].flits == 2 && rs[1].flits == 2);
+}
+
+static MeshInterconnect::NetStats rafagaAlHome(uint32_t vcs, uint32_t depth, uint64_t& fin) {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    MeshInterconnect mesh(MeshConfig{ 4, 4, 1, 8, vcs, depth });
+    std::vector<std::unique_ptr<Cache2Way>> caches;
+    for (int i = 0; i < 16; i++) {
+        caches.push_back(std::make_unique<Cache2Way>(adapter));
+        mesh.attach(caches[i].get());
+    }
+    // Cada caché pide una línea distinta con home en el tile 0, todas en el ciclo 0
+    fin = 0;
+    for (int i = 0; i < 16; i++) {
+        const BusGrant g = mesh.reserveBus(BusTransfer{ caches[i].get(), BusMsg::BusRd, uint64_t(i) * 16 * 32, 0, 1, 4, 8, 32, 2 });
+        fin = std::max(fin, g.done);
+    }
+    return mesh.netStats();
+}
+
+static void creditos() {
+    uint64_t fin1, fin8;
+    const auto s1 = rafagaAlHome(1, 1, fin1);
+    const auto s8 = rafagaAlHome(2, 8, fin8);
+    std::cout << "\nRáfaga al home 0: 1 VC x 1 flit -> " << s1.credit_stalls << " esperas por créditos, fin en "
+              << fin1 << "; 2 VCs x 8 flits -> " << s8.credit_stalls << " esperas, fin en " << fin8 << "\n";
+    assert(s1.packets == s8.packets && s1.flits == s8.flits);
+    assert(s1.credit_stalls > s8.credit_stalls);
+    assert(fin1 >= fin8);
+}
+
+static void escalado() {
+    std::cout << "\n" << std::setw(4) << "PEs" << std::setw(7) << "malla"
+              << std::setw(10) << "bus" << std::setw(8) << "util%"
+              << std::setw(10) << "malla" << std::setw(8) << "max%" << "\n";
+    const uint32_t dims[][2] = { { 4, 4 }, { 8, 4 }, { 8, 8 } };
+    for (const auto& d : dims) {
+        const int np = static_cast<int>(d[0] * d[1]);
+        Interconnect bus;
+        MeshInterconnect mesh(MeshConfig{ d[0], d[1] });
+        const RunReport rb = productoPuntoEn(bus, np);
+        const RunReport rm = productoPuntoEn(mesh, np);
+        std::cout << std::fixed << std::setprecision(1) << std::setw(4) << np
+                  << std::setw(7) << (std::to_string(d[0]) + "x" + std::to_string(d[1]))
+                  << std::setw(10) << rb.total_cycles << std::setw(8) << 100.0 * rb.busUtilization()
+                  << std::setw(10) << rm.total_cycles << std::setw(8) << 100.0 * rm.busUtilization() << "\n";
+        // Ningún enlace de la malla carga todo el tráfico que carga el bus
+        assert(rm.busUtilization() < rb.busUtilization());
+        if (np == 64) {
+            std::cout << "\n";
+            mesh.dump(std::cout, rm.total_cycles);
+        }
+    }
+}
+
+static void puntoCaliente() {
+    const uint32_t C = 16, R = 16, LINEAS = 16;
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    MeshInterconnect mesh(MeshConfig{ C, R });
+    std::vector<std::unique_ptr<Cache2Way>> caches;
+    for (uint32_t i = 0; i < C * R; i++) {
+        caches.push_back(std::make_unique<Cache2Way>(adapter));
+        caches[i]->setId(static_cast<int>(i));
+        caches[i]->setBus(&mesh);
+        mesh.attach(caches[i].get());
+    }
+    for (uint32_t l = 0; l < LINEAS; l++) memoria.writeDouble(l * 32, l + 0.5);
+
+    // Líneas 0..15: homes en los tiles 0..15, la fila 0 de la malla
+    double v;
+    for (auto& c : caches)
+        for (uint32_t l = 0; l < LINEAS; l++) { c->loadDouble(l * 32, v); assert(v == l + 0.5); }
+    const uint64_t antes = mesh.getStats().invalidations;
+    for (uint32_t l = 0; l < LINEAS; l++) caches[C * R - 1]->storeDouble(l * 32, -1.0);
+    const auto st = mesh.getStats();
+    assert(st.invalidations - antes == LINEAS * (C * R - 1));
+    for (uint32_t l = 0; l < LINEAS; l++) { caches[0]->loadDouble(l * 32, v); assert(v == -1.0); }
+
+    uint64_t total = 0;
+    for (auto& c : caches) total = std::max(total, c->clock());
+    std::cout << "\n256 PEs, " << LINEAS << " líneas compartidas con home en la fila 0 ("
+              << total << " ciclos):\n";
+    mesh.dump(std::cout, total);
+
+    // El enlace más cargado sale de un router de la fila 0 o de la 1
+    const auto busy = mesh.linkBusyCycles();
+    const size_t caliente = std::max_element(busy.begin(), busy.end()) - busy.begin();
+    assert(caliente / MeshInterconnect::PORTS / C <= 1);
+}
+
+int main() {
+    geometria();
+    latenciaMiss();
+    creditos();
+    escalado();
+    puntoCaliente();
+    std::cout << "\nOK\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_malla.cpp cache.cpp main_memory.cpp processing_element.cpp directory.cpp mesh.cpp -o prueba_malla
+//./prueba_malla
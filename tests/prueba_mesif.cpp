@@ -0,0 +1,118 @@
+// prueba_mesif.cpp
+// MESIF frente a MESI con una tabla de solo lectura compartida por N cachés.
+// En MESI cada miss sobre una línea compartida lee memoria; en MESIF la
+// copia en F la entrega y pasa la responsabilidad al solicitante, así que
+// memoria solo se lee una vez por línea sin importar cuántas cachés haya.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "interconnect.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <cassert>
+
+static const int LINEAS = 8;   // la tabla cabe en cada Cache2Way
+
+static void tablaCompartida(CoherenceProtocol proto, int ncaches) {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    std::vector<std::unique_ptr<Cache2Way>> caches;
+    for (int i = 0; i < ncaches; i++) {
+        caches.push_back(std::make_unique<Cache2Way>(adapter));
+        caches[i]->setId(i);
+        caches[i]->setBus(&bus);
+        caches[i]->setProtocol(proto);
+        bus.attach(caches[i].get());
+    }
+    for (int l = 0; l < LINEAS * 4; l++) memoria.writeDouble(l * 8, l + 0.5);
+
+    // Cada caché recorre la tabla completa, una tras otra
+    for (auto& c : caches) {
+        for (int l = 0; l < LINEAS * 4; l++) {
+            double v = 0.0;
+            c->loadDouble(l * 8, v);
+            assert(v == l + 0.5);
+        }
+    }
+
+    // MESIF: exactamente una copia en F por línea (la del último lector)
+    if (proto == CoherenceProtocol::MESIF && ncaches > 1) {
+        for (int l = 0; l < LINEAS; l++) {
+            int en_f = 0;
+            for (auto& c : caches) en_f += c->getLineMESI(l * 32) == ICache::MESI::F;
+            assert(en_f == 1);
+            assert(caches.back()->getLineMESI(l * 32) == ICache::MESI::F);
+        }
+    }
+
+    uint64_t fwd = 0, fwd_fills = 0;
+    for (auto& c : caches) {
+        fwd += c->getStats().snoop_forward;
+        fwd_fills += c->getStats().forwarded_fills;
+    }
+    std::cout << std::left << std::setw(8) << protocolName(proto) << std::right
+              << std::setw(8) << ncaches
+              << std::setw(14) << memoria.getBurstReadCount()
+              << std::setw(14) << memoria.getReadCount()
+              << std::setw(10) << fwd
+              << std::setw(12) << fwd_fills << "\n";
+    if (proto == CoherenceProtocol::MESIF) {
+        assert(memoria.getBurstReadCount() == LINEAS);
+        assert(fwd_fills == uint64_t(LINEAS * (ncaches - 1)));
+    }
+}
+
+static void escrituraSobreF() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    Cache2Way c0(adapter), c1(adapter), c2(adapter);
+    Cache2Way* cs[] = { &c0, &c1, &c2 };
+    for (int i = 0; i < 3; i++) {
+        cs[i]->setId(i); cs[i]->setBus(&bus); cs[i]->setProtocol(CoherenceProtocol::MESIF);
+        bus.attach(cs[i]);
+    }
+    memoria.writeDouble(0x100, 7.0);
+    double v = 0.0;
+    c0.loadDouble(0x100, v);
+    assert(c0.getLineMESI(0x100) == ICache::MESI::E);
+    c1.loadDouble(0x100, v);
+    assert(c0.getLineMESI(0x100) == ICache::MESI::S);
+    assert(c1.getLineMESI(0x100) == ICache::MESI::F);
+
+    c1.storeDouble(0x100, 8.0);                 // F -> M invalida a las demás
+    assert(c1.getLineMESI(0x100) == ICache::MESI::M);
+    assert(!c0.getLineMESI(0x100).has_value());
+
+    c2.loadDouble(0x100, v);                    // M entrega la línea y c2 queda en F
+    assert(v == 8.0);
+    assert(c1.getLineMESI(0x100) == ICache::MESI::S);
+    assert(c2.getLineMESI(0x100) == ICache::MESI::F);
+    assert(memoria.readDouble(0x100) == 8.0);
+    std::cout << "Secuencia E->S/F, F->M, M->S/F verificada\n";
+}
+
+int main() {
+    std::cout << "=== MESIF vs MESI (tabla de " << LINEAS << " líneas leída por todas las cachés) ===\n\n";
+    std::cout << std::left << std::setw(8) << "Modo" << std::right
+              << std::setw(9) << "Cachés" << std::setw(15) << "MemR (líneas)"
+              << std::setw(14) << "MemR (pal.)" << std::setw(10) << "Fwd"
+              << std::setw(12) << "FwdFills" << "\n";
+    for (int n : { 2, 4, 8, 16 }) {
+        tablaCompartida(CoherenceProtocol::MESI, n);
+        tablaCompartida(CoherenceProtocol::MESIF, n);
+    }
+    std::cout << "\n";
+    escrituraSobreF();
+    std::cout << "\n=== Prueba MESIF completada ===\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_mesif.cpp cache.cpp main_memory.cpp processing_element.cpp -o prueba_mesif
+//./prueba_mesif
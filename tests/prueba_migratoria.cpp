@@ -0,0 +1,148 @@
+// prueba_migratoria.cpp
+// Detección de líneas migratorias en Interconnect. Patrón acumulador: 4
+// cachés hacen por turnos leer-sumar-escribir sobre la misma palabra (como
+// los partial_sums del producto punto). Sin detección cada turno cuesta un
+// BusRd y un BusUpgr; con detección el bus entrega la línea en exclusiva y
+// el store no necesita upgrade. También se comprueba que una línea leída
+// por varias cachés no se vuelva migratoria y que la histéresis la
+// desclasifique cuando cambia el patrón.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "interconnect.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+struct Sistema {
+    MainMemory memoria;
+    MainMemoryAdapter adapter{memoria};
+    Interconnect bus;
+    std::vector<std::unique_ptr<Cache2Way>> cs;
+
+    Sistema(int n, CoherenceProtocol proto, bool detectar) {
+        if (detectar) bus.setMigratoryDetection(MigratoryConfig{});
+        for (int i = 0; i < n; i++) {
+            cs.push_back(std::make_unique<Cache2Way>(adapter));
+            cs[i]->setId(i); cs[i]->setBus(&bus); bus.attach(cs[i].get()); cs[i]->setProtocol(proto);
+        }
+    }
+    ICache::Stats total() const {
+        ICache::Stats t;
+        for (const auto& c : cs) {
+            auto s = c->getStats();
+            t.bus_rd += s.bus_rd;
+            t.bus_rdx += s.bus_rdx;
+            t.bus_upgr += s.bus_upgr;
+            t.bus_cycles += s.bus_cycles;
+            t.migratory_fills += s.migratory_fills;
+            t.upgrades_avoided += s.upgrades_avoided;
+        }
+        return t;
+    }
+};
+
+static const uint64_t ACUM = 0x100;
+
+static void acumulador(CoherenceProtocol proto, bool detectar) {
+    const int N = 4, RONDAS = 50;
+    Sistema s(N, proto, detectar);
+    for (int r = 0; r < RONDAS; r++) {
+        for (int i = 0; i < N; i++) {
+            uint64_t v = 0;
+            s.cs[i]->load64(ACUM, v);
+            s.cs[i]->store64(ACUM, v + 1);
+        }
+    }
+    uint64_t v = 0;
+    s.cs[0]->load64(ACUM, v);
+    assert(v == uint64_t(N * RONDAS));
+    for (auto& c : s.cs) c->flushAll();
+    uint64_t en_memoria = 0;
+    s.adapter.read64(ACUM, en_memoria);
+    assert(en_memoria == uint64_t(N * RONDAS));
+
+    const auto t = s.total();
+    const auto* d = s.bus.migratoryDetector();
+    std::cout << std::left << std::setw(7) << protocolName(proto) << std::setw(detectar ? 11 : 10) << (detectar ? "sí" : "no")
+              << std::right
+              << std::setw(8) << t.bus_rd << std::setw(8) << t.bus_rdx << std::setw(9) << t.bus_upgr
+              << std::setw(11) << t.bus_cycles
+              << std::setw(10) << (d ? d->getStats().grants : 0)
+              << std::setw(12) << t.upgrades_avoided << "\n";
+    if (detectar) {
+        assert(t.upgrades_avoided > 0);
+        assert(t.bus_upgr + t.upgrades_avoided >= uint64_t(N * RONDAS) - N);
+    }
+}
+
+// Un escritor y tres lectores: la línea nunca es migratoria.
+static void soloLectura() {
+    const int N = 4, RONDAS = 30;
+    Sistema s(N, CoherenceProtocol::MESI, true);
+    for (int r = 0; r < RONDAS; r++) {
+        s.cs[0]->store64(ACUM, r);
+        for (int i = 1; i < N; i++) {
+            uint64_t v = 0;
+            s.cs[i]->load64(ACUM, v);
+            assert(v == uint64_t(r));
+        }
+    }
+    const auto st = s.bus.migratoryDetector()->getStats();
+    assert(st.grants == 0 && st.promotions == 0);
+    std::cout << "Productor con 3 lectores: " << st.reads << " lecturas, 0 exclusivas\n";
+}
+
+// Migratoria y después compartida por lectura: la histéresis la desclasifica.
+static void histeresis() {
+    const int N = 4;
+    Sistema s(N, CoherenceProtocol::MESI, true);
+    const auto* d = s.bus.migratoryDetector();
+    for (int r = 0; r < 10; r++) {
+        for (int i = 0; i < N; i++) {
+            uint64_t v = 0;
+            s.cs[i]->load64(ACUM, v);
+            s.cs[i]->store64(ACUM, v + 1);
+        }
+    }
+    assert(d->migratoryLines() == 1);
+    const uint64_t grants = d->getStats().grants;
+
+    for (int r = 0; r < 10; r++) {
+        s.cs[0]->store64(ACUM, r);
+        for (int i = 1; i < N; i++) {
+            uint64_t v = 0;
+            s.cs[i]->load64(ACUM, v);
+            assert(v == uint64_t(r));
+        }
+    }
+    const auto st = d->getStats();
+    assert(d->migratoryLines() == 0 && st.demotions == 1);
+    std::cout << "Histéresis: " << st.grants - grants << " lecturas exclusivas tras el cambio de patrón"
+              << " antes de desclasificar la línea\n";
+}
+
+int main() {
+    std::cout << "=== Líneas migratorias (acumulador compartido, 4 x Cache2Way, 50 rondas) ===\n\n";
+    std::cout << std::left << std::setw(7) << "Modo" << std::setw(11) << "Detección" << std::right
+              << std::setw(8) << "BusRd" << std::setw(8) << "BusRdX" << std::setw(9) << "BusUpgr"
+              << std::setw(11) << "BusCycles" << std::setw(10) << "Exclus."
+              << std::setw(12) << "UpgEvitados" << "\n";
+    for (auto p : { CoherenceProtocol::MESI, CoherenceProtocol::MOESI }) {
+        acumulador(p, false);
+        acumulador(p, true);
+    }
+    std::cout << "\n";
+    soloLectura();
+    histeresis();
+    std::cout << "\n=== Prueba de líneas migratorias completada ===\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_migratoria.cpp cache.cpp main_memory.cpp processing_element.cpp -o prueba_migratoria
+//./prueba_migratoria
@@ -0,0 +1,102 @@
+// prueba_moesi.cpp
+// MOESI frente a MESI en un patrón productor/consumidor: C0 escribe un
+// bloque de líneas y C1 lo lee, varias rondas. En MESI cada lectura de C1
+// obliga a C0 a escribir la línea a memoria (snoop_flush); en MOESI C0 la
+// entrega directamente, queda en O y solo escribe a memoria al desalojar.
+// También se verifica la secuencia de estados M -> O -> I y S -> M.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "interconnect.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+
+static void productorConsumidor(CoherenceProtocol proto) {
+    const int RONDAS = 8;
+    const int LINEAS = 12;   // más que las 16 líneas de Cache2Way entre datos y desalojos
+
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    Cache2Way prod(adapter), cons(adapter);
+    prod.setId(0); prod.setBus(&bus); bus.attach(&prod); prod.setProtocol(proto);
+    cons.setId(1); cons.setBus(&bus); bus.attach(&cons); cons.setProtocol(proto);
+
+    for (int r = 0; r < RONDAS; r++) {
+        for (int l = 0; l < LINEAS; l++) {
+            prod.storeDouble(l * 32, r * 100.0 + l);
+        }
+        for (int l = 0; l < LINEAS; l++) {
+            double v = 0.0;
+            cons.loadDouble(l * 32, v);
+            assert(v == r * 100.0 + l);
+        }
+    }
+    prod.flushAll();
+    cons.flushAll();
+    for (int l = 0; l < LINEAS; l++) assert(memoria.readDouble(l * 32) == (RONDAS - 1) * 100.0 + l);
+
+    auto p = prod.getStats();
+    auto c = cons.getStats();
+    std::cout << std::left << std::setw(8) << protocolName(proto) << std::right
+              << std::setw(12) << p.snoop_flush + c.snoop_flush
+              << std::setw(12) << p.writebacks + c.writebacks
+              << std::setw(12) << p.mem_writes + c.mem_writes
+              << std::setw(12) << p.mem_reads + c.mem_reads
+              << std::setw(10) << p.snoop_to_O + c.snoop_to_O
+              << std::setw(10) << memoria.getWriteCount() << "\n";
+}
+
+static void secuenciaEstados() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    Cache2Way c0(adapter), c1(adapter);
+    c0.setId(0); c0.setBus(&bus); bus.attach(&c0); c0.setProtocol(CoherenceProtocol::MOESI);
+    c1.setId(1); c1.setBus(&bus); bus.attach(&c1); c1.setProtocol(CoherenceProtocol::MOESI);
+
+    double v = 0.0;
+    c0.storeDouble(0x40, 3.0);
+    assert(c0.getLineMESI(0x40) == ICache::MESI::M);
+    c1.loadDouble(0x40, v);
+    assert(v == 3.0);
+    assert(c0.getLineMESI(0x40) == ICache::MESI::O);
+    assert(c1.getLineMESI(0x40) == ICache::MESI::S);
+    assert(memoria.readDouble(0x40) == 0.0);   // escritura diferida
+
+    c1.storeDouble(0x48, 4.0);                  // S -> M; la dueña O se invalida
+    assert(c1.getLineMESI(0x48) == ICache::MESI::M);
+    assert(!c0.getLineMESI(0x40).has_value());
+    c0.loadDouble(0x40, v);                     // C1 entrega la línea y pasa a O
+    assert(v == 3.0);
+    c0.loadDouble(0x48, v);
+    assert(v == 4.0);
+    assert(c1.getLineMESI(0x40) == ICache::MESI::O);
+
+    c0.storeDouble(0x40, 5.0);                  // O en C1 entrega la propiedad a C0
+    assert(c0.getLineMESI(0x40) == ICache::MESI::M);
+    c0.flushAll();
+    assert(memoria.readDouble(0x40) == 5.0 && memoria.readDouble(0x48) == 4.0);
+    std::cout << "Secuencia M->O, S->M, O->I verificada\n";
+}
+
+int main() {
+    std::cout << "=== MOESI vs MESI (productor/consumidor, 2 x Cache2Way) ===\n\n";
+    std::cout << std::left << std::setw(8) << "Modo" << std::right
+              << std::setw(12) << "snoopFlush" << std::setw(12) << "Writebacks"
+              << std::setw(12) << "MemW (pal.)" << std::setw(12) << "MemR (pal.)"
+              << std::setw(10) << "M->O" << std::setw(10) << "MemW real" << "\n";
+    productorConsumidor(CoherenceProtocol::MESI);
+    productorConsumidor(CoherenceProtocol::MOESI);
+    std::cout << "\n";
+    secuenciaEstados();
+    std::cout << "\n=== Prueba MOESI completada ===\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_moesi.cpp cache.cpp main_memory.cpp processing_element.cpp -o prueba_moesi
+//./prueba_moesi
@@ -0,0 +1,92 @@
+// prueba_mshr.cpp
+// Caché no bloqueante: recorre A y B en streaming (como el producto punto)
+// con distintos tamaños de archivo MSHR y latencias de llenado, y muestra
+// cuántos misses secundarios se fusionan y el paralelismo de memoria (MLP).
+// Al final verifica que un archivo de 0 entradas se rechaza.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+#include <cassert>
+
+int main() {
+    const int N = 192;
+    const uint64_t addr_A = 0x0000;
+    const uint64_t addr_B = addr_A + N * 8;
+
+    std::cout << "=== MSHR y fusión de misses (N=" << N << ") ===\n\n";
+    std::cout << std::setw(6) << "MSHRs" << std::setw(8) << "Lat."
+              << std::setw(8) << "Hits" << std::setw(8) << "Misses"
+              << std::setw(8) << "Prim." << std::setw(8) << "Fusion"
+              << std::setw(8) << "HuM" << std::setw(8) << "Stalls"
+              << std::setw(8) << "Pico" << std::setw(8) << "MLP" << "\n";
+
+    for (uint32_t lat : {0u, 4u, 16u}) {
+        for (uint32_t entries : {1u, 2u, 4u, 8u}) {
+            MainMemory memoria;
+            MainMemoryAdapter adapter(memoria);
+            Cache<32, 4, 64> cache(adapter);
+            cache.setMSHRConfig(entries, lat);
+
+            for (int i = 0; i < N; i++) {
+                memoria.writeDouble(addr_A + i * 8, i + 1.0);
+                memoria.writeDouble(addr_B + i * 8, 2.0);
+            }
+
+            double acc = 0.0;
+            for (int i = 0; i < N; i++) {
+                double a = 0, b = 0;
+                cache.loadDouble(addr_A + i * 8, a);
+                cache.loadDouble(addr_B + i * 8, b);
+                acc += a * b;
+            }
+            assert(acc == N * (N + 1.0));
+
+            auto s = cache.getStats();
+            assert(s.hits + s.misses == 2u * N);
+            if (lat == 0) {
+                assert(s.mshr_merges == 0 && s.mshr_allocs == 0);
+            } else {
+                assert(s.misses - s.mshr_merges == s.mshr_allocs);
+                assert(s.mshr_peak <= entries);
+            }
+
+            std::cout << std::setw(6) << entries << std::setw(8) << lat
+                      << std::setw(8) << s.hits << std::setw(8) << s.misses
+                      << std::setw(8) << (s.misses - s.mshr_merges) << std::setw(8) << s.mshr_merges
+                      << std::setw(8) << s.hits_under_miss << std::setw(8) << s.mshr_full_stalls
+                      << std::setw(8) << s.mshr_peak
+                      << std::setw(8) << std::fixed << std::setprecision(2) << s.mlp() << "\n";
+            std::cout.unsetf(std::ios::fixed);
+        }
+    }
+
+    // 0 MSHRs se rechaza y la configuración anterior queda intacta
+    {
+        MainMemory memoria;
+        MainMemoryAdapter adapter(memoria);
+        Cache<32, 4, 64> cache(adapter);
+        cache.setMSHRConfig(2, 4);
+        bool rechazado = false;
+        try { cache.setMSHRConfig(0, 4); } catch (const std::invalid_argument&) { rechazado = true; }
+        assert(rechazado);
+        try { MSHRFile m(0); rechazado = false; } catch (const std::invalid_argument&) { rechazado = true; }
+        assert(rechazado);
+        double v = 0.0;
+        cache.loadDouble(0x000, v);
+        cache.loadDouble(0x100, v);
+        assert(cache.getStats().mshr_peak == 2);
+        std::cout << "\n0 entradas MSHR: rechazado (std::invalid_argument)\n";
+    }
+
+    std::cout << "\n=== Prueba completada ===\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_mshr.cpp cache.cpp main_memory.cpp processing_element.cpp -o prueba_mshr
+//./prueba_mshr
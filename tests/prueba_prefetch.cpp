@@ -0,0 +1,224 @@
+// prueba_prefetch.cpp
+// Prefetchers de hardware sobre el producto punto de 4 PEs: compara
+// NextLine, Stride (por PC) y StreamBuffer contra la caché sin prefetch,
+// con y sin latencia de llenado, y muestra precisión, cobertura y
+// puntualidad. Al final verifica que un BusRdX de otra caché invalida la
+// copia que quedó en el stream buffer, que los candidatos fuera de la
+// memoria (por arriba o con un stride negativo) se descartan y que los
+// constructores rechazan tablas y flujos vacíos.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "processing_element.hpp"
+#include "interconnect.hpp"
+#include "split_bus.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <stdexcept>
+#include <cassert>
+
+static std::vector<Instruction> programaProductoPunto() {
+    std::vector<Instruction> code;
+    code.push_back({InstructionType::LOAD, 4, 2, 0, 0});
+    int loop_start = (int)code.size();
+    code.push_back({InstructionType::LOAD, 5, 0, 0, 0});
+    code.push_back({InstructionType::LOAD, 6, 1, 0, 0});
+    code.push_back({InstructionType::FMUL, 7, 5, 6, 0});
+    code.push_back({InstructionType::FADD, 4, 4, 7, 0});
+    code.push_back({InstructionType::INC, 0, 0, 0, 0});
+    code.push_back({InstructionType::INC, 1, 0, 0, 0});
+    code.push_back({InstructionType::DEC, 3, 0, 0, 0});
+    code.push_back({InstructionType::JNZ, 3, 0, 0, loop_start});
+    code.push_back({InstructionType::STORE, 4, 2, 0, 0});
+    return code;
+}
+
+struct Resultado {
+    ICache::Stats st;
+    double total;
+};
+
+static Resultado correr(PrefetcherKind kind, uint32_t latencia) {
+    const int NPE = 4;
+    const int N = 128;
+    const uint64_t addr_A = 0x0000;
+    const uint64_t addr_B = 0x0080 + N * 8;
+    const uint64_t addr_P = 0x0080 + 2 * N * 8;
+
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+
+    std::vector<std::unique_ptr<ICache>> caches;
+    std::vector<std::unique_ptr<ProcessingElement>> pes;
+    for (int i = 0; i < NPE; i++) {
+        caches.push_back(makeCache(CacheConfig{16, 4, 32}, adapter));
+        caches[i]->setId(i);
+        caches[i]->setBus(&bus);
+        caches[i]->setMSHRConfig(4, latencia);
+        caches[i]->setPrefetcher(makePrefetcher(kind, 2));
+        bus.attach(caches[i].get());
+        pes.push_back(std::make_unique<ProcessingElement>(i));
+        pes[i]->setCache(caches[i].get());
+    }
+
+    for (int i = 0; i < N; i++) {
+        memoria.writeDouble(addr_A + i * 8, i + 1.0);
+        memoria.writeDouble(addr_B + i * 8, 2.0);
+    }
+
+    const int por_pe = N / NPE;
+    for (int p = 0; p < NPE; p++) {
+        memoria.writeDouble(addr_P + p * 64, 0.0);
+        pes[p]->setRegister(0, addr_A + p * por_pe * 8);
+        pes[p]->setRegister(1, addr_B + p * por_pe * 8);
+        pes[p]->setRegister(2, addr_P + p * 64);
+        pes[p]->setRegister(3, por_pe);
+        pes[p]->loadProgram(programaProductoPunto());
+    }
+
+    bool vivos = true;
+    while (vivos) {
+        vivos = false;
+        for (auto& pe : pes) {
+            if (!pe->hasFinished()) { pe->executeNextInstruction(); vivos = true; }
+        }
+    }
+    for (auto& c : caches) c->flushAll();
+
+    Resultado r{};
+    for (int p = 0; p < NPE; p++) {
+        r.total += memoria.readDouble(addr_P + p * 64);
+        auto st = caches[p]->getStats();
+        r.st.hits += st.hits;
+        r.st.misses += st.misses;
+        r.st.bus_rd += st.bus_rd;
+        r.st.prefetch_issued += st.prefetch_issued;
+        r.st.prefetch_useful += st.prefetch_useful;
+        r.st.prefetch_late += st.prefetch_late;
+        r.st.prefetch_unused += st.prefetch_unused;
+        r.st.prefetch_dropped += st.prefetch_dropped;
+    }
+    return r;
+}
+
+static void pruebaSnoopStreamBuffer() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    Cache2Way c0(adapter), c1(adapter);
+    c0.setId(0); c0.setBus(&bus); bus.attach(&c0);
+    c1.setId(1); c1.setBus(&bus); bus.attach(&c1);
+    c0.setPrefetcher(std::make_unique<StreamBufferPrefetcher>(1, 4));
+
+    memoria.writeDouble(0x0020, 1.0);
+    double v = 0.0;
+    c0.loadDouble(0x0000, v);           // miss: el flujo trae 0x20..0x80 al buffer
+    c1.storeDouble(0x0020, 7.0);        // BusRdX: la copia del buffer debe invalidarse
+    bool hit = c0.loadDouble(0x0020, v);
+    assert(!hit);
+    assert(v == 7.0);
+    assert(c0.getStats().prefetch_unused >= 1);
+    std::cout << "Snoop BusRdX sobre stream buffer: OK (C0 lee " << v << ")\n";
+}
+
+static void pruebaLimiteMemoria() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    SplitTransactionBus bus;
+    Cache2Way c0(adapter), c1(adapter);
+    c0.setId(0); c0.setBus(&bus); bus.attach(&c0);
+    c1.setId(1); c1.setBus(&bus); bus.attach(&c1);
+
+    // Última línea de la memoria (4 KB): las dos siguientes no existen
+    c0.setPrefetcher(makePrefetcher(PrefetcherKind::NextLine, 2));
+    memoria.writeWord(0xFF8, 42);
+    uint64_t v = 0;
+    c0.load64(0xFF8, v);
+    assert(v == 42);
+    assert(c0.getStats().prefetch_issued == 0 && c0.getStats().prefetch_dropped == 2);
+    // Nada quedó pendiente en el bus: otra caché obtiene la línea
+    c1.load64(0xFF8, v);
+    assert(v == 42);
+
+    // Stride negativo desde el principio de la memoria: los candidatos
+    // darían la vuelta a direcciones enormes
+    c1.setPrefetcher(makePrefetcher(PrefetcherKind::Stride, 2));
+    c1.setAccessPC(7);
+    for (uint64_t a = 0x100; a + 0x20 > 0x20; a -= 0x20) c1.load64(a, v);
+    const auto st = c1.getStats();
+    assert(st.prefetch_issued > 0 && st.prefetch_dropped >= 2);
+    std::cout << "Prefetch en el límite de la memoria: OK (" << c0.getStats().prefetch_dropped + st.prefetch_dropped
+              << " candidatos fuera de rango descartados)\n";
+}
+
+static void pruebaParametros() {
+    auto rechaza = [](auto crear) {
+        try { crear(); } catch (const std::invalid_argument&) { return true; }
+        return false;
+    };
+    assert(rechaza([] { StridePrefetcher p(1, 0); }));
+    assert(rechaza([] { StreamBufferPrefetcher p(0, 4); }));
+
+    // Una entrada y un flujo bastan
+    StridePrefetcher s(2, 1);
+    StreamBufferPrefetcher b(1, 4);
+    assert(b.bufferLines() == 4);
+    uint64_t out[IPrefetcher::MAX_CANDIDATES];
+    uint32_t n = 0;
+    for (uint64_t i = 0; i < 4; i++) n = s.onAccess(PrefetchAccess{ 7, 0x100 + i * 64, 0x100 + i * 64, true, false }, out);
+    assert(n == 2 && out[0] == 0x100 + 4 * 64);
+    assert(b.onAccess(PrefetchAccess{ 7, 0x200, 0x200, true, false }, out) > 0 && out[0] == 0x220);
+    std::cout << "Parámetros de los prefetchers: OK (0 entradas y 0 flujos rechazados)\n";
+}
+
+int main() {
+    std::cout << "=== Prefetch de hardware (producto punto, 4 PEs, 16x4x32) ===\n\n";
+    std::cout << std::left << std::setw(14) << "Prefetcher" << std::right
+              << std::setw(6) << "Lat." << std::setw(8) << "Misses"
+              << std::setw(8) << "BusRd" << std::setw(8) << "Emit."
+              << std::setw(8) << "Utiles" << std::setw(8) << "Tarde"
+              << std::setw(8) << "Prec." << std::setw(8) << "Cob."
+              << std::setw(8) << "Punt." << "\n";
+
+    for (uint32_t lat : {0u, 8u}) {
+        const Resultado base = correr(PrefetcherKind::None, lat);
+        for (auto kind : {PrefetcherKind::None, PrefetcherKind::NextLine,
+                          PrefetcherKind::Stride, PrefetcherKind::StreamBuffer}) {
+            const Resultado r = kind == PrefetcherKind::None ? base : correr(kind, lat);
+            assert(std::abs(r.total - 16512.0) < 1e-6);
+            if (kind != PrefetcherKind::None) {
+                assert(r.st.prefetch_issued > 0);
+                assert(r.st.prefetch_useful > 0);
+                assert(r.st.misses < base.st.misses);
+            }
+            std::cout << std::left << std::setw(14) << prefetcherName(kind) << std::right
+                      << std::setw(6) << lat << std::setw(8) << r.st.misses
+                      << std::setw(8) << r.st.bus_rd << std::setw(8) << r.st.prefetch_issued
+                      << std::setw(8) << r.st.prefetch_useful << std::setw(8) << r.st.prefetch_late
+                      << std::fixed << std::setprecision(2)
+                      << std::setw(8) << r.st.prefetchAccuracy()
+                      << std::setw(8) << r.st.prefetchCoverage()
+                      << std::setw(8) << r.st.prefetchTimeliness() << "\n";
+            std::cout.unsetf(std::ios::fixed);
+            std::cout << std::setprecision(6);
+        }
+    }
+    std::cout << "\n";
+
+    pruebaSnoopStreamBuffer();
+    pruebaLimiteMemoria();
+    pruebaParametros();
+
+    std::cout << "\n=== Prueba de prefetch completada ===\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_prefetch.cpp cache.cpp main_memory.cpp processing_element.cpp split_bus.cpp -o prueba_prefetch
+//./prueba_prefetch
@@ -0,0 +1,100 @@
+// prueba_reemplazo.cpp
+// Compara las políticas de reemplazo sobre el patrón del producto punto:
+// A y B se recorren en streaming (cada línea se usa WORDS_PER_LINE veces y
+// no vuelve a usarse) mientras el acumulador y una tabla pequeña de
+// coeficientes se reutilizan en cada iteración.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cassert>
+
+struct Resultado {
+    ICache::Stats st;
+    double total;
+};
+
+// Producto punto con una tabla de K coeficientes reutilizada:
+//   acc += A[i] * B[i] * C[i % K]
+static Resultado ejecutar(const CacheConfig& cfg, int N, int K, int pasadas) {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    auto cache = makeCache(cfg, adapter);
+
+    const uint64_t addr_A = 0x0000;
+    const uint64_t addr_B = addr_A + N * 8;
+    const uint64_t addr_C = addr_B + N * 8;
+    const uint64_t addr_acc = addr_C + K * 8;
+
+    for (int i = 0; i < N; i++) {
+        memoria.writeDouble(addr_A + i * 8, i + 1.0);
+        memoria.writeDouble(addr_B + i * 8, 2.0);
+    }
+    for (int k = 0; k < K; k++) memoria.writeDouble(addr_C + k * 8, 1.0);
+    memoria.writeDouble(addr_acc, 0.0);
+
+    for (int p = 0; p < pasadas; p++) {
+        for (int i = 0; i < N; i++) {
+            double a = 0, b = 0, c = 0, acc = 0;
+            cache->loadDouble(addr_A + i * 8, a);
+            cache->loadDouble(addr_B + i * 8, b);
+            cache->loadDouble(addr_C + (i % K) * 8, c);
+            cache->loadDouble(addr_acc, acc);
+            cache->storeDouble(addr_acc, acc + a * b * c);
+        }
+    }
+    cache->flushAll();
+    return { cache->getStats(), memoria.readDouble(addr_acc) };
+}
+
+int main() {
+    const int N = 192, K = 16, PASADAS = 2;
+    double esperado = 0.0;
+    for (int i = 0; i < N; i++) esperado += (i + 1.0) * 2.0;
+    esperado *= PASADAS;
+
+    const ReplacementKind politicas[] = {
+        ReplacementKind::LRU, ReplacementKind::TreePLRU, ReplacementKind::SRRIP,
+        ReplacementKind::BRRIP, ReplacementKind::Random
+    };
+
+    std::cout << "=== Políticas de reemplazo (N=" << N << ", K=" << K
+              << ", " << PASADAS << " pasadas) ===\n";
+
+    for (const char* geo : {"8x2x32", "16x4x32", "32x4x64"}) {
+        std::cout << "\nGeometría " << geo << "\n";
+        std::cout << std::left << std::setw(8) << "Política" << std::right
+                  << std::setw(10) << "Hits" << std::setw(10) << "Misses"
+                  << std::setw(10) << "Evict" << std::setw(8) << "WBs"
+                  << std::setw(10) << "Miss %" << "\n";
+        for (auto pol : politicas) {
+            CacheConfig cfg = CacheConfig::parse(geo);
+            cfg.replacement = pol;
+            auto r = ejecutar(cfg, N, K, PASADAS);
+            assert(r.total == esperado);
+            const auto& s = r.st;
+            std::cout << std::left << std::setw(8) << replacementName(pol) << std::right
+                      << std::setw(10) << s.hits << std::setw(10) << s.misses
+                      << std::setw(10) << s.evictions << std::setw(8) << s.writebacks
+                      << std::setw(9) << std::fixed << std::setprecision(2)
+                      << 100.0 * s.misses / (s.hits + s.misses) << "%\n";
+            std::cout.unsetf(std::ios::fixed);
+        }
+    }
+
+    // Parseo de la política desde texto
+    assert(CacheConfig::parse("64x8x64:srrip").replacement == ReplacementKind::SRRIP);
+    assert(CacheConfig::parse("64x8x64:PLRU").replacement == ReplacementKind::TreePLRU);
+    assert(CacheConfig::parse("64x8x64").replacement == ReplacementKind::LRU);
+
+    std::cout << "\n=== Prueba completada ===\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_reemplazo.cpp cache.cpp main_memory.cpp processing_element.cpp -o prueba_reemplazo
+//./prueba_reemplazo
@@ -0,0 +1,79 @@
+// prueba_respuesta_snoop.cpp
+// Respuesta agregada del bus (shared / dirty / none). Un miss de lectura
+// llena en E solo si ninguna otra caché tiene la línea; si no, en S. Así
+// el primer store de cada lector emite BusUpgr e invalida a los demás en
+// lugar de pasar de E a M en silencio.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "interconnect.hpp"
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <cassert>
+
+int main() {
+    const int NC = 3;
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    std::vector<std::unique_ptr<Cache2Way>> caches;
+    for (int i = 0; i < NC; i++) {
+        caches.push_back(std::make_unique<Cache2Way>(adapter));
+        caches[i]->setId(i);
+        caches[i]->setBus(&bus);
+        bus.attach(caches[i].get());
+    }
+    auto estados = [&](uint64_t addr) {
+        std::cout << "  ";
+        for (int i = 0; i < NC; i++) {
+            auto m = caches[i]->getLineMESI(addr);
+            std::cout << "C" << i << "=" << (m ? ICache::mesiName(*m) : "I") << "  ";
+        }
+        std::cout << "\n";
+    };
+
+    std::cout << "=== Respuesta agregada del bus ===\n\n";
+    double v = 0.0;
+
+    // Respuesta directa de Interconnect::broadcast (src = nullptr: todas responden)
+    assert(bus.broadcast(nullptr, BusMsg::BusRd, 0x200) == SnoopResponse::None);
+
+    std::cout << "Lecturas sucesivas de 0x0000:\n";
+    caches[0]->loadDouble(0x0, v);
+    estados(0x0);
+    assert(caches[0]->getLineMESI(0x0) == ICache::MESI::E);
+    for (int i = 1; i < NC; i++) {
+        caches[i]->loadDouble(0x0, v);
+        estados(0x0);
+        assert(caches[i]->getLineMESI(0x0) == ICache::MESI::S);
+    }
+    assert(bus.broadcast(nullptr, BusMsg::BusRd, 0x0) == SnoopResponse::Shared);
+
+    std::cout << "C2 escribe 0x0000:\n";
+    caches[2]->storeDouble(0x0, 1.0);
+    estados(0x0);
+    assert(caches[2]->getStats().bus_upgr == 1);
+    assert(caches[2]->getLineMESI(0x0) == ICache::MESI::M);
+    assert(!caches[0]->getLineMESI(0x0).has_value() && !caches[1]->getLineMESI(0x0).has_value());
+
+    // BusRd sin buffer: C2 responde "dirty", hace flush y queda en S
+    SnoopReply r;
+    assert(bus.broadcast(caches[0].get(), BusMsg::BusRd, 0x0, r) == SnoopResponse::Dirty);
+    assert(r.shared && r.dirty && !r.supplied);
+    assert(caches[2]->getLineMESI(0x0) == ICache::MESI::S && memoria.readDouble(0x0) == 1.0);
+
+    std::cout << "C0 lee 0x0000 de nuevo:\n";
+    caches[0]->loadDouble(0x0, v);
+    estados(0x0);
+    assert(v == 1.0 && caches[0]->getLineMESI(0x0) == ICache::MESI::S);
+
+    std::cout << "\n=== Prueba de respuesta agregada completada ===\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_respuesta_snoop.cpp cache.cpp main_memory.cpp processing_element.cpp -o prueba_respuesta_snoop
+//./prueba_respuesta_snoop
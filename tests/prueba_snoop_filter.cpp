@@ -0,0 +1,137 @@
+// prueba_snoop_filter.cpp
+// Filtro de snoops en Interconnect: sin filtro, exacto y Bloom con
+// contadores. Carga casi privada: cada caché recorre 3 líneas propias que
+// chocan en el mismo set (un miss por acceso) y lee una tabla compartida.
+// Los misses privados no necesitan a nadie más; el filtro los entrega solo
+// a las posibles poseedoras. Se verifica que memoria termine igual.
+// La segunda parte corre una caché por hilo y mide el tiempo del host.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "interconnect.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <chrono>
+#include <cassert>
+
+static const int RONDAS = 20;
+static const uint64_t TABLA = 96 * 32;
+
+// Líneas privadas de la caché i (i < 32): i, i+32, i+64, todas en el mismo set
+static uint64_t privada(int i, int k) { return uint64_t(i + 32 * k) * 32; }
+
+static void trabajo(Cache2Way& c, int i) {
+    double v = 0.0;
+    for (int r = 0; r < RONDAS; r++) {
+        for (int k = 0; k < 3; k++) {
+            c.loadDouble(privada(i, k), v);
+            c.storeDouble(privada(i, k), v + 1.0);
+        }
+        c.loadDouble(TABLA + (r % 8) * 32, v);
+        assert(v == (r % 8) + 0.5);
+    }
+}
+
+struct Corrida {
+    uint64_t transacciones = 0;
+    uint64_t snoops = 0;
+    uint64_t filtrados = 0;
+    double ms = 0.0;
+    std::vector<double> memoria;
+};
+
+static Corrida correr(int nc, std::optional<SnoopFilterConfig> filtro, bool hilos) {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    if (filtro) bus.setSnoopFilter(*filtro);
+    std::vector<std::unique_ptr<Cache2Way>> caches;
+    for (int i = 0; i < nc; i++) {
+        caches.push_back(std::make_unique<Cache2Way>(adapter));
+        caches[i]->setId(i);
+        caches[i]->setBus(&bus);
+        bus.attach(caches[i].get());
+    }
+    for (int l = 0; l < 8; l++) memoria.writeDouble(TABLA + l * 32, l + 0.5);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    if (hilos) {
+        std::vector<std::thread> th;
+        for (int i = 0; i < nc; i++) th.emplace_back(trabajo, std::ref(*caches[i]), i);
+        for (auto& t : th) t.join();
+    } else {
+        for (int i = 0; i < nc; i++) trabajo(*caches[i], i);
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    for (auto& c : caches) c->flushAll();
+
+    Corrida r;
+    r.ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    for (auto& c : caches) {
+        const auto st = c->getStats();
+        r.transacciones += st.bus_rd + st.bus_rdx + st.bus_upgr + st.bus_inv;
+    }
+    if (const SnoopFilter* f = bus.snoopFilter()) {
+        const auto fs = f->getStats();
+        assert(fs.transactions == r.transacciones);
+        assert(fs.forwarded + fs.filtered == r.transacciones * (nc - 1));
+        r.snoops = fs.forwarded;
+        r.filtrados = fs.filtered;
+    } else {
+        r.snoops = r.transacciones * (nc - 1);
+    }
+    for (uint64_t a = 0; a < 4096; a += 8) r.memoria.push_back(memoria.readDouble(a));
+    for (int i = 0; i < nc; i++)
+        for (int k = 0; k < 3; k++) assert(memoria.readDouble(privada(i, k)) == RONDAS);
+    return r;
+}
+
+int main() {
+    const std::vector<std::pair<const char*, std::optional<SnoopFilterConfig>>> filtros = {
+        { "Sin filtro",       std::nullopt },
+        { "Exacto",           SnoopFilterConfig{ SnoopFilterKind::Exact } },
+        { "Bloom 256x2",      SnoopFilterConfig{ SnoopFilterKind::CountingBloom, 256, 2 } },
+        { "Bloom 16x2",       SnoopFilterConfig{ SnoopFilterKind::CountingBloom, 16, 2 } },
+    };
+
+    std::cout << "=== Filtro de snoops (carga casi privada, " << RONDAS << " rondas) ===\n\n";
+    std::cout << std::left << std::setw(8) << "Cachés" << std::setw(14) << "Filtro" << std::right
+              << std::setw(8) << "Trans." << std::setw(10) << "Snoops"
+              << std::setw(11) << "Filtrados" << std::setw(10) << "Snp/tr" << "\n";
+    for (int nc : { 4, 8, 16, 32 }) {
+        std::optional<std::vector<double>> ref;
+        for (const auto& [nombre, cfg] : filtros) {
+            const Corrida r = correr(nc, cfg, false);
+            if (!ref) ref = r.memoria;
+            assert(r.memoria == *ref);
+            std::cout << std::left << std::setw(7) << nc << std::setw(14) << nombre << std::right
+                      << std::setw(8) << r.transacciones << std::setw(10) << r.snoops
+                      << std::setw(11) << r.filtrados
+                      << std::setw(10) << std::fixed << std::setprecision(2)
+                      << double(r.snoops) / r.transacciones << "\n";
+            std::cout.unsetf(std::ios::fixed);
+        }
+    }
+
+    std::cout << "\n--- Una caché por hilo (32 cachés) ---\n";
+    for (const auto& [nombre, cfg] : filtros) {
+        const Corrida r = correr(32, cfg, true);
+        std::cout << std::left << std::setw(14) << nombre << std::right
+                  << "snoops=" << std::setw(7) << r.snoops
+                  << "  tiempo=" << std::fixed << std::setprecision(2) << r.ms << " ms\n";
+        std::cout.unsetf(std::ios::fixed);
+    }
+
+    std::cout << "\n=== Prueba del filtro de snoops completada ===\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_snoop_filter.cpp cache.cpp main_memory.cpp processing_element.cpp -o prueba_snoop_filter
+//./prueba_snoop_filter
@@ -0,0 +1,138 @@
+// prueba_tabla_coherencia.cpp
+// Imprime la tabla de transiciones (estado x evento) de cada protocolo y
+// verifica algunas entradas clave. Las mismas tablas son las que consultan
+// load64/store64 y snoop(), así que también se comprueba que una caché
+// siga la tabla en una secuencia corta.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "interconnect.hpp"
+#include "coherence.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <string>
+
+using L = LineState;
+using E = CoherenceEvent;
+
+static const char* eventName(E e) {
+    static const char* n[] = { "Load", "Store", "BusRd", "BusRdX", "BusUpgr", "Inval", "BusUpd", "Flush" };
+    return n[static_cast<int>(e)];
+}
+
+static const char* busName(BusMsg m) {
+    switch (m) {
+        case BusMsg::BusRd:      return "BusRd";
+        case BusMsg::BusRdX:     return "BusRdX";
+        case BusMsg::Invalidate: return "Inval";
+        case BusMsg::BusUpgr:    return "BusUpgr";
+        case BusMsg::BusUpd:     return "BusUpd";
+        default:                 return "Flush";
+    }
+}
+
+static const char* dataName(DataAction d) {
+    static const char* n[] = { "", "wr", "wt", "sup", "keep", "sup+fl", "hand", "upd" };
+    return n[static_cast<int>(d)];
+}
+
+static std::string celda(const Transition& t) {
+    std::string s = ICache::mesiName(t.next);
+    if (t.issues) {
+        s = std::string(busName(t.bus)) + ">" + ICache::mesiName(t.next);
+        if (t.next_shared != t.next) s += "/" + std::string(ICache::mesiName(t.next_shared));
+    }
+    if (t.data != DataAction::None) s += " " + std::string(dataName(t.data));
+    return s;
+}
+
+static void imprimir(CoherenceProtocol p) {
+    const CoherenceTable& tab = coherenceTable(p);
+    std::cout << protocolName(p) << "\n" << std::left << std::setw(4) << "";
+    for (int e = 0; e < static_cast<int>(COHERENCE_EVENTS); e++) std::cout << std::setw(15) << eventName(E(e));
+    std::cout << "\n";
+    for (L s : { L::I, L::S, L::E, L::M, L::O, L::F }) {
+        std::cout << std::setw(4) << ICache::mesiName(s);
+        for (int e = 0; e < static_cast<int>(COHERENCE_EVENTS); e++) std::cout << std::setw(15) << celda(tab.at(s, E(e)));
+        std::cout << "\n";
+    }
+    std::cout << std::right << "\n";
+}
+
+static void entradasClave() {
+    const auto& mesi = coherenceTable(CoherenceProtocol::MESI);
+    assert(mesi.at(L::I, E::Load).issues && mesi.at(L::I, E::Load).bus == BusMsg::BusRd);
+    assert(mesi.at(L::I, E::Load).next == L::E && mesi.at(L::I, E::Load).next_shared == L::S);
+    assert(mesi.at(L::S, E::Store).bus == BusMsg::BusUpgr && mesi.at(L::S, E::Store).writes());
+    assert(!mesi.at(L::E, E::Store).issues && mesi.at(L::E, E::Store).next == L::M);
+    assert(mesi.at(L::M, E::BusRd).data == DataAction::SupplyFlush);
+    assert(mesi.at(L::M, E::BusRdX).next == L::I && mesi.at(L::M, E::BusRdX).data == DataAction::HandOver);
+
+    const auto& moesi = coherenceTable(CoherenceProtocol::MOESI);
+    assert(moesi.at(L::M, E::BusRd).next == L::O && moesi.at(L::O, E::BusRd).data == DataAction::SupplyKeep);
+
+    const auto& mesif = coherenceTable(CoherenceProtocol::MESIF);
+    assert(mesif.at(L::F, E::BusRd).data == DataAction::Supply && mesif.at(L::F, E::BusRd).next == L::S);
+
+    const auto& dragon = coherenceTable(CoherenceProtocol::Dragon);
+    assert(dragon.at(L::I, E::Store).bus == BusMsg::BusRd && !dragon.at(L::I, E::Store).writes());
+    assert(dragon.at(L::S, E::Store).bus == BusMsg::BusUpd && dragon.at(L::S, E::Store).next_shared == L::O);
+    assert(dragon.at(L::O, E::BusUpd).next == L::S && dragon.at(L::O, E::BusUpd).data == DataAction::Update);
+
+    const auto& firefly = coherenceTable(CoherenceProtocol::Firefly);
+    assert(firefly.at(L::S, E::Store).data == DataAction::WriteThrough);
+    std::cout << "Entradas clave verificadas\n";
+}
+
+// Una caché sigue la tabla: cada estado observado es el que predice la entrada.
+static void cacheSigueTabla(CoherenceProtocol p) {
+    const CoherenceTable& tab = coherenceTable(p);
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    Cache2Way c0(adapter), c1(adapter);
+    c0.setId(0); c0.setBus(&bus); bus.attach(&c0); c0.setProtocol(p);
+    c1.setId(1); c1.setBus(&bus); bus.attach(&c1); c1.setProtocol(p);
+
+    uint64_t v = 0;
+    c0.load64(0x40, v);                                          // I -Load-> E
+    assert(c0.getLineMESI(0x40) == tab.at(L::I, E::Load).next);
+    c0.store64(0x40, 1);                                         // E -Store-> M
+    assert(c0.getLineMESI(0x40) == tab.at(L::E, E::Store).next);
+    c1.load64(0x40, v);                                          // M -BusRd-> S/O ; I -Load-> S/F
+    assert(v == 1);
+    assert(c0.getLineMESI(0x40) == tab.at(L::M, E::BusRd).next);
+    assert(c1.getLineMESI(0x40) == tab.at(L::I, E::Load).next_shared);
+    const L antes = *c1.getLineMESI(0x40);
+    c1.store64(0x48, 2);
+    const Transition& t = tab.at(antes, E::Store);
+    assert(c1.getLineMESI(0x48) == t.next_shared || c1.getLineMESI(0x48) == t.next);
+    const L previo0 = tab.at(L::M, E::BusRd).next;
+    const auto estado0 = c0.getLineMESI(0x40);
+    assert(estado0.value_or(L::I) == tab.at(previo0, snoopEvent(t.bus)).next);
+    std::cout << std::left << std::setw(8) << protocolName(p) << std::right
+              << " C0: E->M->" << ICache::mesiName(previo0) << "->" << ICache::mesiName(estado0.value_or(L::I))
+              << "   C1: " << ICache::mesiName(antes) << "->" << ICache::mesiName(*c1.getLineMESI(0x48))
+              << " (" << busName(t.bus) << ")\n";
+}
+
+int main() {
+    std::cout << "=== Tablas de transición de coherencia ===\n\n";
+    std::cout << "Celda: estado siguiente; con transacción, BUS>solo/compartido; acción sobre el dato\n\n";
+    for (auto p : { CoherenceProtocol::MESI, CoherenceProtocol::MOESI, CoherenceProtocol::MESIF,
+                    CoherenceProtocol::Dragon, CoherenceProtocol::Firefly })
+        imprimir(p);
+    entradasClave();
+    for (auto p : { CoherenceProtocol::MESI, CoherenceProtocol::MOESI, CoherenceProtocol::MESIF,
+                    CoherenceProtocol::Dragon, CoherenceProtocol::Firefly })
+        cacheSigueTabla(p);
+    std::cout << "\n=== Prueba de tablas completada ===\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_tabla_coherencia.cpp cache.cpp main_memory.cpp processing_element.cpp -o prueba_tabla_coherencia
+//./prueba_tabla_coherencia
@@ -0,0 +1,148 @@
+// prueba_tiempo.cpp
+// Modelo de tiempo en ciclos (timing.hpp).
+//  1) BusTimeline: cada mensaje toma el primer hueco libre del bus; lleno
+//     el anillo de intervalos se olvidan los más viejos.
+//  2) Latencias de un solo PE: miss, hit e instrucciones de ALU suman
+//     exactamente lo configurado.
+//  3) Producto punto con 1 y 4 PEs (paso a paso, como la GUI): con 4 PEs
+//     aparece espera por el bus. Se comparan configuraciones por ciclos
+//     totales, CPI y utilización del bus.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "processing_element.hpp"
+#include "interconnect.hpp"
+#include "producto_punto.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <string>
+#include <cassert>
+
+static void lineaDeTiempo() {
+    BusTimeline tl;
+    assert(tl.reserve(10, 5) == 10);   // [10,15)
+    assert(tl.reserve(0, 5) == 0);     // hueco anterior: [0,5)
+    assert(tl.reserve(3, 6) == 15);    // [5,10) no alcanza: espera a 15
+    assert(tl.reserve(5, 5) == 5);     // ocupa justo [5,10)
+    assert(tl.reserve(7, 1) == 21);    // bus lleno hasta 21
+    assert(tl.busyCycles() == 22 && tl.endCycle() == 22);
+
+    // Intervalos separados por un hueco: el anillo se llena y olvida los
+    // más viejos, pero los huecos recientes se siguen usando
+    BusTimeline lleno;
+    const uint64_t N = BusTimeline::MAX_INTERVALS + 100;
+    for (uint64_t i = 0; i < N; i++) assert(lleno.reserve(i * 2, 1) == i * 2);
+    assert(lleno.reserve(0, 1) == 0);                          // [0,1) ya se olvidó
+    assert(lleno.reserve((N - 1) * 2 - 1, 2) == N * 2 - 1);    // el hueco de 1 ciclo no alcanza
+    assert(lleno.reserve((N - 1) * 2 - 1, 1) == (N - 1) * 2 - 1);
+    std::cout << "BusTimeline: OK\n";
+}
+
+static void latenciasUnPE() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    Cache2Way cache(adapter);
+    cache.setBus(&bus);
+    bus.attach(&cache);
+
+    TimingConfig tc;
+    ProcessingElement pe(0);
+    pe.setCache(&cache);
+    pe.setTiming(tc);
+
+    // LOAD (miss), LOAD misma línea (hit), FADD
+    pe.loadProgram({
+        { InstructionType::LOAD, 1, 0, 0, 0 },
+        { InstructionType::LOAD, 2, 0, 0, 0 },
+        { InstructionType::FADD, 3, 1, 2, 0 },
+    });
+    while (!pe.hasFinished()) pe.executeNextInstruction();
+
+    const uint32_t bus_rd = bus.cost().cycles(BusMsg::BusRd, 32);
+    const uint64_t miss = tc.hit_cycles + bus_rd + tc.snoop_cycles + tc.mem_read_cycles + tc.fill_cycles;
+    const uint64_t esperado = miss + tc.hit_cycles + tc.alu_cycles;
+    std::cout << "Un PE: miss=" << miss << " hit=" << tc.hit_cycles << " alu=" << tc.alu_cycles
+              << " -> " << pe.getCycles() << " ciclos (esperado " << esperado << ")\n";
+    assert(pe.getCycles() == esperado);
+    assert(pe.getInstructions() == 3);
+    assert(bus.busyCycles() == bus_rd);
+
+    // Una latencia por tipo de mensaje reemplaza la de BusCost
+    tc.setMsgCycles(BusMsg::BusRd, 20);
+    pe.setTiming(tc);
+    cache.invalidateAll();
+    pe.reset();
+    bus.resetTiming();
+    pe.loadProgram({ { InstructionType::LOAD, 1, 0, 0, 0 } });
+    pe.executeNextInstruction();
+    assert(pe.getCycles() == tc.hit_cycles + 20 + tc.snoop_cycles + tc.mem_read_cycles + tc.fill_cycles);
+    assert(bus.busyCycles() == 20);
+}
+
+static RunReport correr(int npes, const BusCost& cost, const TimingConfig& tc, bool imprimir) {
+    Interconnect bus;
+    bus.setCost(cost);
+    uint64_t ocupacion = 0;
+    const RunReport r = productoPuntoEn(bus, npes, ProductoPunto{ 64, 0x0100, 64, &tc, &ocupacion });
+    assert(r.bus_busy_cycles == ocupacion);
+    if (imprimir) r.print(std::cout);
+    return r;
+}
+
+static void productoPuntoPEs() {
+    const TimingConfig tc;
+    const BusCost angosto;          // 8 B/ciclo: una línea ocupa 5 ciclos
+    BusCost ancho;
+    ancho.data_bytes_per_cycle = 32;  // una línea ocupa 2 ciclos
+
+    std::cout << "\n-- 4 PEs, bus de 8 B/ciclo --\n";
+    const RunReport r4 = correr(4, angosto, tc, true);
+    const RunReport r1 = correr(1, angosto, tc, false);
+    const RunReport r4w = correr(4, ancho, tc, false);
+    TimingConfig lenta = tc;
+    lenta.mem_read_cycles = 100;
+    const RunReport r4m = correr(4, angosto, lenta, false);
+
+    std::cout << "\n" << std::left << std::setw(28) << "Configuración" << std::right
+              << std::setw(10) << "ciclos" << std::setw(10) << "CPI PE0"
+              << std::setw(12) << "esperaBus" << std::setw(9) << "bus %" << "\n";
+    auto fila = [](const std::string& nombre, const RunReport& r) {
+        uint64_t espera = 0;
+        for (const auto& p : r.pes) espera += p.bus_wait_cycles;
+        std::cout << std::left << std::setw(27) << nombre << std::right
+                  << std::setw(10) << r.total_cycles
+                  << std::setw(10) << std::fixed << std::setprecision(2) << r.pes[0].cpi
+                  << std::setw(12) << espera
+                  << std::setw(9) << std::setprecision(1) << 100.0 * r.busUtilization() << "\n";
+    };
+    fila("1 PE, 8 B/ciclo", r1);
+    fila("4 PEs, 8 B/ciclo", r4);
+    fila("4 PEs, 32 B/ciclo", r4w);
+    fila("4 PEs, memoria 100 ciclos", r4m);
+
+    assert(r1.pes[0].bus_wait_cycles == 0);   // sin nadie más en el bus
+    uint64_t espera4 = 0;
+    for (const auto& p : r4.pes) espera4 += p.bus_wait_cycles;
+    assert(espera4 > 0);                      // 4 PEs compiten por el bus
+    assert(r4.total_cycles < r1.total_cycles);  // pero terminan antes que 1 solo
+    assert(r4w.total_cycles < r4.total_cycles);
+    assert(r4w.busUtilization() < r4.busUtilization());
+    assert(r4m.total_cycles > r4.total_cycles);
+}
+
+int main() {
+    lineaDeTiempo();
+    latenciasUnPE();
+    productoPuntoPEs();
+    std::cout << "\nOK\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_tiempo.cpp cache.cpp main_memory.cpp processing_element.cpp -o prueba_tiempo
+//./prueba_tiempo
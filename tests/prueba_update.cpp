@@ -0,0 +1,198 @@
+// prueba_update.cpp
+// Protocolos de actualización (Dragon/Firefly) frente a los de invalidación
+// (MESI/MOESI) en dos patrones:
+//   - productor/consumidor: C0 escribe un bloque de líneas y C1 lo lee en
+//     cada ronda. Con invalidación cada lectura de C1 es un miss; con
+//     actualización C1 conserva su copia y cada store viaja como una palabra.
+//   - reducción: 4 cachés suman en su propia palabra de una línea común y al
+//     final C0 lee todos los parciales.
+// Las columnas de tráfico por palabra (BusUpd, recibidas y útiles) permiten
+// decidir por carga de trabajo si conviene actualizar o invalidar.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "interconnect.hpp"
+#include "directory.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+static void imprimir(const char* patron, CoherenceProtocol proto, const std::vector<std::unique_ptr<Cache2Way>>& cs) {
+    ICache::Stats t;
+    for (const auto& c : cs) {
+        auto s = c->getStats();
+        t.misses += s.misses;
+        t.bus_rd += s.bus_rd + s.bus_rdx + s.bus_upgr + s.bus_upd;
+        t.bus_bytes += s.bus_bytes;
+        t.bus_upd += s.bus_upd;
+        t.upd_received += s.upd_received;
+        t.upd_useful += s.upd_useful;
+        t.mem_writes += s.mem_writes;
+    }
+    std::cout << std::left << std::setw(16) << patron << std::setw(9) << protocolName(proto) << std::right
+              << std::setw(9) << t.misses
+              << std::setw(10) << t.bus_rd
+              << std::setw(10) << t.bus_bytes
+              << std::setw(9) << t.bus_upd
+              << std::setw(9) << t.upd_received
+              << std::setw(9) << t.upd_useful
+              << std::setw(9) << t.mem_writes << "\n";
+}
+
+static std::vector<std::unique_ptr<Cache2Way>> conectar(int n, IMainMemory& mem, Interconnect& bus, CoherenceProtocol proto) {
+    std::vector<std::unique_ptr<Cache2Way>> cs;
+    for (int i = 0; i < n; i++) {
+        cs.push_back(std::make_unique<Cache2Way>(mem));
+        cs[i]->setId(i); cs[i]->setBus(&bus); bus.attach(cs[i].get()); cs[i]->setProtocol(proto);
+    }
+    return cs;
+}
+
+static void productorConsumidor(CoherenceProtocol proto) {
+    const int RONDAS = 8;
+    const int LINEAS = 12;
+
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    auto cs = conectar(2, adapter, bus, proto);
+
+    for (int r = 0; r < RONDAS; r++) {
+        for (int l = 0; l < LINEAS; l++) cs[0]->storeDouble(l * 32, r * 100.0 + l);
+        for (int l = 0; l < LINEAS; l++) {
+            double v = 0.0;
+            cs[1]->loadDouble(l * 32, v);
+            assert(v == r * 100.0 + l);
+        }
+    }
+    for (auto& c : cs) c->flushAll();
+    for (int l = 0; l < LINEAS; l++) assert(memoria.readDouble(l * 32) == (RONDAS - 1) * 100.0 + l);
+    imprimir("prod/cons", proto, cs);
+}
+
+static void reduccion(CoherenceProtocol proto) {
+    const int N = 4;
+    const int PASOS = 16;
+    const uint64_t LINEA = 0x200;   // una palabra por caché en la misma línea
+
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    auto cs = conectar(N, adapter, bus, proto);
+
+    for (int p = 0; p < PASOS; p++) {
+        for (int i = 0; i < N; i++) {
+            double v = 0.0;
+            cs[i]->loadDouble(LINEA + i * 8, v);
+            cs[i]->storeDouble(LINEA + i * 8, v + i + 1);
+        }
+    }
+    double total = 0.0;
+    for (int i = 0; i < N; i++) {
+        double v = 0.0;
+        cs[0]->loadDouble(LINEA + i * 8, v);
+        assert(v == PASOS * (i + 1.0));
+        total += v;
+    }
+    assert(total == PASOS * (N * (N + 1) / 2.0));
+    for (auto& c : cs) c->flushAll();
+    for (int i = 0; i < N; i++) assert(memoria.readDouble(LINEA + i * 8) == PASOS * (i + 1.0));
+    imprimir("reduccion", proto, cs);
+}
+
+static void secuenciaDragon() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    auto cs = conectar(2, adapter, bus, CoherenceProtocol::Dragon);
+    Cache2Way& c0 = *cs[0];
+    Cache2Way& c1 = *cs[1];
+
+    double v = 0.0;
+    c0.storeDouble(0x40, 1.0);                  // miss sin compartir -> M
+    assert(c0.getLineMESI(0x40) == ICache::MESI::M);
+    c1.loadDouble(0x40, v);                     // C0 entrega la línea y queda Sm
+    assert(v == 1.0);
+    assert(c0.getLineMESI(0x40) == ICache::MESI::O);
+    assert(c1.getLineMESI(0x40) == ICache::MESI::S);
+
+    c1.storeDouble(0x48, 2.0);                  // BusUpd: C1 pasa a Sm, C0 a Sc
+    assert(c1.getLineMESI(0x40) == ICache::MESI::O);
+    assert(c0.getLineMESI(0x40) == ICache::MESI::S);
+    assert(c0.loadDouble(0x48, v) && v == 2.0);  // hit: la copia se actualizó
+    assert(memoria.readDouble(0x48) == 0.0);
+    assert(c0.getStats().upd_received == 1 && c0.getStats().upd_useful == 1);
+
+    c0.storeDouble(0x80 + 0x40, 3.0);           // miss de escritura compartido: BusRd + BusUpd
+    c1.loadDouble(0xC0, v);
+    c0.storeDouble(0xC0, 4.0);
+    assert(c0.getLineMESI(0xC0) == ICache::MESI::O);
+    assert(c1.loadDouble(0xC0, v) && v == 4.0);
+    assert(c0.getStats().bus_rdx == 0 && c1.getStats().bus_rdx == 0);
+
+    c0.flushAll();
+    c1.flushAll();
+    assert(memoria.readDouble(0x40) == 1.0 && memoria.readDouble(0x48) == 2.0 && memoria.readDouble(0xC0) == 4.0);
+    std::cout << "Dragon: M -> Sm, Sc -> Sm por BusUpd, copias actualizadas sin miss\n";
+}
+
+static void secuenciaFirefly() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    auto cs = conectar(2, adapter, bus, CoherenceProtocol::Firefly);
+    Cache2Way& c0 = *cs[0];
+    Cache2Way& c1 = *cs[1];
+
+    double v = 0.0;
+    c0.loadDouble(0x40, v);
+    c1.loadDouble(0x40, v);
+    c1.storeDouble(0x40, 7.0);                  // write-through: ambas en S, memoria al día
+    assert(c0.getLineMESI(0x40) == ICache::MESI::S);
+    assert(c1.getLineMESI(0x40) == ICache::MESI::S);
+    assert(memoria.readDouble(0x40) == 7.0);
+    assert(c0.loadDouble(0x40, v) && v == 7.0);
+    std::cout << "Firefly: escritura compartida actualiza copias y memoria\n";
+}
+
+static void dragonConDirectorio() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    DirectoryInterconnect dir;
+    auto cs = conectar(4, adapter, dir, CoherenceProtocol::Dragon);
+
+    double v = 0.0;
+    for (auto& c : cs) c->loadDouble(0x100, v);
+    cs[2]->storeDouble(0x100, 9.0);
+    for (auto& c : cs) assert(c->loadDouble(0x100, v) && v == 9.0);
+    assert(dir.getStats().updates == 3);
+    std::cout << "Dragon con directorio: BusUpd a los 3 poseedores\n";
+}
+
+int main() {
+    std::cout << "=== Actualización (Dragon/Firefly) vs invalidación (MESI/MOESI) ===\n\n";
+    std::cout << std::left << std::setw(17) << "Patrón" << std::setw(9) << "Modo" << std::right
+              << std::setw(9) << "Misses" << std::setw(10) << "Trans." << std::setw(10) << "BusBytes"
+              << std::setw(9) << "BusUpd" << std::setw(9) << "Recib." << std::setw(10) << "Útiles"
+              << std::setw(9) << "MemW" << "\n";
+    for (auto p : {CoherenceProtocol::MESI, CoherenceProtocol::MOESI, CoherenceProtocol::Dragon,
+                   CoherenceProtocol::Firefly})
+        productorConsumidor(p);
+    for (auto p : {CoherenceProtocol::MESI, CoherenceProtocol::MOESI, CoherenceProtocol::Dragon,
+                   CoherenceProtocol::Firefly})
+        reduccion(p);
+    std::cout << "\n";
+    secuenciaDragon();
+    secuenciaFirefly();
+    dragonConDirectorio();
+    std::cout << "\n=== Prueba de protocolos de actualización completada ===\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_update.cpp cache.cpp directory.cpp main_memory.cpp processing_element.cpp -o prueba_update
+//./prueba_update
@@ -0,0 +1,151 @@
+// prueba_upgrade.cpp
+// Upgrades S -> M con BusUpgr (solo dirección) frente a BusRdX.
+//  1) Costo: lectores que luego escriben su propia palabra de una línea
+//     compartida. Cada upgrade ocupa solo la fase de dirección del bus.
+//  2) Carrera: la línea se invalida mientras el BusUpgr está en el bus; el
+//     store debe repetirse como BusRdX sin perder ninguna escritura.
+//  3) La misma carrera en MOESI con 3 cachés: la escritora queda en O (una
+//     tercera leyó la línea) y el BusUpgr sin datos no puede quitarle la
+//     línea sin flush.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "interconnect.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <cassert>
+
+static void costoUpgrades() {
+    const int NC = 4;
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    std::vector<std::unique_ptr<Cache2Way>> caches;
+    for (int i = 0; i < NC; i++) {
+        caches.push_back(std::make_unique<Cache2Way>(adapter));
+        caches[i]->setId(i);
+        caches[i]->setBus(&bus);
+        bus.attach(caches[i].get());
+    }
+
+    // Todas leen las 8 líneas y después cada una escribe en todas
+    for (auto& c : caches)
+        for (int l = 0; l < 8; l++) { double v; c->loadDouble(l * 32, v); }
+    for (int i = 0; i < NC; i++)
+        for (int l = 0; l < 8; l++) caches[i]->storeDouble(l * 32 + i * 8, i + l * 10.0);
+    for (auto& c : caches) c->flushAll();
+    for (int i = 0; i < NC; i++)
+        for (int l = 0; l < 8; l++) assert(memoria.readDouble(l * 32 + i * 8) == i + l * 10.0);
+
+    const BusCost cost = bus.cost();
+    std::cout << "Costo por mensaje (línea de 32 B): BusRd/BusRdX " << cost.cycles(BusMsg::BusRdX, 32)
+              << " ciclos / " << cost.bytes(BusMsg::BusRdX, 32) << " B, BusUpgr "
+              << cost.cycles(BusMsg::BusUpgr, 32) << " ciclo / " << cost.bytes(BusMsg::BusUpgr, 32) << " B\n\n";
+    std::cout << std::setw(7) << "Caché" << std::setw(8) << "BusRd" << std::setw(8) << "BusRdX"
+              << std::setw(9) << "BusUpgr" << std::setw(10) << "Ciclos" << std::setw(10) << "Bytes" << "\n";
+    for (int i = 0; i < NC; i++) {
+        auto st = caches[i]->getStats();
+        std::cout << std::setw(5) << "C" << i << std::setw(8) << st.bus_rd << std::setw(8) << st.bus_rdx
+                  << std::setw(9) << st.bus_upgr << std::setw(10) << st.bus_cycles << std::setw(10) << st.bus_bytes << "\n";
+        assert(st.bus_cycles == st.bus_rd * 5 + st.bus_rdx * 5 + st.bus_upgr * 1);
+    }
+    // C0 escribe sobre copias S (upgrade); las demás ya perdieron la línea y hacen BusRdX
+    assert(caches[0]->getStats().bus_upgr == 8 && caches[0]->getStats().bus_rdx == 0);
+}
+
+// Cliente del bus que, al ver el primer BusUpgr, hace que otra caché escriba
+// la misma línea antes de que el upgrade termine de recorrer el bus (y, si
+// hay `lector`, que una tercera la lea después).
+class Intruso : public IBusClient {
+public:
+    Intruso(Cache2Way& c, uint64_t addr, double v, Cache2Way* lector = nullptr)
+        : cache_(c), addr_(addr), v_(v), lector_(lector) {}
+    void snoop(BusMsg msg, uint64_t, SnoopReply&) override {
+        if (msg != BusMsg::BusUpgr || disparado_) return;
+        disparado_ = true;
+        cache_.storeDouble(addr_, v_);
+        if (lector_) { double v; lector_->loadDouble(addr_, v); }
+    }
+private:
+    Cache2Way& cache_;
+    uint64_t addr_;
+    double v_;
+    Cache2Way* lector_;
+    bool disparado_ = false;
+};
+
+static void carreraUpgrade() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    Cache2Way c0(adapter), c1(adapter);
+    Intruso intruso(c1, 0x48, 2.0);
+    bus.attach(&intruso);   // primero en recorrerse
+    c0.setId(0); c0.setBus(&bus); bus.attach(&c0);
+    c1.setId(1); c1.setBus(&bus); bus.attach(&c1);
+
+    double v = 0.0;
+    c0.loadDouble(0x40, v);
+    c1.loadDouble(0x40, v);
+    assert(c0.getLineMESI(0x40) == ICache::MESI::S && c1.getLineMESI(0x40) == ICache::MESI::S);
+
+    c0.storeDouble(0x40, 1.0);   // el BusUpgr de C0 pierde contra el store de C1
+    assert(c0.getStats().upgrade_races == 1);
+    assert(c0.getStats().bus_upgr == 1 && c0.getStats().bus_rdx == 1);
+    assert(c0.getLineMESI(0x40) == ICache::MESI::M);
+    assert(!c1.getLineMESI(0x40).has_value());
+
+    c0.flushAll();
+    assert(memoria.readDouble(0x40) == 1.0 && memoria.readDouble(0x48) == 2.0);
+    std::cout << "Carrera BusUpgr/invalidación: reintento con BusRdX, ambas escrituras en memoria\n";
+}
+
+static void carreraUpgradeMOESI() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    Cache2Way c0(adapter), c1(adapter), c2(adapter);
+    Intruso intruso(c1, 0x48, 2.0, &c2);
+    bus.attach(&intruso);
+    Cache2Way* cs[] = { &c0, &c1, &c2 };
+    for (int i = 0; i < 3; i++) {
+        cs[i]->setId(i);
+        cs[i]->setBus(&bus);
+        cs[i]->setProtocol(CoherenceProtocol::MOESI);
+        bus.attach(cs[i]);
+    }
+
+    double v = 0.0;
+    c0.loadDouble(0x40, v);
+    c1.loadDouble(0x40, v);
+    assert(c0.getLineMESI(0x40) == ICache::MESI::S && c1.getLineMESI(0x40) == ICache::MESI::S);
+
+    // Durante el BusUpgr de C0: C1 escribe (M) y C2 lee, así que C1 queda en
+    // O con el único dato al día cuando el upgrade le llega
+    c0.storeDouble(0x40, 1.0);
+    assert(c0.getStats().upgrade_races == 1);
+    assert(c0.getLineMESI(0x40) == ICache::MESI::M);
+    assert(!c1.getLineMESI(0x40).has_value() && !c2.getLineMESI(0x40).has_value());
+
+    for (auto* c : cs) c->flushAll();
+    assert(memoria.readDouble(0x40) == 1.0 && memoria.readDouble(0x48) == 2.0);
+    std::cout << "Carrera BusUpgr con dueña O (MOESI, 3 cachés): la O hace flush, ninguna escritura se pierde\n";
+}
+
+int main() {
+    std::cout << "=== BusUpgr (4 x Cache2Way) ===\n\n";
+    costoUpgrades();
+    std::cout << "\n";
+    carreraUpgrade();
+    carreraUpgradeMOESI();
+    std::cout << "\n=== Prueba BusUpgr completada ===\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_upgrade.cpp cache.cpp main_memory.cpp processing_element.cpp -o prueba_upgrade
+//./prueba_upgrade
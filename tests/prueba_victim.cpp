@@ -0,0 +1,120 @@
+// prueba_victim.cpp
+// Victim buffer detrás de Cache2Way (8 sets x 2 vías x 32 B).
+// A, B y la suma parcial se colocan a múltiplos de 256 B, así que A[i],
+// B[i] y P caen en el mismo set y se pelean las dos vías. Se compara el
+// número de misses sin buffer y con buffers de 1, 2 y 4 líneas, y se
+// verifica que un BusRdX de otra caché invalida (y vacía) la entrada del
+// buffer.
+
+#include "main_memory.hpp"
+#include "memory_adapter.hpp"
+#include "cache.hpp"
+#include "interconnect.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+
+static void pruebaConflictos() {
+    const int N = 32;
+    const uint64_t addr_A = 0x0000;
+    const uint64_t addr_B = 0x0100;
+    const uint64_t addr_P = 0x0200;   // 0x000, 0x100 y 0x200 -> set 0
+
+    std::cout << std::setw(8) << "VB" << std::setw(8) << "Hits" << std::setw(8) << "Misses"
+              << std::setw(10) << "VB hits" << std::setw(8) << "MemR" << std::setw(8) << "MemW"
+              << std::setw(10) << "Suma" << "\n";
+
+    uint64_t misses_sin_vb = 0;
+    for (uint32_t lineas : {0u, 1u, 2u, 4u}) {
+        MainMemory memoria;
+        MainMemoryAdapter adapter(memoria);
+        Cache2Way cache(adapter);
+        cache.setVictimBuffer(lineas);
+
+        // A y B intercalados dentro de la ventana de 256 B que cubre la caché
+        for (int i = 0; i < N; i++) {
+            const uint64_t off = (i / 4) * 0x20 + (i % 4) * 8;
+            memoria.writeDouble(addr_A + off, i + 1.0);
+            memoria.writeDouble(addr_B + off, 2.0);
+        }
+        memoria.writeDouble(addr_P, 0.0);
+
+        double esperado = 0.0;
+        for (int i = 0; i < N; i++) {
+            const uint64_t off = (i / 4) * 0x20 + (i % 4) * 8;
+            double a = 0, b = 0, p = 0;
+            cache.loadDouble(addr_A + off, a);
+            cache.loadDouble(addr_B + off, b);
+            cache.loadDouble(addr_P, p);
+            cache.storeDouble(addr_P, p + a * b);
+            esperado += a * b;
+        }
+        cache.flushAll();
+        const double suma = memoria.readDouble(addr_P);
+        assert(suma == esperado);
+
+        auto st = cache.getStats();
+        if (lineas == 0) {
+            misses_sin_vb = st.misses;
+            assert(st.victim_hits == 0);
+        } else {
+            assert(st.victim_hits > 0);
+            assert(st.misses + st.victim_hits == misses_sin_vb);
+        }
+        std::cout << std::setw(8) << lineas << std::setw(8) << st.hits << std::setw(8) << st.misses
+                  << std::setw(10) << st.victim_hits << std::setw(8) << st.mem_reads
+                  << std::setw(8) << st.mem_writes << std::setw(10) << suma << "\n";
+    }
+}
+
+static void pruebaSnoop() {
+    MainMemory memoria;
+    MainMemoryAdapter adapter(memoria);
+    Interconnect bus;
+    Cache2Way c0(adapter), c1(adapter);
+    c0.setId(0); c0.setBus(&bus); bus.attach(&c0);
+    c1.setId(1); c1.setBus(&bus); bus.attach(&c1);
+    c0.setVictimBuffer(2);
+
+    // C0 escribe 0x000 (M) y luego lo desaloja con 0x100 y 0x200 (mismo set)
+    double v = 0.0;
+    c0.storeDouble(0x0000, 5.0);
+    c0.loadDouble(0x0100, v);
+    c0.loadDouble(0x0200, v);
+    assert(c0.getLineMESI(0x0000) == ICache::MESI::M);   // sigue en el victim buffer
+
+    // C1 lee: la copia M del buffer se vacía a memoria y pasa a S
+    c1.loadDouble(0x0000, v);
+    assert(v == 5.0);
+    assert(c0.getLineMESI(0x0000) == ICache::MESI::S);
+
+    // Otra línea M en el buffer (set 1); C1 la escribe sin tenerla: BusRdX
+    // debe vaciarla a memoria e invalidar la entrada
+    c0.storeDouble(0x0020, 3.0);
+    c0.storeDouble(0x0028, 4.0);
+    c0.loadDouble(0x0120, v);
+    c0.loadDouble(0x0220, v);
+    assert(c0.getLineMESI(0x0020) == ICache::MESI::M);
+    c1.storeDouble(0x0020, 9.0);
+    assert(!c0.getLineMESI(0x0020).has_value());
+    c1.loadDouble(0x0028, v);
+    assert(v == 4.0);
+    c0.loadDouble(0x0020, v);
+    assert(v == 9.0);
+    assert(c0.getStats().victim_hits == 0);
+    std::cout << "Snoop sobre victim buffer: OK (M->S con flush, BusRdX->I)\n";
+}
+
+int main() {
+    std::cout << "=== Victim buffer (Cache2Way, conflictos en el set 0) ===\n\n";
+    pruebaConflictos();
+    std::cout << "\n";
+    pruebaSnoop();
+    std::cout << "\n=== Prueba de victim buffer completada ===\n";
+    return 0;
+}
+
+//Código de Compilación (desde la raíz del repositorio)
+//g++ -std=c++17 -O2 -pthread -I. tests/prueba_victim.cpp cache.cpp main_memory.cpp processing_element.cpp -o prueba_victim
+//./prueba_victim
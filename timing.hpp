@@ -0,0 +1,161 @@
+// timing.hpp
+// Modelo de tiempo en ciclos simulados.
+//
+// Cada caché lleva el reloj de su PE (ICache::setClock()/clock()); un
+// acceso de demanda lo adelanta en:
+//   hit_cycles                      -> todo acceso (búsqueda de tag)
+//   espera + ocupación del mensaje  -> cada transacción de la caché en el bus
+//   snoop_cycles                    -> respuesta de los snoopers
+//   mem_read_cycles                 -> línea leída de memoria (sin entrega c2c)
+//   fill_cycles                     -> instalar la línea en la caché
+//   mem_write_cycles                -> writeback de una víctima o write-through
+// y el PE suma alu_cycles por cada instrucción que no accede a memoria.
+//
+// El bus es un recurso compartido: BusTimeline guarda los intervalos en que
+// está ocupado y cada mensaje toma el primer hueco libre desde el reloj del
+// solicitante, así la contención aparece como espera. La ocupación de un
+// mensaje es msg_cycles[msg], o la de BusCost (dirección + datos) si vale 0.
+// Los prefetches ocupan el bus pero no detienen al PE. SplitTransactionBus
+// usa un BusTimeline para las direcciones y otro para los datos.
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+enum class BusMsg;
+
+struct TimingConfig {
+  static constexpr uint32_t BUS_MSGS = 6;
+
+  uint32_t hit_cycles       = 1;
+  uint32_t snoop_cycles     = 2;
+  uint32_t fill_cycles      = 1;
+  uint32_t mem_read_cycles  = 40;
+  uint32_t mem_write_cycles = 40;
+  uint32_t alu_cycles       = 1;
+  std::array<uint32_t, BUS_MSGS> msg_cycles{};  // por BusMsg; 0 = según BusCost
+
+  uint32_t msgCycles(BusMsg m) const { return msg_cycles[static_cast<uint32_t>(m)]; }
+  void setMsgCycles(BusMsg m, uint32_t c) { msg_cycles[static_cast<uint32_t>(m)] = c; }
+};
+
+/// Ocupación del bus en el tiempo simulado. Los relojes de los PEs no
+/// avanzan juntos (en modo paso a paso uno puede ir adelantado), por eso se
+/// guardan los intervalos ocupados y no solo el último: un mensaje con
+/// reloj más atrasado puede usar un hueco anterior.
+///
+/// Los intervalos van ordenados en un anillo que duplica su capacidad hasta
+/// MAX_INTERVALS y después no crece más: pasado el arranque, reservar no
+/// asigna memoria. El bus no conoce los relojes de los PEs, así que la
+/// capacidad hace de horizonte: lleno el anillo, se olvida el intervalo más
+/// viejo, que ya quedó detrás de cualquier petición viva salvo la de un PE
+/// muy atrasado.
+class BusTimeline {
+public:
+  static constexpr size_t MAX_INTERVALS = 4096;  // potencia de 2
+
+  /// Reserva `cycles` ciclos desde `ready`; devuelve el ciclo de inicio.
+  uint64_t reserve(uint64_t ready, uint32_t cycles) {
+    std::scoped_lock lk(mx_);
+    busy_ += cycles;
+    if (cycles == 0) return ready;
+
+    const uint64_t start = firstGap(ready, cycles);
+    const uint64_t end = start + cycles;
+    if (end > end_) end_ = end;
+
+    // Intervalos contiguos se fusionan para que el anillo no se llene de más
+    const size_t p = upperBound(start);
+    const bool with_prev = p > 0 && at(p - 1).end == start;
+    const bool with_next = p < n_ && at(p).start == end;
+    if (with_prev && with_next) {
+      at(p - 1).end = at(p).end;
+      for (size_t i = p; i + 1 < n_; ++i) at(i) = at(i + 1);
+      n_--;
+    } else if (with_prev) {
+      at(p - 1).end = end;
+    } else if (with_next) {
+      at(p).start = start;
+    } else if (n_ < MAX_INTERVALS) {
+      if (n_ == cap_) grow();
+      for (size_t i = n_; i > p; --i) at(i) = at(i - 1);
+      at(p) = Interval{ start, end };
+      n_++;
+    } else if (p > 0) {
+      // Lleno: se olvida el más viejo (los anteriores a p bajan una
+      // posición al mover head_) y el nuevo entra en p - 1
+      head_ = (head_ + 1) & (cap_ - 1);
+      for (size_t i = n_ - 1; i >= p; --i) at(i) = at(i - 1);
+      at(p - 1) = Interval{ start, end };
+    }
+    return start;
+  }
+
+  /// Ciclo en que empezaría reserve(ready, cycles), sin reservar.
+  uint64_t probe(uint64_t ready, uint32_t cycles) const {
+    std::scoped_lock lk(mx_);
+    return cycles == 0 ? ready : firstGap(ready, cycles);
+  }
+
+  /// Ciclos en que el bus estuvo ocupado.
+  uint64_t busyCycles() const { std::scoped_lock lk(mx_); return busy_; }
+  /// Fin del último mensaje.
+  uint64_t endCycle() const { std::scoped_lock lk(mx_); return end_; }
+
+  void reset() {
+    std::scoped_lock lk(mx_);
+    head_ = 0;
+    n_ = 0;
+    busy_ = 0;
+    end_ = 0;
+  }
+
+private:
+  struct Interval { uint64_t start, end; };  // [start, end)
+  static constexpr size_t MIN_INTERVALS = 16;
+  static_assert((MAX_INTERVALS & (MAX_INTERVALS - 1)) == 0, "MAX_INTERVALS debe ser potencia de 2");
+
+  // i-ésimo intervalo por orden de inicio
+  Interval& at(size_t i) { return ring_[(head_ + i) & (cap_ - 1)]; }
+  const Interval& at(size_t i) const { return ring_[(head_ + i) & (cap_ - 1)]; }
+
+  // Duplica la capacidad y deja los intervalos desde la posición 0
+  void grow() {
+    const size_t cap = cap_ ? cap_ * 2 : MIN_INTERVALS;
+    auto ring = std::make_unique<Interval[]>(cap);
+    for (size_t i = 0; i < n_; ++i) ring[i] = at(i);
+    ring_ = std::move(ring);
+    cap_ = cap;
+    head_ = 0;
+  }
+
+  // Primer intervalo que empieza después de `t`
+  size_t upperBound(uint64_t t) const {
+    size_t lo = 0, hi = n_;
+    while (lo < hi) {
+      const size_t mid = (lo + hi) / 2;
+      if (at(mid).start <= t) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+  }
+
+  // Primer hueco de `cycles` ciclos desde `ready` (con mx_ tomado)
+  uint64_t firstGap(uint64_t ready, uint32_t cycles) const {
+    uint64_t start = ready;
+    size_t i = upperBound(start);
+    if (i > 0 && at(i - 1).end > start) start = at(i - 1).end;
+    for (; i < n_ && at(i).start < start + cycles; ++i) start = at(i).end;
+    return start;
+  }
+
+  mutable std::mutex mx_;
+  std::unique_ptr<Interval[]> ring_;
+  size_t cap_ = 0;   // potencia de 2, hasta MAX_INTERVALS
+  size_t head_ = 0;  // posición del intervalo más viejo
+  size_t n_ = 0;
+  uint64_t busy_ = 0;
+  uint64_t end_ = 0;
+};